@@ -0,0 +1,32 @@
+# Turns a SPIR-V binary into a header declaring its words as a constexpr array, see add_shader()
+# Usage: cmake -DINPUT=<shader.spv> -DOUTPUT=<shader.spv.hpp> -DSYMBOL=<identifier> -P embed_spirv.cmake
+
+file(READ ${INPUT} content HEX)
+
+string(LENGTH "${content}" length)
+math(EXPR remainder "${length} % 8")
+if (length EQUAL 0 OR NOT remainder EQUAL 0)
+    message(FATAL_ERROR "${INPUT} is not made of 32 bit words")
+endif ()
+
+# SPIR-V words are stored little endian
+string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1, " words "${content}")
+# Eight words per line, CMake regular expressions have no bounded repetition
+string(REPEAT "0x........, " 7 line)
+string(REGEX REPLACE "(${line}0x........,) " "\\1\n    " words "${words}")
+string(STRIP "${words}" words)
+
+get_filename_component(input-name ${INPUT} NAME)
+
+file(WRITE ${OUTPUT} "// Generated from ${input-name} by embed_spirv.cmake, do not edit
+
+#pragma once
+
+#include <cstdint>
+
+namespace vulk::embedded {
+inline constexpr uint32_t ${SYMBOL}[] = {
+    ${words}
+};
+}  // namespace vulk::embedded
+")
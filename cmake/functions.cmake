@@ -17,4 +17,42 @@ function(add_shader TARGET SHADER)
     # Make sure our native build depends on this output.
     set_source_files_properties(${current-output-path} PROPERTIES GENERATED TRUE)
     target_sources(${TARGET} PRIVATE ${current-output-path})
+
+    # The SPIR-V is also turned into a header, listed by embed_shaders()
+    if (${PROJECT_PREFIX}_EMBED_SHADERS)
+        string(MAKE_C_IDENTIFIER ${SHADER} symbol)
+        set(current-header-path ${current-output-path}.hpp)
+
+        add_custom_command(
+                OUTPUT ${current-header-path}
+                COMMAND ${CMAKE_COMMAND} -DINPUT=${current-output-path} -DOUTPUT=${current-header-path}
+                        -DSYMBOL=${symbol} -P ${PROJECT_SOURCE_DIR}/cmake/embed_spirv.cmake
+                DEPENDS ${current-output-path} ${PROJECT_SOURCE_DIR}/cmake/embed_spirv.cmake
+                VERBATIM)
+
+        set_source_files_properties(${current-header-path} PROPERTIES GENERATED TRUE)
+        target_sources(${TARGET} PRIVATE ${current-header-path})
+        set_property(TARGET ${TARGET} APPEND PROPERTY EMBEDDED_SHADERS ${SHADER})
+    endif ()
 endfunction(add_shader)
+
+function(embed_shaders TARGET)
+    # Compiles the shaders added with add_shader() into the target, looked up by the path they would be loaded from
+    get_target_property(shaders ${TARGET} EMBEDDED_SHADERS)
+    list(LENGTH shaders EMBEDDED_SHADER_COUNT)
+
+    set(EMBEDDED_SHADER_INCLUDES "")
+    set(EMBEDDED_SHADER_ENTRIES "")
+
+    foreach (shader ${shaders})
+        string(MAKE_C_IDENTIFIER ${shader} symbol)
+        string(APPEND EMBEDDED_SHADER_INCLUDES "#include \"${shader}.spv.hpp\"\n")
+        string(APPEND EMBEDDED_SHADER_ENTRIES
+               "  EmbeddedShader{\"shaders/${TARGET}/${shader}.spv\", vulk::embedded::${symbol}},\n")
+    endforeach ()
+
+    # Next to the headers, only rewritten when the list changes
+    set(output-path ${CMAKE_BINARY_DIR}/shaders/${TARGET}/EmbeddedShaders.cpp)
+    configure_file(${PROJECT_SOURCE_DIR}/cmake/EmbeddedShaders.cpp.in ${output-path} @ONLY)
+    target_sources(${TARGET} PRIVATE ${output-path})
+endfunction(embed_shaders)
@@ -1,11 +1,61 @@
 option(${PROJECT_PREFIX}_WARNINGS_AS_ERRORS "Treat compiler warnings as errors" OFF)
 option(${PROJECT_PREFIX}_WITH_SCOPED_PROFILER "Enable scoped profiler" OFF)
+option(${PROJECT_PREFIX}_TRACK_ALLOCATIONS "Count heap allocations by replacing the global operator new and delete" OFF)
+option(${PROJECT_PREFIX}_ACCOUNT_VULKAN_CALLS "Count and time the device and queue calls per entry point" OFF)
 option(${PROJECT_PREFIX}_ENABLE_IPO "Enable InterProcedural Optimizations [Release mode only]" ON)
 option(${PROJECT_PREFIX}_ENABLE_PCH "Enable Pre Compiled Headers" ON)
 option(${PROJECT_PREFIX}_ENABLE_TESTING "Enable Testing" OFF)
+option(${PROJECT_PREFIX}_ENABLE_SHADER_HOT_RELOAD "Recompile and reload shaders on change [Linux only]" OFF)
+option(${PROJECT_PREFIX}_ENABLE_TELEMETRY_SERVER "Stream telemetry over a Unix domain socket [Unix only]" OFF)
+option(${PROJECT_PREFIX}_EMBED_SHADERS "Compile the SPIR-V into the library instead of loading it at runtime" OFF)
 
 if (${PROJECT_PREFIX}_WITH_SCOPED_PROFILER)
     add_compile_definitions(${PROJECT_PREFIX}_WITH_SCOPED_PROFILER=1)
 else ()
     add_compile_definitions(${PROJECT_PREFIX}_WITH_SCOPED_PROFILER=0)
 endif ()
+
+if (${PROJECT_PREFIX}_TRACK_ALLOCATIONS)
+    add_compile_definitions(${PROJECT_PREFIX}_TRACK_ALLOCATIONS=1)
+else ()
+    add_compile_definitions(${PROJECT_PREFIX}_TRACK_ALLOCATIONS=0)
+endif ()
+
+if (${PROJECT_PREFIX}_ACCOUNT_VULKAN_CALLS)
+    add_compile_definitions(${PROJECT_PREFIX}_ACCOUNT_VULKAN_CALLS=1)
+else ()
+    add_compile_definitions(${PROJECT_PREFIX}_ACCOUNT_VULKAN_CALLS=0)
+endif ()
+
+if (${PROJECT_PREFIX}_ENABLE_SHADER_HOT_RELOAD AND NOT CMAKE_SYSTEM_NAME STREQUAL "Linux")
+    message(WARNING "Shader hot reload relies on inotify and is only available on Linux, disabling it.")
+    set(${PROJECT_PREFIX}_ENABLE_SHADER_HOT_RELOAD OFF)
+endif ()
+
+if (${PROJECT_PREFIX}_ENABLE_SHADER_HOT_RELOAD AND ${PROJECT_PREFIX}_EMBED_SHADERS)
+    message(WARNING "Embedded shaders can't be reloaded, disabling shader hot reload.")
+    set(${PROJECT_PREFIX}_ENABLE_SHADER_HOT_RELOAD OFF)
+endif ()
+
+if (${PROJECT_PREFIX}_ENABLE_SHADER_HOT_RELOAD)
+    add_compile_definitions(${PROJECT_PREFIX}_ENABLE_SHADER_HOT_RELOAD=1)
+else ()
+    add_compile_definitions(${PROJECT_PREFIX}_ENABLE_SHADER_HOT_RELOAD=0)
+endif ()
+
+if (${PROJECT_PREFIX}_EMBED_SHADERS)
+    add_compile_definitions(${PROJECT_PREFIX}_EMBED_SHADERS=1)
+else ()
+    add_compile_definitions(${PROJECT_PREFIX}_EMBED_SHADERS=0)
+endif ()
+
+if (${PROJECT_PREFIX}_ENABLE_TELEMETRY_SERVER AND NOT UNIX)
+    message(WARNING "The telemetry server relies on Unix domain sockets, disabling it.")
+    set(${PROJECT_PREFIX}_ENABLE_TELEMETRY_SERVER OFF)
+endif ()
+
+if (${PROJECT_PREFIX}_ENABLE_TELEMETRY_SERVER)
+    add_compile_definitions(${PROJECT_PREFIX}_ENABLE_TELEMETRY_SERVER=1)
+else ()
+    add_compile_definitions(${PROJECT_PREFIX}_ENABLE_TELEMETRY_SERVER=0)
+endif ()
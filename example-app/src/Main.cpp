@@ -17,15 +17,23 @@
  * 3. This notice may not be removed or altered from any source distribution.
  */
 
+#include <Vulk/AllocationTracker.hpp>
 #include <Vulk/Contexts/ContextVulkan.hpp>
+#include <Vulk/ParticleSystem.hpp>
+#include <Vulk/ScopedProfiler.hpp>
 #include <Vulk/Window.hpp>
 
+#include <cstdlib>
 #include <iostream>
 
-int main()
+int main(int argc, char** argv)
 {
     vulk::Window win{800, 600, "Vulkan window"};
 
+    // Optional .glb or .obj mesh to display
+    if (argc > 1)
+        vulk::ContextVulkan::getInstance().loadMesh(argv[1]);
+
     win.getFrameManager().setOnSecondCallback([&win](const vulk::FrameManager& frameManager) {
         constexpr const char* TitleFormat = "Vulkan window (%u fps)";
         constexpr size_t BufferSize = 32;
@@ -37,6 +45,32 @@ int main()
         win.setTitle(buffer);
     });
 
+    vulk::ParticleEmitter emitter{};
+    emitter.rate = 20000.f;
+    emitter.color = glm::vec4{1.f, 0.6f, 0.2f, 1.f};
+
+    vulk::ContextVulkan::getInstance().enableParticleSystem(vulk::ParticleSystem::DEFAULT_CAPACITY).setEmitter(emitter);
+
+    // e.g. VULK_STEADY_STATE_CHECK=120: aborts on the first allocation of a frame after 120 frames of warm-up
+    if (const char* warmUpFrames = std::getenv("VULK_STEADY_STATE_CHECK"))
+    {
+        if constexpr (!vulk::AllocationTracker::s_enabled)
+            std::cerr << "VULK_STEADY_STATE_CHECK needs a build with VULK_TRACK_ALLOCATIONS\n";
+
+        const auto frames = static_cast<uint32_t>(std::strtoul(warmUpFrames, nullptr, 10));
+        vulk::AllocationTracker::getInstance().enableSteadyStateCheck(frames);
+    }
+
+    // e.g. VULK_TRACE=vulk-trace.json: writes the profiled zones as a Chrome trace, stopped at exit
+    if (const char* traceFile = std::getenv("VULK_TRACE"))
+    {
+#if VULK_WITH_SCOPED_PROFILER
+        vulk::utils::Profiler::getInstance().startTrace(traceFile);
+#else
+        std::cerr << "VULK_TRACE needs a build with VULK_WITH_SCOPED_PROFILER\n";
+#endif
+    }
+
     while (win.isOpen())
     {
         win.pollEvents();
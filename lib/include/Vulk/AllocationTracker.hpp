@@ -0,0 +1,191 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include "Vulk/ClassUtils.hpp"
+
+#ifndef VULK_TRACK_ALLOCATIONS
+    #define VULK_TRACK_ALLOCATIONS 0
+#endif
+
+namespace vulk {
+/**
+ * Counts the heap allocations of every thread, per frame, when VULK_TRACK_ALLOCATIONS replaces the global operator
+ * new and delete. Without it, the tracker is still there but never sees an allocation.
+ *
+ * Counting is a few relaxed atomic additions to a slot owned by the allocating thread. The tracker itself never
+ * allocates from the hooks, its state is constant initialized so that allocations made before main() are counted.
+ *
+ * Allocations of at least getOutlierSize() bytes are outliers: their call stack is captured, when the platform can
+ * (glibc), for writeOutliers() to print them. So are the allocations breaking the steady state check, see
+ * enableSteadyStateCheck().
+ */
+class AllocationTracker final
+{
+public:
+    static constexpr bool s_enabled{VULK_TRACK_ALLOCATIONS != 0};
+    static constexpr size_t s_maxThreads{64};  // Threads past it share the last slot
+    static constexpr size_t s_maxOutliers{64};  // The first ones since clearOutliers() are kept
+    static constexpr size_t s_maxCallStackDepth{16};
+    static constexpr size_t s_defaultOutlierSize{1u << 16};
+
+    struct Counts
+    {
+        uint64_t allocations{0};
+        uint64_t deallocations{0};
+        uint64_t bytes{0};  // Allocated, the size of what is freed isn't always known
+    };
+
+    struct ThreadCounts
+    {
+        uint32_t threadId{0};
+        Counts counts{};
+    };
+
+    struct Outlier
+    {
+        uint64_t frame{0};
+        uint32_t threadId{0};
+        size_t size{0};
+        bool steadyStateViolation{false};
+        uint32_t callStackDepth{0};
+        std::array<void*, s_maxCallStackDepth> callStack{};
+    };
+
+    /**
+     * Allocations within the scope, on its thread, break the steady state check once it is enabled and warmed up.
+     * Window::display() is one, nesting is allowed.
+     */
+    class SteadyStateScope final
+    {
+    public:
+        SteadyStateScope() noexcept { ++s_steadyStateDepth; }
+        ~SteadyStateScope() { --s_steadyStateDepth; }
+
+        VULK_NO_MOVE_OR_COPY(SteadyStateScope)
+    };
+
+    static AllocationTracker& getInstance() noexcept;
+
+    /**
+     * Called by the operator new and delete replacements, lock free unless the allocation is an outlier.
+     */
+    void onAllocate(size_t size) noexcept;
+    void onDeallocate() noexcept;
+
+    /**
+     * Of the calling thread, as reported in the counts and outliers.
+     */
+    [[nodiscard]] uint32_t getCurrentThreadId() noexcept;
+
+    /**
+     * Ends the current frame: the counts of every thread since the previous call become the last frame's.
+     */
+    void markFrame();
+
+    [[nodiscard]] uint64_t getFrameCount() const noexcept { return m_frame.load(std::memory_order_relaxed); }
+    [[nodiscard]] Counts getLastFrameCounts() const;
+
+    /**
+     * Only the threads that allocated or freed during the last frame.
+     */
+    [[nodiscard]] std::vector<ThreadCounts> getLastFrameThreadCounts() const;
+
+    /**
+     * Up to the last markFrame().
+     */
+    [[nodiscard]] Counts getTotalCounts() const;
+
+    void setOutlierSize(size_t bytes) noexcept { m_outlierSize.store(bytes, std::memory_order_relaxed); }
+    [[nodiscard]] size_t getOutlierSize() const noexcept { return m_outlierSize.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::vector<Outlier> getOutliers() const;
+    [[nodiscard]] uint64_t getDroppedOutlierCount() const noexcept { return m_droppedOutliers.load(); }
+    void clearOutliers();
+
+    /**
+     * Symbolized when the platform can.
+     */
+    void writeOutliers(std::ostream& os) const;
+
+    /**
+     * Test mode: `warmUpFrames` frames from now on, any allocation within a SteadyStateScope is reported as an
+     * outlier and counted as a violation. With `abortOnViolation`, the first one prints its call stack and aborts,
+     * to fail a test or CI run right where it happens.
+     *
+     * The example app enables it from the VULK_STEADY_STATE_CHECK environment variable, set to the warm-up frames.
+     * Known to allocate every frame, so not to be used along with it: a telemetry client subscribed to the zones.
+     */
+    void enableSteadyStateCheck(uint32_t warmUpFrames, bool abortOnViolation = true) noexcept;
+    void disableSteadyStateCheck() noexcept;
+    [[nodiscard]] uint64_t getSteadyStateViolationCount() const noexcept { return m_violations.load(); }
+
+    VULK_NO_MOVE_OR_COPY(AllocationTracker)
+
+private:
+    static constexpr uint64_t s_checkDisabled{UINT64_MAX};
+
+    /**
+     * Written by its thread only, on its own cache line.
+     */
+    struct ThreadSlot
+    {
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> deallocations{0};
+        std::atomic<uint64_t> bytes{0};
+        std::array<char, 64 - 3 * sizeof(uint64_t)> padding{};
+    };
+
+    constexpr AllocationTracker() noexcept = default;
+
+    ThreadSlot& getThreadSlot() noexcept;
+    void recordOutlier(size_t size, bool steadyStateViolation) noexcept;
+
+    static AllocationTracker s_instance;
+    static thread_local uint32_t s_threadId;  // Index of the thread's slot plus one, zero until its first allocation
+    static thread_local uint32_t s_steadyStateDepth;
+
+    std::array<ThreadSlot, s_maxThreads> m_threadSlots{};
+    std::atomic<uint32_t> m_threadCount{0};
+    std::atomic<uint64_t> m_frame{0};
+
+    // Folded by markFrame()
+    mutable std::mutex m_countsMutex{};
+    std::array<Counts, s_maxThreads> m_lastFrameCounts{};
+    Counts m_totalCounts{};
+
+    std::atomic<size_t> m_outlierSize{s_defaultOutlierSize};
+    mutable std::mutex m_outliersMutex{};
+    std::array<Outlier, s_maxOutliers> m_outliers{};
+    size_t m_outlierCount{0};
+    std::atomic<uint64_t> m_droppedOutliers{0};
+
+    std::atomic<uint64_t> m_steadyStateFrame{s_checkDisabled};  // First frame checked
+    std::atomic<bool> m_abortOnViolation{false};
+    std::atomic<uint64_t> m_violations{0};
+};
+}  // namespace vulk
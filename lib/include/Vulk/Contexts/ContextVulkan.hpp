@@ -19,20 +19,39 @@
 
 #pragma once
 
-#include <vulkan/vulkan.hpp>
-
 #include <array>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
+#include <string>
 
 #include "Vulk/ClassUtils.hpp"
+#include "Vulk/DrawQueue.hpp"
+#include "Vulk/FrameRecorder.hpp"
+#include "Vulk/MeshOptimizer.hpp"
 #include "Vulk/Objects.hpp"
+#include "Vulk/PipelineDesc.hpp"
+#include "Vulk/PipelineLayoutCache.hpp"
+#include "Vulk/PipelineRegistry.hpp"
+#include "Vulk/PresentTimer.hpp"
+#include "Vulk/ShaderLibrary.hpp"
+#include "Vulk/StartupReport.hpp"
+#include "Vulk/ThreadPool.hpp"
+#include "Vulk/TransformHierarchy.hpp"
+#include "Vulk/Vulkan.hpp"
 #include "Vulk/Window.hpp"
 
 namespace vulk {
+class ParticleSystem;
+class ShaderWatcher;
+
 class ContextVulkan
 {
 public:
+    using MeshHandle = uint32_t;
+
     ~ContextVulkan();
 
     /**
@@ -44,12 +63,67 @@ public:
     // TODO: should not be public, remove once events are implemented
     void setFrameBufferResized(bool value) noexcept { m_frameBufferResized = value; }
 
+    /**
+     * Creates the GPU particle system on first call, the capacity is ignored afterwards.
+     */
+    ParticleSystem& enableParticleSystem(uint32_t capacity);
+    [[nodiscard]] ParticleSystem* getParticleSystem() noexcept { return m_particleSystem.get(); }
+
+    /**
+     * Loads a binary glTF (.glb) or OBJ mesh. The file is memory-mapped and parsed straight into a staging buffer,
+     * then uploaded to device local memory. The mesh is drawn every frame from now on.
+     *
+     * Unless disabled, triangles are reordered for the vertex cache and vertices for fetch locality,
+     * indices are narrowed to 16 bits when the remaining vertices allow it.
+     */
+    MeshHandle loadMesh(const char* filePath, const mesh::OptimizationOptions& optimization = {});
+
+    /**
+     * Meshes are drawn with the world transform of their node, by default a child of the scene root.
+     * Changed transforms are uploaded to the GPU transform buffer at the start of each frame.
+     */
+    [[nodiscard]] TransformHierarchy& getTransformHierarchy() noexcept { return m_transforms; }
+    [[nodiscard]] TransformHierarchy::NodeHandle getSceneRoot() const noexcept { return m_sceneRoot; }
+    [[nodiscard]] TransformHierarchy::NodeHandle getMeshNode(MeshHandle mesh) const { return m_meshes[mesh].node; }
+
+    /**
+     * Draws a mesh with other shaders or render state. They have to use the same descriptor set as the default mesh
+     * shaders, the layout, render pass, extent and vertex stride are filled in here.
+     *
+     * The pipeline is compiled on a worker thread, the mesh is drawn with the default pipeline until it is ready.
+     */
+    void setMeshPipeline(MeshHandle mesh, PipelineDesc desc);
+
+    /**
+     * How long each initialization phase took, and on which thread.
+     */
+    [[nodiscard]] const StartupReport& getStartupReport() const noexcept { return m_startupReport; }
+
+    /**
+     * Of the last call to draw(). The GPU time is the one of the frame that finished just before, it stays zero
+     * without timestamp support.
+     */
+    [[nodiscard]] const FrameWorkload& getLastFrameWorkload() const noexcept { return m_frameWorkload; }
+
+    /**
+     * Given to the frame presented by the last call to draw(), zero when it presented nothing.
+     */
+    [[nodiscard]] uint64_t getLastPresentId() const noexcept { return m_lastPresentId; }
+
+    /**
+     * The frames seen reaching the screen during the last call to draw(), see PresentTimer for how precisely.
+     */
+    [[nodiscard]] std::span<const PresentTiming> getPresentTimings() const noexcept { return m_presentTimings; }
+    [[nodiscard]] bool hasPresentWait() const noexcept { return m_presentWait; }
+
     static void createInstance(GLFWwindow* windowHandle);
     static ContextVulkan& getInstance();
 
     VULK_NO_MOVE_OR_COPY(ContextVulkan)
 
 private:
+    friend class ParticleSystem;
+
     static void printAvailableValidationLayers();
     static std::vector<const char*> getSupportedValidationLayers();
 
@@ -100,6 +174,47 @@ private:
         [[nodiscard]] bool isValid() const noexcept { return !formats.empty() && !presentModes.empty(); }
     };
 
+    struct Mesh
+    {
+        vk::Buffer vertexBuffer{};
+        vk::DeviceMemory vertexBufferMemory{};
+        vk::Buffer indexBuffer{};
+        vk::DeviceMemory indexBufferMemory{};
+        uint32_t indexCount{};
+        vk::IndexType indexType{};
+        TransformHierarchy::NodeHandle node{TransformHierarchy::INVALID_NODE};
+        std::optional<PipelineDesc> pipelineDesc{};
+        uint32_t pipelineId{0};  // Sort key of the pipeline, 0 is the default one
+
+        void destroy(vk::Device& device)
+        {
+            device.destroy(vertexBuffer);
+            device.freeMemory(vertexBufferMemory);
+            device.destroy(indexBuffer);
+            device.freeMemory(indexBufferMemory);
+        }
+    };
+
+    /**
+     * Persistently mapped copy of the world transforms for one frame in flight.
+     * Ranges changed since the frame last used it are copied before recording.
+     */
+    struct TransformBuffer
+    {
+        vk::Buffer buffer{};
+        vk::DeviceMemory memory{};
+        glm::mat4* transforms{nullptr};
+        uint32_t capacity{};
+        std::vector<TransformHierarchy::Range> pendingRanges{};
+
+        void destroy(vk::Device& device)
+        {
+            device.destroy(buffer);
+            device.freeMemory(memory);
+            transforms = nullptr;
+        }
+    };
+
     struct FrameSyncObjects
     {
         vk::Semaphore imageAvailable{};
@@ -119,6 +234,13 @@ private:
 
     explicit ContextVulkan(GLFWwindow* windowHandle);
 
+    template<typename Function>
+    void runStartupPhase(std::string name, Function&& function)
+    {
+        const auto phase = m_startupReport.measure(std::move(name));
+        function();
+    }
+
     void createInstance();
     void createSurface();
     void pickPhysicalDevice();
@@ -126,24 +248,70 @@ private:
     void createSwapChain();
     void createImageViews();
     void createRenderPass();
-    void createDescriptorSetLayout();
+
+    /**
+     * Reads the mesh shaders on a worker thread, ahead of the first pipeline build.
+     */
+    void loadShaders();
+
+    /**
+     * Points the pipeline descriptions at the current render pass.
+     */
+    void updatePipelineDescs();
     void createGraphicsPipeline();
+
+    /**
+     * The descriptor sets are allocated against the layout of the first mesh pipeline, later ones (rebuilt for a new
+     * render pass or reloaded shaders) must keep it.
+     */
+    void adoptPipelineLayout(const PipelineRegistry::Pipeline& pipeline);
     void createFrameBuffers();
     void createCommandPool();
-    void createVertexBuffer();
-    void createIndexBuffer();
+    void createDefaultMesh();
     void createUniformBuffers();
+    void createTransformBuffers();
+    void createTransformBuffer(TransformBuffer& transformBuffer, uint32_t capacity);
     void createDescriptorPool();
     void createDescriptorSets();
     void createCommandBuffers();
     void createSyncObject();
+    void createTimestampQueries();
+
+    /**
+     * Reads back the GPU time of the previous frame that used the current frame's resources, once its fence was
+     * waited on.
+     */
+    void readGpuTime();
 
     void recordCommandBuffer(vk::CommandBuffer& commandBuffer, uint32_t imageIndex);
 
     void recreateSwapChain();
+
+    /**
+     * Called at the start of each frame, once its fence was waited on: destroys the pipelines no frame in flight
+     * uses anymore and swaps in the ones rebuilt by shader hot reload.
+     */
+    void updatePipelines();
+
+#if VULK_ENABLE_SHADER_HOT_RELOAD
+    void enableShaderHotReload();
+#endif
+    /**
+     * `preferredProperties` are added to `properties` when a memory type allowed for the buffer has them all.
+     */
     void createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties,
-                      vk::Buffer& outBuffer, vk::DeviceMemory& outDeviceMemory);
+                      vk::Buffer& outBuffer, vk::DeviceMemory& outDeviceMemory,
+                      vk::MemoryPropertyFlags preferredProperties = {});
     void copyBuffer(const vk::Buffer& sourceBuffer, vk::Buffer& destinationBuffer, vk::DeviceSize size);
+    void executeOneTimeCommands(const std::function<void(vk::CommandBuffer&)>& recorder);
+
+    /**
+     * Creates device local vertex and index buffers through a single staging buffer.
+     * `writer(Vertex*, IndexType*)` fills the mapped staging memory directly, the optimizer then runs in place.
+     */
+    template<typename IndexType, typename Writer>
+    MeshHandle createMesh(uint32_t vertexCount, uint32_t indexCount, const mesh::OptimizationOptions& optimization,
+                          Writer&& writer);
 
     void cleanupSwapchain(vk::SwapchainKHR& swapchain);
     void cleanupSwapchainSubObjects();
@@ -153,10 +321,16 @@ private:
     void chooseSwapExtent();
 
     void updateUniformBuffer(uint32_t currentImage);
+    void updateTransformBuffer(uint32_t currentImage);
+    void writeTransformDescriptor(size_t frameIndex);
 
     [[nodiscard]] uint32_t findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const;
+    [[nodiscard]] std::optional<uint32_t> tryFindMemoryType(uint32_t typeFilter,
+                                                            vk::MemoryPropertyFlags properties) const noexcept;
 
     static bool verifyExtensionsSupport(const vk::PhysicalDevice& device);
+    [[nodiscard]] bool supportsExtendedDynamicState() const;
+    [[nodiscard]] bool supportsPresentWait() const;
 
     [[nodiscard]] QueueFamilyEntry findQueueFamilies(const vk::PhysicalDevice& physicalDevice) const noexcept;
     [[nodiscard]] SwapChainSupportDetails querySwapChainSupport(const vk::PhysicalDevice& device) const noexcept;
@@ -166,11 +340,18 @@ private:
     // TODO: the ContextVulkan should not contain the raw window handle, maybe a Window reference though
     GLFWwindow* m_windowHandle;
 
+    StartupReport m_startupReport{};
+
     vk::Instance m_instance{};
     vk::PhysicalDevice m_physicalDevice{};
     vk::Device m_device{};
     vk::SurfaceKHR m_surface{};
 
+    // Loads the commands of optional device extensions, the loader library doesn't export them
+    vk::DispatchLoaderDynamic m_extensionDispatcher{};
+    bool m_extendedDynamicState{false};
+    bool m_presentWait{false};
+
     vk::SurfaceFormatKHR m_surfaceFormat{};
     vk::PresentModeKHR m_presentMode{};
     vk::Extent2D m_extent{};
@@ -183,12 +364,19 @@ private:
     std::vector<vk::ImageView> m_swapchainImageViews{};
     vk::Format m_swapchainFormat{};
 
-    vk::Viewport m_viewport{};
     vk::RenderPass m_renderPass{};
 
+    std::unique_ptr<ThreadPool> m_threadPool{};
+    std::unique_ptr<PipelineLayoutCache> m_layoutCache{};
+    std::unique_ptr<ShaderLibrary> m_shaderLibrary{};
+    std::unique_ptr<PipelineRegistry> m_pipelineRegistry{};
+    PipelineDesc m_meshPipelineDesc{};
+
+    // Owned by the layout cache, the descriptor sets are allocated against them
     vk::DescriptorSetLayout m_descriptorSetLayout{};
     vk::PipelineLayout m_pipelineLayout{};
-    vk::Pipeline m_pipeline{};
+    std::vector<vk::DescriptorPoolSize> m_descriptorPoolSizes{};
+    vk::Pipeline m_pipeline{};  // Owned by the registry
 
     QueueFamilyIndices m_queueFamilyIndices{};
     QueueFamilyPropertiesList m_queueFamilyProperties{};
@@ -202,10 +390,12 @@ private:
     std::vector<FrameSyncObjects> m_frameSyncObjects{};
     std::vector<vk::Fence> m_imagesInFlight{};
 
-    vk::Buffer m_vertexBuffer{};
-    vk::DeviceMemory m_vertexBufferMemory{};
-    vk::Buffer m_indexBuffer{};
-    vk::DeviceMemory m_indexBufferMemory{};
+    std::vector<Mesh> m_meshes{};
+
+    TransformHierarchy m_transforms{};
+    TransformHierarchy::NodeHandle m_sceneRoot{TransformHierarchy::INVALID_NODE};
+    std::vector<TransformBuffer> m_transformBuffers{};
+    DrawQueue m_drawQueue{};
 
     std::vector<vk::Buffer> m_uniformBuffers{};
     std::vector<vk::DeviceMemory> m_uniformBuffersMemory{};
@@ -213,6 +403,8 @@ private:
     vk::DescriptorPool m_descriptorPool{};
     std::vector<vk::DescriptorSet> m_descriptorSets{};
 
+    std::unique_ptr<ParticleSystem> m_particleSystem{};
+
     // TODO: May be better to store in the FrameManager
     size_t m_currentFrame{};
     static const size_t s_maxFramesInFlight;
@@ -220,6 +412,42 @@ private:
 
     bool m_frameBufferResized{false};
 
+    struct RetiredPipeline
+    {
+        vk::Pipeline pipeline{};
+        uint64_t frameNumber{};
+    };
+
+    uint64_t m_frameNumber{0};
+    std::vector<RetiredPipeline> m_retiredPipelines{};
+
+    // Two timestamps per frame in flight, null when the graphics queue doesn't support them
+    vk::QueryPool m_timestampQueryPool{};
+    float m_timestampPeriod{0.0f};  // Nanoseconds per tick
+    std::vector<bool> m_timestampsWritten{};
+
+    FrameWorkload m_frameWorkload{};
+
+    std::unique_ptr<PresentTimer> m_presentTimer{};
+    uint64_t m_nextPresentId{1};
+    uint64_t m_lastPresentId{0};
+    std::span<const PresentTiming> m_presentTimings{};
+
+#if VULK_ENABLE_SHADER_HOT_RELOAD
+    struct PendingPipeline
+    {
+        PipelineRegistry::Pipeline built{};
+        uint64_t swapchainGeneration{};
+    };
+
+    // Guards the pending pipeline and the objects pipelines are built against (render pass, layout)
+    std::mutex m_pipelineMutex{};
+    PendingPipeline m_pendingPipeline{};
+    uint64_t m_swapchainGeneration{0};
+
+    std::unique_ptr<ShaderWatcher> m_shaderWatcher{};
+#endif
+
     template<typename T>
     static constexpr vk::IndexType getIndexType()
     {
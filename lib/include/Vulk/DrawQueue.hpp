@@ -0,0 +1,140 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "Vulk/Vulkan.hpp"
+
+namespace vulk {
+/**
+ * Collects the draws of a frame, sorts them by a 64 bit key and records them, skipping binds of the state that is
+ * already bound. From the most to the least significant bits, keys are made of:
+ * - the layer (e.g. opaque, transparent, UI), drawn in increasing order,
+ * - the pipeline id,
+ * - the material id, which selects the descriptor set,
+ * - the quantized depth.
+ * Ids are only used for ordering, draws carry the actual handles.
+ */
+class DrawQueue
+{
+public:
+    static constexpr uint32_t LAYER_BITS = 8;
+    static constexpr uint32_t PIPELINE_BITS = 12;
+    static constexpr uint32_t MATERIAL_BITS = 20;
+    static constexpr uint32_t DEPTH_BITS = 24;
+
+    static_assert(LAYER_BITS + PIPELINE_BITS + MATERIAL_BITS + DEPTH_BITS == 64);
+
+    struct Draw
+    {
+        vk::Pipeline pipeline{};
+        vk::PipelineLayout pipelineLayout{};
+        vk::DescriptorSet descriptorSet{};
+
+        vk::Buffer vertexBuffer{};
+        vk::Buffer indexBuffer{};
+        vk::IndexType indexType{vk::IndexType::eUint16};
+
+        // Without an index buffer, indexCount and firstIndex are the vertex count and first vertex of a non-indexed
+        // draw and vertexOffset is unused
+        uint32_t indexCount{};
+        uint32_t instanceCount{1};
+        uint32_t firstIndex{};
+        int32_t vertexOffset{};
+        uint32_t firstInstance{};
+
+        // Dynamic render state, recorded by the caller whenever it changes between draws
+        uint32_t renderState{};
+    };
+
+    struct SortEntry
+    {
+        uint64_t key{};
+        uint32_t drawIndex{};
+    };
+
+    /**
+     * Commands actually recorded by the last record(), to compare against the number of draws.
+     */
+    struct Statistics
+    {
+        uint32_t draws{};
+        uint64_t instances{};
+        uint64_t triangles{};  // Assuming triangle lists
+        uint32_t pipelineBinds{};
+        uint32_t descriptorSetBinds{};
+        uint32_t vertexBufferBinds{};
+        uint32_t indexBufferBinds{};
+        uint32_t renderStateChanges{};
+    };
+
+    using RenderStateRecorder = std::function<void(uint32_t renderState)>;
+
+    /**
+     * Each field is masked to its width.
+     */
+    [[nodiscard]] static constexpr uint64_t makeKey(uint32_t layer, uint32_t pipeline, uint32_t material,
+                                                    uint32_t depth) noexcept
+    {
+        constexpr auto mask = [](uint32_t value, uint32_t bits) { return value & ((1ull << bits) - 1); };
+
+        return mask(layer, LAYER_BITS) << (PIPELINE_BITS + MATERIAL_BITS + DEPTH_BITS) |
+               mask(pipeline, PIPELINE_BITS) << (MATERIAL_BITS + DEPTH_BITS) |
+               mask(material, MATERIAL_BITS) << DEPTH_BITS | mask(depth, DEPTH_BITS);
+    }
+
+    /**
+     * Maps a [0, 1] depth to the key's depth bits, front to back by default (opaque draws, for early depth rejection)
+     * and back to front for blended ones.
+     */
+    [[nodiscard]] static uint32_t quantizeDepth(float depth, bool backToFront = false) noexcept;
+
+    void clear() noexcept;
+    void submit(uint64_t key, const Draw& draw);
+
+    /**
+     * Stable LSD radix sort of the submitted keys, 8 bits per pass. Passes where every key has the same digit are
+     * skipped, which is most of them since layers and pipelines rarely vary much.
+     */
+    void sort();
+
+    /**
+     * Sorts if needed and records the draws in key order. `recordRenderState` is called before the first draw and
+     * before every draw whose render state differs from the previous one. Also adds the statistics to the render
+     * counters.
+     */
+    void record(const vk::CommandBuffer& commandBuffer, const RenderStateRecorder& recordRenderState = {});
+
+    [[nodiscard]] std::span<const SortEntry> getSortedEntries() const noexcept { return m_entries; }
+    [[nodiscard]] const Statistics& getStatistics() const noexcept { return m_statistics; }
+
+private:
+    std::vector<Draw> m_draws{};
+    std::vector<SortEntry> m_entries{};
+    std::vector<SortEntry> m_scratch{};
+    bool m_sorted{true};
+
+    Statistics m_statistics{};
+};
+}  // namespace vulk
@@ -0,0 +1,34 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace vulk::embedded {
+/**
+ * SPIR-V compiled into the library with VULK_EMBED_SHADERS, by the path it would be loaded from otherwise, e.g.
+ * "shaders/vulk/shader.vert.spv". Empty when not found.
+ *
+ * Only defined when shaders are embedded, the table is generated by embed_shaders().
+ */
+[[nodiscard]] std::span<const uint32_t> findShader(std::string_view filePath) noexcept;
+}  // namespace vulk::embedded
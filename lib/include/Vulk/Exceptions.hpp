@@ -19,11 +19,10 @@
 
 #pragma once
 
-#include <vulkan/vulkan.hpp>
-
 #include <stdexcept>
 
 #include "Vulk/ClassUtils.hpp"
+#include "Vulk/Vulkan.hpp"
 
 namespace vulk {
 class Exception : public std::exception
@@ -67,8 +66,11 @@ protected:
 VULK_DEFINE_EXCEPTION(IOException, Exception)
 VULK_DEFINE_EXCEPTION(FileNotFoundException, IOException)
 VULK_DEFINE_EXCEPTION(PermissionDeniedException, IOException)
+VULK_DEFINE_EXCEPTION(InvalidFormatException, IOException)
 
 VULK_DEFINE_EXCEPTION(LibraryException, Exception)
+VULK_DEFINE_EXCEPTION(ShaderCompilationException, Exception)
+VULK_DEFINE_EXCEPTION(ShaderReflectionException, Exception)
 
 class GLFWException : public LibraryException
 {
@@ -0,0 +1,116 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace vulk::utils {
+/**
+ * Call tree of the profiler zones of one thread, averaged over a rolling window of frames.
+ *
+ * Zones are identified by name, nested by time: a zone is the child of the innermost zone of the same frame that
+ * encloses it. The same zone reached through different parents is a different node.
+ */
+class FrameCallTree
+{
+public:
+    using Ticks = std::chrono::steady_clock::rep;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    struct Zone
+    {
+        const char* name{nullptr};
+        Ticks begin{0};
+        Ticks end{0};
+    };
+
+    struct Node
+    {
+        static constexpr size_t s_noParent{std::numeric_limits<size_t>::max()};
+
+        const char* name{nullptr};
+        size_t parent{s_noParent};  // Index in the same query result
+        uint32_t depth{0};
+
+        // Averages per frame of the window
+        double calls{0.0};
+        Milliseconds total{};
+        Milliseconds self{};  // Minus the time spent in children
+    };
+
+    explicit FrameCallTree(size_t windowSize = 120);
+
+    /**
+     * Zones of one frame in any order, e.g. the order they ended in. The oldest frame leaves the window when it is
+     * full.
+     */
+    void addFrame(std::span<const Zone> zones);
+
+    /**
+     * Depth first, siblings by decreasing total time. Zones that weren't reached in the window are left out.
+     */
+    [[nodiscard]] std::vector<Node> getNodes() const;
+
+    [[nodiscard]] size_t getFrameCount() const noexcept { return m_frames.size(); }
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_windowSize; }
+
+    /**
+     * Drops the oldest frames if the window shrinks.
+     */
+    void setWindowSize(size_t windowSize);
+
+    void clear();
+
+private:
+    struct TreeNode
+    {
+        const char* name{nullptr};
+        size_t parent{0};
+        std::vector<size_t> children{};
+
+        // Sums over the window
+        uint64_t calls{0};
+        Ticks total{0};
+        Ticks self{0};
+    };
+
+    struct Contribution
+    {
+        size_t node{0};
+        Ticks total{0};
+        Ticks self{0};
+    };
+
+    static constexpr size_t s_root{0};
+
+    size_t findOrAddChild(size_t parent, const char* name);
+    void removeOldestFrame();
+
+    size_t m_windowSize;
+
+    std::vector<TreeNode> m_nodes;  // Never shrinks, until cleared, the frames refer to the nodes by index
+    std::deque<std::vector<Contribution>> m_frames{};  // One per call
+};
+}  // namespace vulk::utils
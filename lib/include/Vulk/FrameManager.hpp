@@ -22,10 +22,20 @@
 #include <array>
 #include <chrono>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <string>
 
+#include "FrameRecorder.hpp"
+#include "FrameStatistics.hpp"
+#include "InputLatency.hpp"
+#include "RenderCounters.hpp"
 #include "Time.hpp"
+#include "VulkanCalls.hpp"
+
+#if VULK_ENABLE_TELEMETRY_SERVER
+    #include "TelemetryServer.hpp"
+#endif
 
 namespace vulk {
 class FrameManager final
@@ -36,7 +46,7 @@ public:
 
     FrameManager();
 
-    void update() noexcept;
+    void update();
 
     void setOnSecondCallback(const OnSecondCallback& func) noexcept { m_onSecondCallback = func; }
 
@@ -45,6 +55,50 @@ public:
     [[nodiscard]] FramerateStringBuffer getFramerateCString() const noexcept;
     [[nodiscard]] std::string getFramerateString() const noexcept;
 
+    /**
+     * Frame time distribution over the last frames, see FrameStatistics::setBudget() for the target frame time.
+     */
+    [[nodiscard]] const FrameStatistics& getStatistics() const noexcept { return m_statistics; }
+    [[nodiscard]] FrameStatistics& getStatistics() noexcept { return m_statistics; }
+
+    /**
+     * Appends a record per frame to the file from now on, see FrameRecorder. Replaces the current recording, if any.
+     */
+    void startRecording(const std::string& filePath);
+    void stopRecording() noexcept { m_recorder.reset(); }
+    [[nodiscard]] bool isRecording() const noexcept { return m_recorder != nullptr; }
+
+    /**
+     * What the frame about to end did, recorded along with its duration.
+     */
+    void setWorkload(const FrameWorkload& workload) noexcept { m_workload = workload; }
+    [[nodiscard]] const FrameWorkload& getWorkload() const noexcept { return m_workload; }
+
+    /**
+     * What the renderer did during the last frame, counted by every thread since the previous update().
+     */
+    [[nodiscard]] const RenderCounters& getRenderCounters() const noexcept { return m_renderCounters; }
+
+    /**
+     * From the input events to the presentation of the frames that consumed them, fed by the window.
+     */
+    [[nodiscard]] const InputLatency& getInputLatency() const noexcept { return m_inputLatency; }
+    [[nodiscard]] InputLatency& getInputLatency() noexcept { return m_inputLatency; }
+
+    /**
+     * The device and queue calls of the last frame, on every thread. Empty without VULK_ACCOUNT_VULKAN_CALLS.
+     */
+    [[nodiscard]] const VulkanCallStats& getVulkanCalls() const noexcept { return m_vulkanCalls; }
+
+#if VULK_ENABLE_TELEMETRY_SERVER
+    /**
+     * Publishes every frame to the clients of a TelemetryServer listening at `socketPath`, replacing the current one.
+     */
+    void startTelemetryServer(const std::string& socketPath);
+    void stopTelemetryServer() noexcept { m_telemetryServer.reset(); }
+    [[nodiscard]] TelemetryServer* getTelemetryServer() noexcept { return m_telemetryServer.get(); }
+#endif
+
 private:
     Duration m_duration{};
     TimePoint m_lastFrame{};
@@ -54,6 +108,17 @@ private:
     uint32_t m_framerate{};
     uint32_t m_frameCounter{};
 
+    FrameStatistics m_statistics{};
+
+    FrameWorkload m_workload{};
+    RenderCounters m_renderCounters{};
+    InputLatency m_inputLatency{};
+    VulkanCallStats m_vulkanCalls{};
+    std::unique_ptr<FrameRecorder> m_recorder{};
+#if VULK_ENABLE_TELEMETRY_SERVER
+    std::unique_ptr<TelemetryServer> m_telemetryServer{};
+#endif
+
     std::optional<OnSecondCallback> m_onSecondCallback{std::nullopt};
 };
 }  // namespace vulk
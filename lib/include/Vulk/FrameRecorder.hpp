@@ -0,0 +1,126 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Vulk/ClassUtils.hpp"
+#include "Vulk/RenderCounters.hpp"
+#include "Vulk/SpscRingBuffer.hpp"
+#include "Vulk/Time.hpp"
+
+namespace vulk {
+/**
+ * Where the time of a frame went, besides its total duration. What the renderer did is in RenderCounters.
+ */
+struct FrameWorkload
+{
+    Duration cpuTime{};  // Recording and submitting the frame, without waiting for the GPU
+    Duration gpuTime{};  // Of the last frame the GPU finished, zero when unknown
+};
+
+/**
+ * Appends one record per frame to a binary file, for long runs to leave a performance trace behind.
+ *
+ * The frame thread only pushes the record to a ring buffer, a background thread writes them to the file; records
+ * are dropped, and counted, if it ever falls behind by more than s_bufferedRecords frames.
+ */
+class FrameRecorder
+{
+public:
+    /**
+     * Written as is after the file header, in the machine's byte order.
+     */
+    struct Record
+    {
+        uint64_t frame{0};
+        uint64_t timestamp{0};  // Nanoseconds since the recording started, at the end of the frame
+        uint64_t uploadedBytes{0};
+        float deltaTime{0.0f};  // Seconds, as every duration
+        float cpuTime{0.0f};
+        float gpuTime{0.0f};
+        uint32_t drawCount{0};
+    };
+
+    static_assert(sizeof(Record) == 40, "The record layout is part of the file format");
+
+    static constexpr size_t s_bufferedRecords{1u << 12};
+    static constexpr uint32_t s_formatVersion{1};
+
+    /**
+     * Throws IOException if the file can't be created.
+     */
+    explicit FrameRecorder(const std::string& filePath);
+
+    /**
+     * Writes the records still buffered.
+     */
+    ~FrameRecorder();
+
+    VULK_NO_MOVE_OR_COPY(FrameRecorder)
+
+    /**
+     * From a single thread, never blocks. Only the draw calls and uploaded bytes of the counters are recorded.
+     */
+    void append(TimePoint frameEnd, Duration deltaTime, const FrameWorkload& workload,
+                const RenderCounters& counters) noexcept;
+
+    [[nodiscard]] uint64_t getRecordCount() const noexcept { return m_nextFrame; }
+    [[nodiscard]] uint64_t getDroppedRecordCount() const noexcept { return m_droppedRecords.load(); }
+
+    /**
+     * Throws FileNotFoundException or InvalidFormatException. A truncated last record, e.g. if the program
+     * crashed while writing it, is ignored.
+     */
+    [[nodiscard]] static std::vector<Record> read(const std::string& filePath);
+
+    static void writeCsv(std::span<const Record> records, std::ostream& os);
+    static void convertToCsv(const std::string& recordPath, const std::string& csvPath);
+
+private:
+    void runWriter();
+
+    /**
+     * Writer thread only, or once it stopped.
+     */
+    void writeBuffered();
+
+    std::ofstream m_output;
+    const TimePoint m_start;
+    uint64_t m_nextFrame{0};  // Frame thread only
+
+    SpscRingBuffer<Record, s_bufferedRecords> m_records{};
+    std::atomic<uint64_t> m_droppedRecords{0};
+
+    std::mutex m_writerMutex{};
+    std::condition_variable m_writerWakeUp{};
+    bool m_stopWriter{false};
+    std::thread m_writer{};
+};
+}  // namespace vulk
@@ -0,0 +1,124 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "Vulk/Time.hpp"
+
+namespace vulk {
+/**
+ * Distribution of the frame times over a rolling window of frames: percentiles, max, jitter and frames over budget.
+ * Adding a frame is constant time and never allocates.
+ *
+ * Percentiles come from a histogram with logarithmic buckets, 16 per octave: they are rounded up to the bucket's
+ * upper bound, less than 4.5% above the exact value (and never above the max).
+ */
+class FrameStatistics
+{
+public:
+    static constexpr size_t s_bucketsPerOctave{16};
+    static constexpr size_t s_bucketCount{256};  // From 1/16 ms to 4 s
+
+    struct Summary
+    {
+        size_t frameCount{0};
+        Duration mean{};
+        Duration p50{};
+        Duration p95{};
+        Duration p99{};
+        Duration max{};
+        Duration jitter{};
+        size_t overBudget{0};
+    };
+
+    explicit FrameStatistics(size_t windowSize = 1024, Duration budget = Duration{1.0f / 60.0f});
+
+    void addFrame(Duration frameTime) noexcept;
+
+    /**
+     * `percentile` between 0 and 1.
+     */
+    [[nodiscard]] Duration getPercentile(float percentile) const noexcept;
+    [[nodiscard]] Duration getMax() const noexcept;
+    [[nodiscard]] Duration getMean() const noexcept;
+
+    /**
+     * Mean absolute difference between consecutive frame times: steady frames have none, however long they are.
+     */
+    [[nodiscard]] Duration getJitter() const noexcept;
+
+    /**
+     * In the window, and since the start (or the last clear()).
+     */
+    [[nodiscard]] size_t getOverBudgetCount() const noexcept { return m_overBudget; }
+    [[nodiscard]] uint64_t getTotalOverBudgetCount() const noexcept { return m_totalOverBudget; }
+
+    [[nodiscard]] Summary getSummary() const noexcept;
+
+    /**
+     * Frames longer than the budget are over it. Recounts the window.
+     */
+    void setBudget(Duration budget) noexcept;
+    [[nodiscard]] Duration getBudget() const noexcept { return Duration{m_budget}; }
+
+    [[nodiscard]] size_t getFrameCount() const noexcept { return m_frameCount; }
+    [[nodiscard]] size_t getWindowSize() const noexcept { return m_frameTimes.size(); }
+
+    [[nodiscard]] const std::array<uint32_t, s_bucketCount>& getHistogram() const noexcept { return m_histogram; }
+
+    /**
+     * Frame times in [getBucketLowerBound(i), getBucketLowerBound(i + 1)) go in bucket i, except for the first and
+     * last buckets which also count everything below and above.
+     */
+    [[nodiscard]] static Duration getBucketLowerBound(size_t bucket) noexcept;
+    [[nodiscard]] static size_t getBucket(Duration frameTime) noexcept;
+
+    void clear() noexcept;
+
+private:
+    // In seconds, indexed by frame number modulo the window size
+    std::vector<float> m_frameTimes;
+    std::vector<float> m_differences;  // With the previous frame
+
+    size_t m_frameCount{0};
+    size_t m_nextFrame{0};
+
+    std::array<uint32_t, s_bucketCount> m_histogram{};
+
+    // Frame numbers of decreasing frame times, the first one is the max of the window
+    std::vector<size_t> m_maxQueue;
+    size_t m_maxQueueFront{0};
+    size_t m_maxQueueSize{0};
+
+    double m_sum{0.0};
+    double m_differenceSum{0.0};
+
+    float m_budget;
+    size_t m_overBudget{0};
+    uint64_t m_totalOverBudget{0};
+};
+}  // namespace vulk
+
+std::ostream& operator<<(std::ostream& os, const vulk::FrameStatistics::Summary& summary);
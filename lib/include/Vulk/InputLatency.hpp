@@ -0,0 +1,96 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "Vulk/FrameStatistics.hpp"
+#include "Vulk/Time.hpp"
+
+namespace vulk {
+/**
+ * When a frame reached the screen, or the closest the renderer could measure. Present ids are given by the context
+ * to the frames it submits, in increasing order.
+ */
+struct PresentTiming
+{
+    uint64_t presentId{0};
+    TimePoint presentTime{};
+};
+
+/**
+ * Time from input events to the presentation of the frame that consumed them, for the frames that had any input.
+ *
+ * Input is consumed by the next frame submitted after it arrived, the latency is measured from its earliest event:
+ * that's how long the user waited for the first thing they did to show up. Single threaded, like the input
+ * callbacks.
+ */
+class InputLatency
+{
+public:
+    static constexpr size_t s_maxPendingFrames{16};
+
+    explicit InputLatency(size_t windowSize = 256, Duration budget = Duration{0.05f});
+
+    void onInput(TimePoint arrival) noexcept;
+
+    /**
+     * Tags the input received since the previous frame with `presentId`. An id of zero means nothing was submitted,
+     * the input then goes to the next frame.
+     */
+    void onFrameSubmitted(uint64_t presentId) noexcept;
+
+    /**
+     * Presenting a frame means the frames before it were too: those whose timing was lost are measured against it.
+     */
+    void onFramePresented(const PresentTiming& timing) noexcept;
+
+    /**
+     * Of the last frame presented that consumed input, zero until there is one.
+     */
+    [[nodiscard]] Duration getLastLatency() const noexcept { return m_lastLatency; }
+
+    /**
+     * Distribution over the last frames that consumed input, see FrameStatistics (the budget is a latency here).
+     */
+    [[nodiscard]] const FrameStatistics& getStatistics() const noexcept { return m_statistics; }
+    [[nodiscard]] FrameStatistics& getStatistics() noexcept { return m_statistics; }
+
+private:
+    struct PendingFrame
+    {
+        uint64_t presentId{0};
+        TimePoint input{};
+    };
+
+    std::optional<TimePoint> m_pendingInput{};
+
+    // Oldest first, frames submitted with input and not presented yet
+    std::array<PendingFrame, s_maxPendingFrames> m_pendingFrames{};
+    size_t m_firstPendingFrame{0};
+    size_t m_pendingFrameCount{0};
+
+    Duration m_lastLatency{};
+    FrameStatistics m_statistics;
+};
+}  // namespace vulk
@@ -23,6 +23,10 @@
 
 #include <array>
 #include <functional>
+#include <optional>
+#include <utility>
+
+#include "Vulk/Time.hpp"
 
 namespace vulk {
 
@@ -163,12 +167,18 @@ public:
 
     inline bool isKeyDown(vulk::Key key) const noexcept { return m_keyboardInputs[static_cast<size_t>(key)]; };
 
-    void onKeyPressed(int scancode, int action);
+    void onKeyPressed(int scancode, int action, TimePoint arrival);
+
+    /**
+     * Arrival of the first event since the previous call, if any.
+     */
+    [[nodiscard]] std::optional<TimePoint> takeFirstEventTime() noexcept { return std::exchange(m_firstEventTime, {}); }
 
     [[nodiscard]] inline static Keyboard* getKeyboard(GLFWwindow* window) { return s_linkedKeyboard[window]; }
 
 private:
     static std::unordered_map<GLFWwindow*, Keyboard*> s_linkedKeyboard;
     std::array<bool, GLFW_KEY_LAST + 1> m_keyboardInputs{};
+    std::optional<TimePoint> m_firstEventTime{};
 };
 }  // namespace vulk
@@ -0,0 +1,60 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+#include "Vulk/ClassUtils.hpp"
+
+namespace vulk {
+/**
+ * Read-only memory mapping of a whole file.
+ *
+ * Pages are loaded lazily by the OS as they are touched, which lets parsers read straight from the page cache
+ * instead of copying the file into an intermediate buffer first.
+ */
+class MappedFile
+{
+public:
+    explicit MappedFile(const char* filePath);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& rhs) noexcept;
+    MappedFile& operator=(MappedFile&& rhs) noexcept;
+
+    VULK_NO_COPY(MappedFile)
+
+    [[nodiscard]] const char* getData() const noexcept { return m_data; }
+    [[nodiscard]] size_t getSize() const noexcept { return m_size; }
+    [[nodiscard]] std::string_view getView() const noexcept { return {m_data, m_size}; }
+
+private:
+    void unmap() noexcept;
+
+    const char* m_data{nullptr};
+    size_t m_size{0};
+
+#ifdef _WIN32
+    void* m_fileHandle{nullptr};
+    void* m_mappingHandle{nullptr};
+#endif
+};
+}  // namespace vulk
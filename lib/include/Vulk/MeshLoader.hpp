@@ -0,0 +1,89 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+#include "Vulk/ClassUtils.hpp"
+#include "Vulk/MappedFile.hpp"
+#include "Vulk/Objects.hpp"
+
+namespace vulk {
+/**
+ * Loads meshes from memory-mapped binary glTF (.glb) and Wavefront OBJ files.
+ *
+ * Loading is done in two steps so no intermediate copy of the geometry is ever made:
+ * the constructor maps the file and counts vertices and indices, then `write()` parses or converts
+ * the data straight into caller-provided memory, typically a mapped staging buffer.
+ *
+ * Only the 2D position and the vertex color are kept, to match `Vertex`. Node transforms are ignored.
+ */
+class MeshLoader
+{
+public:
+    explicit MeshLoader(const char* filePath);
+
+    VULK_NO_MOVE_OR_COPY(MeshLoader)
+
+    [[nodiscard]] uint32_t getVertexCount() const noexcept { return m_vertexCount; }
+    [[nodiscard]] uint32_t getIndexCount() const noexcept { return m_indexCount; }
+
+    /**
+     * @return true if the vertices cannot all be addressed with 16 bit indices
+     */
+    [[nodiscard]] bool needsUint32Indices() const noexcept
+    {
+        return m_vertexCount > static_cast<uint32_t>(std::numeric_limits<uint16_t>::max()) + 1;
+    }
+
+    /**
+     * Writes the geometry in place.
+     *
+     * @param vertices Destination of at least getVertexCount() vertices
+     * @param indices Destination of at least getIndexCount() indices
+     */
+    void write(Vertex* vertices, uint16_t* indices) const;
+    void write(Vertex* vertices, uint32_t* indices) const;
+
+private:
+    enum class Format
+    {
+        eObj,
+        eGlb,
+    };
+
+    void countObj();
+    void countGlb();
+
+    template<typename IndexType>
+    void writeObj(Vertex* vertices, IndexType* indices) const;
+
+    template<typename IndexType>
+    void writeGlb(Vertex* vertices, IndexType* indices) const;
+
+    MappedFile m_file;
+    Format m_format{};
+
+    uint32_t m_vertexCount{0};
+    uint32_t m_indexCount{0};
+};
+}  // namespace vulk
@@ -0,0 +1,93 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include "Vulk/Objects.hpp"
+
+/**
+ * Index and vertex reordering passes run on loaded meshes before they are uploaded.
+ *
+ * The usual order is optimizeVertexCache(), then optimizeOverdraw() (which keeps most of the cache efficiency),
+ * then optimizeVertexFetch() (which only renames vertices, so it doesn't change the triangle order).
+ * `Vertex` is 2D, every triangle faces the camera, so loaded meshes skip optimizeOverdraw().
+ * Only `uint16_t` and `uint32_t` indices are supported, like `ContextVulkan::getIndexType()`.
+ */
+namespace vulk::mesh {
+struct VertexCacheStatistics
+{
+    uint32_t vertexTransforms{};  // cache misses, i.e. vertex shader invocations
+    float acmr{};                 // average cache miss ratio: transforms per triangle, 0.5 is the best case on grids
+    float atvr{};                 // average transformed vertex ratio: transforms per vertex, 1 is optimal
+};
+
+struct OptimizationOptions
+{
+    bool enabled{true};
+};
+
+/**
+ * Simulates a FIFO post-transform vertex cache of the given size over the triangle list.
+ */
+template<typename IndexType>
+[[nodiscard]] VertexCacheStatistics analyzeVertexCache(std::span<const IndexType> indices, uint32_t vertexCount,
+                                                       uint32_t cacheSize = 16);
+
+/**
+ * Reorders triangles to maximize post-transform cache hits (Tom Forsyth's linear-speed algorithm).
+ */
+template<typename IndexType>
+void optimizeVertexCache(std::span<IndexType> indices, uint32_t vertexCount);
+
+/**
+ * Reorders clusters of triangles of a 3D, depth tested mesh so outward facing ones come first, which reduces overdraw.
+ * The input should be cache optimized: clusters are split where the cache restarts, or where the
+ * cache miss ratio stays below `threshold` times the one of the whole cluster.
+ * Flat geometry has no facing to sort on and is left as is.
+ */
+template<typename IndexType>
+void optimizeOverdraw(std::span<IndexType> indices, std::span<const glm::vec3> positions, float threshold = 1.05f);
+
+/**
+ * Reorders vertices in the order they are first referenced so vertex fetches are mostly sequential.
+ * Unreferenced vertices are dropped and indices are remapped.
+ *
+ * @return the new vertex count
+ */
+template<typename IndexType>
+[[nodiscard]] uint32_t optimizeVertexFetch(std::span<Vertex> vertices, std::span<IndexType> indices);
+
+[[nodiscard]] constexpr bool fitsUint16Indices(uint32_t vertexCount) noexcept
+{
+    return vertexCount <= static_cast<uint32_t>(std::numeric_limits<uint16_t>::max()) + 1;
+}
+
+/**
+ * Converts 32 bit indices to 16 bit ones in place, halving the index buffer size.
+ * Every index must fit in 16 bits (see fitsUint16Indices()).
+ *
+ * @return the start of the narrowed indices, aliasing `indices`
+ */
+uint16_t* narrowIndices(uint32_t* indices, size_t count) noexcept;
+}  // namespace vulk::mesh
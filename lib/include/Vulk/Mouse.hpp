@@ -23,6 +23,10 @@
 
 #include <array>
 #include <functional>
+#include <optional>
+#include <utility>
+
+#include "Vulk/Time.hpp"
 
 namespace vulk {
 
@@ -50,12 +54,18 @@ public:
 
     inline bool isButtonDown(vulk::Buttons button) const noexcept { return m_mouseInputs[static_cast<size_t>(button)]; }
 
-    void onButtonPressed(int button, int action);
+    void onButtonPressed(int button, int action, TimePoint arrival);
+
+    /**
+     * Arrival of the first event since the previous call, if any.
+     */
+    [[nodiscard]] std::optional<TimePoint> takeFirstEventTime() noexcept { return std::exchange(m_firstEventTime, {}); }
 
     [[nodiscard]] inline static Mouse* getMouse(GLFWwindow* window) { return s_linkedMouse[window]; }
 
 private:
     static std::unordered_map<GLFWwindow*, Mouse*> s_linkedMouse;
     std::array<bool, GLFW_MOUSE_BUTTON_LAST + 1> m_mouseInputs{};
+    std::optional<TimePoint> m_firstEventTime{};
 };
 }  // namespace vulk
@@ -20,22 +20,15 @@
 #pragma once
 
 #include <glm/glm.hpp>
-#include <vulkan/vulkan.hpp>
 
 struct Vertex
 {
     glm::vec2 position{};
     glm::vec3 color{};
-
-    using AttributeDescriptions = std::array<vk::VertexInputAttributeDescription, 2>;
-
-    static vk::VertexInputBindingDescription getBindingDescription() noexcept;
-    static AttributeDescriptions getAttributeDescriptions() noexcept;
 };
 
 struct alignas(16) UniformBufferObject
 {
-    glm::mat4 model{};
     glm::mat4 view{};
     glm::mat4 projection{};
 };
@@ -0,0 +1,148 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "Vulk/ClassUtils.hpp"
+#include "Vulk/PipelineDesc.hpp"
+#include "Vulk/Time.hpp"
+#include "Vulk/Vulkan.hpp"
+
+namespace vulk {
+class ContextVulkan;
+
+/**
+ * Describes how new particles are spawned. Everything after emission happens on the GPU.
+ */
+struct ParticleEmitter
+{
+    glm::vec3 position{};
+    float spawnRadius{0.f};
+    glm::vec3 velocity{0.f, 0.f, 1.f};
+    float velocitySpread{0.5f};
+    glm::vec4 color{1.f};
+    glm::vec3 gravity{0.f, 0.f, -1.f};
+    float lifetime{2.f};  // seconds
+    float rate{0.f};      // particles per second, 0 disables emission
+    float size{0.02f};    // half extent of the quad, in view space units
+};
+
+/**
+ * GPU driven particle simulation.
+ *
+ * Particles live in storage buffers. Compute shaders pop dead slots from an atomic free list on emission, integrate
+ * live particles and push expired ones back. Survivors are appended to an alive list whose size is written straight
+ * into an indirect draw command, which renders one instanced quad per particle.
+ * The CPU only pushes emitter parameters: the particle count never costs CPU time.
+ */
+class ParticleSystem
+{
+public:
+    static constexpr uint32_t DEFAULT_CAPACITY = 1 << 20;
+
+    ParticleSystem(ContextVulkan& context, uint32_t capacity);
+    ~ParticleSystem();
+
+    VULK_NO_MOVE_OR_COPY(ParticleSystem)
+
+    void setEmitter(const ParticleEmitter& emitter) noexcept { m_emitter = emitter; }
+    [[nodiscard]] const ParticleEmitter& getEmitter() const noexcept { return m_emitter; }
+    [[nodiscard]] uint32_t getCapacity() const noexcept { return m_capacity; }
+
+    /**
+     * Records the emission and simulation dispatches. Must be recorded outside of a render pass.
+     */
+    void recordCompute(vk::CommandBuffer& commandBuffer, size_t frameIndex);
+
+    /**
+     * Records the indirect instanced draw of live particles. Must be recorded inside the render pass.
+     */
+    void recordDraw(vk::CommandBuffer& commandBuffer, size_t frameIndex);
+
+    /**
+     * Rebuilds what depends on the swapchain (render pass, extent, uniform buffers).
+     */
+    void onSwapchainRecreated();
+
+private:
+    // Mirrors the `Emitter` push constant block of the particle shaders
+    struct PushConstants
+    {
+        glm::vec4 position{};      // xyz: position, w: spawn radius
+        glm::vec4 velocity{};      // xyz: initial velocity, w: velocity spread
+        glm::vec4 color{};         //
+        glm::vec4 gravityDelta{};  // xyz: gravity, w: delta time
+        uint32_t emitCount{};
+        uint32_t seed{};
+        uint32_t capacity{};
+        float lifetime{};
+        float size{};
+    };
+
+    // local_size_x of the particle compute shaders, specialization constant 0
+    static constexpr uint32_t s_workGroupSize = 256;
+
+    void createBuffers();
+    void createPipelineLayout();
+    void createComputePipelines();
+    void createGraphicsPipeline();
+    void createDescriptorPool();
+    void createDescriptorSets();
+    void writeUniformDescriptors();
+
+    [[nodiscard]] PushConstants makePushConstants(float deltaTime, uint32_t emitCount) const noexcept;
+
+    ContextVulkan& m_context;
+    vk::Device m_device;
+
+    const uint32_t m_capacity;
+
+    ParticleEmitter m_emitter{};
+    float m_emitAccumulator{};
+    uint32_t m_seed{};
+    TimePoint m_lastUpdate{};
+    PushConstants m_pushConstants{};
+
+    vk::Buffer m_particleBuffer{};
+    vk::DeviceMemory m_particleBufferMemory{};
+    vk::Buffer m_freeListBuffer{};
+    vk::DeviceMemory m_freeListBufferMemory{};
+    vk::Buffer m_aliveListBuffer{};
+    vk::DeviceMemory m_aliveListBufferMemory{};
+    vk::Buffer m_drawCommandBuffer{};
+    vk::DeviceMemory m_drawCommandBufferMemory{};
+
+    // Owned by the context's layout cache
+    vk::DescriptorSetLayout m_descriptorSetLayout{};
+    vk::PipelineLayout m_pipelineLayout{};
+    vk::ShaderStageFlags m_pushConstantStages{};
+    std::vector<vk::DescriptorPoolSize> m_descriptorPoolSizes{};
+    vk::Pipeline m_emitPipeline{};
+    vk::Pipeline m_simulatePipeline{};
+    PipelineDesc m_graphicsPipelineDesc{};
+
+    vk::DescriptorPool m_descriptorPool{};
+    std::vector<vk::DescriptorSet> m_descriptorSets{};
+};
+}  // namespace vulk
@@ -0,0 +1,85 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Vulk/SpecializationConstants.hpp"
+#include "Vulk/Vulkan.hpp"
+
+namespace vulk {
+/**
+ * Everything a graphics pipeline is built from, compact enough to be hashed and compared as a registry key.
+ *
+ * The vertex input state isn't listed, it is reflected from the vertex shader. So is the layout, unless one is given.
+ * The viewport and scissor are always dynamic states. With VK_EXT_extended_dynamic_state, so are the cull mode, front
+ * face, depth state and the topology within its class: descriptions differing only by them share a pipeline.
+ */
+struct PipelineDesc
+{
+    enum class BlendMode
+    {
+        eOpaque,
+        eAlpha,
+        eAdditive,
+    };
+
+    // SPIR-V file paths
+    std::string vertexShader{};
+    std::string fragmentShader{};
+
+    // Shader variants, each combination of values is a pipeline of its own
+    SpecializationConstants vertexConstants{};
+    SpecializationConstants fragmentConstants{};
+
+    // Stride of the single interleaved vertex buffer, 0 without vertex input
+    uint32_t vertexStride{0};
+
+    vk::PrimitiveTopology topology{vk::PrimitiveTopology::eTriangleList};
+    vk::PolygonMode polygonMode{vk::PolygonMode::eFill};
+    vk::CullModeFlags cullMode{vk::CullModeFlagBits::eBack};
+    vk::FrontFace frontFace{vk::FrontFace::eCounterClockwise};
+
+    BlendMode blendMode{BlendMode::eOpaque};
+
+    bool depthTest{false};
+    bool depthWrite{false};
+    vk::CompareOp depthCompareOp{vk::CompareOp::eLess};
+
+    // Shared with other pipelines, e.g. compute pipelines using the same descriptor sets. Reflected when null
+    vk::PipelineLayout layout{};
+
+    // Render pass compatibility
+    vk::RenderPass renderPass{};
+    uint32_t subpass{0};
+
+    /** Point, line, triangle or patch: topologies of a class can be switched dynamically. */
+    [[nodiscard]] static vk::PrimitiveTopology getTopologyClass(vk::PrimitiveTopology topology) noexcept;
+
+    /** Without `ignoreDynamicState`, every member is hashed. */
+    [[nodiscard]] uint64_t hash(bool ignoreDynamicState = false) const noexcept;
+
+    /** Whether both descriptions build the same pipeline. */
+    [[nodiscard]] bool isSamePipeline(const PipelineDesc& rhs, bool ignoreDynamicState) const noexcept;
+
+    bool operator==(const PipelineDesc& rhs) const = default;
+};
+}  // namespace vulk
@@ -0,0 +1,73 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "Vulk/ClassUtils.hpp"
+#include "Vulk/ShaderReflection.hpp"
+#include "Vulk/Vulkan.hpp"
+
+namespace vulk {
+/**
+ * Owns the descriptor set layouts and pipeline layouts, created from reflected shader interfaces.
+ *
+ * Pipelines with the same interface share the same layout objects, which also keeps their descriptor sets
+ * compatible. Thread safe, pipelines may be built from background threads.
+ */
+class PipelineLayoutCache
+{
+public:
+    struct Layout
+    {
+        vk::PipelineLayout pipelineLayout{};
+        std::vector<vk::DescriptorSetLayout> setLayouts{};  // Indexed by set number
+    };
+
+    explicit PipelineLayoutCache(const vk::Device& device);
+    ~PipelineLayoutCache();
+
+    VULK_NO_MOVE_OR_COPY(PipelineLayoutCache)
+
+    /**
+     * @param reflection interface of the whole pipeline, every stage merged
+     */
+    [[nodiscard]] Layout getLayout(const ShaderReflection& reflection);
+
+    [[nodiscard]] size_t getSetLayoutCount() const;
+    [[nodiscard]] size_t getPipelineLayoutCount() const;
+
+private:
+    using Key = std::vector<uint32_t>;
+
+    [[nodiscard]] uint32_t getSetLayoutId(std::span<const ShaderReflection::DescriptorBinding> bindings);
+
+    vk::Device m_device;  // TODO: Remove once vk::raii is implemented
+
+    mutable std::mutex m_mutex{};
+    std::vector<vk::DescriptorSetLayout> m_setLayouts{};
+    std::map<Key, uint32_t> m_setLayoutIds{};
+    std::map<Key, Layout> m_layouts{};
+};
+}  // namespace vulk
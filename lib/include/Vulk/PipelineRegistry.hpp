@@ -0,0 +1,160 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "Vulk/ClassUtils.hpp"
+#include "Vulk/PipelineDesc.hpp"
+#include "Vulk/PipelineLayoutCache.hpp"
+#include "Vulk/ShaderLibrary.hpp"
+#include "Vulk/ShaderReflection.hpp"
+#include "Vulk/ThreadPool.hpp"
+#include "Vulk/Vulkan.hpp"
+
+namespace vulk {
+/**
+ * Owns the graphics pipelines, one per distinct PipelineDesc: descriptions that build the same pipeline share it, it
+ * is only built the first time it is requested. With extended dynamic state, that is regardless of the render state
+ * set by recordDynamicState().
+ *
+ * Pipelines requested with requestPipeline() are compiled on worker threads, the render thread never waits for the
+ * driver: until they are ready, callers draw with a fallback pipeline or skip the draw.
+ *
+ * Thread safe, pipelines are built outside of the lock.
+ */
+class PipelineRegistry
+{
+public:
+    struct Pipeline
+    {
+        vk::Pipeline pipeline{};
+        PipelineLayoutCache::Layout layout{};  // Without set layouts when given by the description
+        ShaderReflection reflection{};  // Every stage merged
+    };
+
+    struct Statistics
+    {
+        size_t hits{0};
+        size_t misses{0};
+        size_t pending{0};  // Requests that found their pipeline still compiling
+        size_t failures{0};
+    };
+
+    /**
+     * `extendedDynamicState` loads the VK_EXT_extended_dynamic_state commands, when the device has it enabled.
+     */
+    PipelineRegistry(const vk::Device& device, PipelineLayoutCache& layoutCache, ShaderLibrary& shaderLibrary,
+                     ThreadPool& workers, const vk::DispatchLoaderDynamic* extendedDynamicState = nullptr);
+
+    /**
+     * Waits for the builds in flight.
+     */
+    ~PipelineRegistry();
+
+    VULK_NO_MOVE_OR_COPY(PipelineRegistry)
+
+    /**
+     * Blocks until the pipeline is built. Returned references stay valid until the pipeline is replaced or the
+     * registry cleared.
+     */
+    [[nodiscard]] const Pipeline& getPipeline(const PipelineDesc& desc);
+
+    /**
+     * Never blocks: returns nullptr and queues a background build when the pipeline isn't ready yet, so requesting
+     * a pipeline ahead of its first use hides the compilation entirely.
+     * Pipelines that failed to build are reported once and never retried, until the registry is cleared.
+     */
+    const Pipeline* requestPipeline(const PipelineDesc& desc);
+
+    /**
+     * Builds a pipeline without registering it, the caller owns it. Meant to rebuild reloaded shaders.
+     */
+    [[nodiscard]] Pipeline buildPipeline(const PipelineDesc& desc) const;
+
+    /**
+     * Registers a pipeline built by buildPipeline(), returns the one it replaces (if any), now owned by the caller.
+     */
+    [[nodiscard]] vk::Pipeline replacePipeline(const PipelineDesc& desc, Pipeline pipeline);
+
+    /**
+     * Sets the render state of the description that isn't baked into its pipeline, once bound. Nothing without
+     * extended dynamic state. The viewport and scissor are left to the owner of the render pass.
+     */
+    void recordDynamicState(const vk::CommandBuffer& commandBuffer, const PipelineDesc& desc) const;
+
+    [[nodiscard]] bool hasExtendedDynamicState() const noexcept { return m_extendedDynamicState != nullptr; }
+
+    /**
+     * Same for descriptions sharing a pipeline, e.g. to sort draws by pipeline.
+     */
+    [[nodiscard]] uint64_t getPipelineHash(const PipelineDesc& desc) const noexcept
+    {
+        return desc.hash(hasExtendedDynamicState());
+    }
+
+    void waitForBuilds();
+
+    /**
+     * Destroys every pipeline, e.g. when the render pass they are built for is recreated. The device must be idle.
+     * Waits for the builds in flight first, they still target the previous render pass.
+     */
+    void clear();
+
+    [[nodiscard]] size_t getPipelineCount() const;
+    [[nodiscard]] Statistics getStatistics() const;
+
+private:
+    struct DescHash
+    {
+        bool ignoreDynamicState{false};
+
+        size_t operator()(const PipelineDesc& desc) const noexcept { return desc.hash(ignoreDynamicState); }
+    };
+
+    struct DescEqual
+    {
+        bool ignoreDynamicState{false};
+
+        bool operator()(const PipelineDesc& lhs, const PipelineDesc& rhs) const noexcept
+        {
+            return lhs.isSamePipeline(rhs, ignoreDynamicState);
+        }
+    };
+
+    void buildInBackground(const PipelineDesc& desc);
+
+    vk::Device m_device;  // TODO: Remove once vk::raii is implemented
+    PipelineLayoutCache& m_layoutCache;
+    ShaderLibrary& m_shaderLibrary;
+    ThreadPool& m_workers;
+    const vk::DispatchLoaderDynamic* m_extendedDynamicState;
+
+    mutable std::mutex m_mutex{};
+    std::condition_variable m_buildFinished{};
+    std::unordered_map<PipelineDesc, Pipeline, DescHash, DescEqual> m_pipelines;
+    std::unordered_set<PipelineDesc, DescHash, DescEqual> m_building;
+    std::unordered_set<PipelineDesc, DescHash, DescEqual> m_failed;
+    Statistics m_statistics{};
+};
+}  // namespace vulk
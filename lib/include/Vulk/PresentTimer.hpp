@@ -0,0 +1,106 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "Vulk/ClassUtils.hpp"
+#include "Vulk/InputLatency.hpp"
+#include "Vulk/SpscRingBuffer.hpp"
+#include "Vulk/Vulkan.hpp"
+
+namespace vulk {
+/**
+ * Measures when presented frames reach the screen.
+ *
+ * With VK_KHR_present_wait, a background thread waits for the last present id submitted and timestamps it when the
+ * wait returns, the frames before it are on screen by then too. Without it, a frame is timed when its fence is seen
+ * signaled by update(): that's when its rendering finished, at the resolution of the render thread, before it is
+ * actually displayed.
+ *
+ * Render thread only, except for the waiter thread.
+ */
+class PresentTimer
+{
+public:
+    static constexpr size_t s_maxPendingPresents{8};
+
+    /**
+     * `presentWait` loads the VK_KHR_present_wait commands, when the device has it and VK_KHR_present_id enabled.
+     * Present ids must be chained to the presents then.
+     */
+    explicit PresentTimer(const vk::Device& device, const vk::DispatchLoaderDynamic* presentWait = nullptr);
+
+    ~PresentTimer();
+
+    VULK_NO_MOVE_OR_COPY(PresentTimer)
+
+    /**
+     * Waits for the presents to `swapchain` from now on. Nothing without present wait.
+     */
+    void start(const vk::SwapchainKHR& swapchain);
+
+    /**
+     * Must be called before the swapchain is destroyed, the presents not timed yet never will be.
+     */
+    void stop() noexcept;
+
+    /**
+     * Once the frame rendered with `fence` was presented with `presentId`, ids increase from one present to the next.
+     */
+    void onPresented(uint64_t presentId, const vk::Fence& fence);
+
+    /**
+     * The frames timed since the previous call, oldest first. Valid until the next call.
+     * Meant to be called right after waiting on a frame fence, before it is reset.
+     */
+    [[nodiscard]] std::span<const PresentTiming> update();
+
+    [[nodiscard]] bool hasPresentWait() const noexcept { return m_presentWait != nullptr; }
+
+private:
+    struct PendingPresent
+    {
+        uint64_t presentId{0};
+        vk::Fence fence{};
+    };
+
+    void waitForPresents();
+
+    vk::Device m_device;  // TODO: Remove once vk::raii is implemented
+    const vk::DispatchLoaderDynamic* m_presentWait;
+
+    std::vector<PresentTiming> m_timings{};
+
+    // Without present wait
+    std::vector<PendingPresent> m_pendingPresents{};
+
+    // With present wait
+    vk::SwapchainKHR m_swapchain{};
+    std::atomic<uint64_t> m_lastPresentId{0};
+    SpscRingBuffer<PresentTiming, 64> m_presented{};
+    std::atomic<bool> m_running{false};
+    std::thread m_thread{};
+};
+}  // namespace vulk
@@ -0,0 +1,85 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace vulk {
+enum class RenderCounter : size_t
+{
+    eDrawCalls,
+    eInstances,
+    eTriangles,  // Assuming triangle lists
+    ePipelineBinds,
+    eDescriptorSetBinds,
+    eBufferUploads,
+    eUploadedBytes,
+    eAllocations,
+    eAllocatedBytes,
+    eQueueSubmits,
+    eCount
+};
+
+/**
+ * Totals of what the renderer did, usually over a frame.
+ */
+class RenderCounters
+{
+public:
+    static constexpr size_t s_count{static_cast<size_t>(RenderCounter::eCount)};
+
+    [[nodiscard]] uint64_t operator[](RenderCounter counter) const noexcept
+    {
+        return m_values[static_cast<size_t>(counter)];
+    }
+
+    [[nodiscard]] uint64_t& operator[](RenderCounter counter) noexcept
+    {
+        return m_values[static_cast<size_t>(counter)];
+    }
+
+    RenderCounters& operator+=(const RenderCounters& other) noexcept;
+
+    [[nodiscard]] bool operator==(const RenderCounters& other) const noexcept = default;
+
+    [[nodiscard]] static const char* getName(RenderCounter counter) noexcept;
+
+private:
+    std::array<uint64_t, s_count> m_values{};
+};
+
+/**
+ * Counting is lock free and cheap enough for the hot paths: every thread adds to its own accumulator, fold() sums
+ * and resets them once per frame.
+ */
+namespace counters {
+void add(RenderCounter counter, uint64_t value = 1) noexcept;
+
+/**
+ * What every thread counted since the previous fold().
+ */
+[[nodiscard]] RenderCounters fold();
+}  // namespace counters
+}  // namespace vulk
+
+std::ostream& operator<<(std::ostream& os, const vulk::RenderCounters& counters);
@@ -19,20 +19,267 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <utility>
+#include <vector>
+#include <version>
+
+#if __has_include(<source_location>)
+    #include <source_location>
+#endif
+
+#include "Vulk/ClassUtils.hpp"
+#include "Vulk/FrameCallTree.hpp"
+#include "Vulk/SpscRingBuffer.hpp"
 
 namespace vulk::utils {
+#if defined(__cpp_lib_source_location)
+using SourceLocation = std::source_location;
+#else
+/**
+ * Stand-in for std::source_location where the standard library lacks it (GCC 10), on the builtins it relies on.
+ */
+struct SourceLocation
+{
+    static consteval SourceLocation current(const char* file = __builtin_FILE(),
+                                            uint_least32_t line = __builtin_LINE()) noexcept
+    {
+        return SourceLocation{file, line};
+    }
+
+    [[nodiscard]] constexpr const char* file_name() const noexcept { return m_file; }
+    [[nodiscard]] constexpr uint_least32_t line() const noexcept { return m_line; }
+
+    const char* m_file{""};
+    uint_least32_t m_line{0};
+};
+#endif
+
+/**
+ * Zones are enabled by category at runtime, see Profiler::setCategoryEnabled().
+ */
+enum class ProfilerCategory : uint32_t
+{
+    eGeneral,
+    eFrame,  // Run every frame
+    eLoading,  // Files, meshes and GPU resources
+    eShaders,  // Compilation, reflection and pipelines
+    eVulkan,  // Device and queue calls, with VULK_ACCOUNT_VULKAN_CALLS
+    eCount
+};
+
+/**
+ * Everything known about a zone at compile time, one static instance per zone: recording a zone only stores a
+ * pointer to it and its timestamps. Declared through VULK_SCOPED_PROFILER(), or directly to pick a color.
+ */
+struct ZoneDescriptor
+{
+    static constexpr std::array<uint32_t, static_cast<size_t>(ProfilerCategory::eCount)> s_categoryColors{
+      0x9e9e9e, 0x4caf50, 0x2196f3, 0xff9800, 0xe91e63};
+
+    consteval ZoneDescriptor(const char* zoneName, ProfilerCategory zoneCategory = ProfilerCategory::eGeneral,
+                             uint32_t zoneColor = 0, SourceLocation location = SourceLocation::current()) noexcept
+        : name{zoneName},
+          file{location.file_name()},
+          line{location.line()},
+          color{zoneColor != 0 ? zoneColor : s_categoryColors[static_cast<size_t>(zoneCategory)]},
+          category{zoneCategory}
+    {
+    }
+
+    const char* name;
+    const char* file;
+    uint_least32_t line;
+    uint32_t color;  // 0xRRGGBB, the category's by default
+    ProfilerCategory category;
+};
+
+/**
+ * Collects the zones timed by ScopedProfiler. It writes them as a Chrome trace (JSON array format), which
+ * chrome://tracing and https://ui.perfetto.dev open, and aggregates the zones of the frame thread in a call tree.
+ *
+ * Recording a zone only pushes it to a ring buffer owned by the calling thread, without locking nor formatting. While
+ * a trace runs, a background thread drains the buffers every few milliseconds, flush() does otherwise; zones recorded
+ * faster than that are dropped and counted. The buffer of a thread is freed once drained after the thread exits.
+ */
+class Profiler final
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using Ticks = FrameCallTree::Ticks;
+
+    struct Zone
+    {
+        const ZoneDescriptor* descriptor{nullptr};  // Null marks the end of a frame
+        Ticks begin{0};
+        Ticks end{0};
+    };
+
+    static constexpr size_t s_zonesPerThread{1u << 14};
+
+    /**
+     * Never destroyed, zones may be recorded until the very end of the program (e.g. by static destructors). Nothing
+     * is written until startTrace(), and a trace still running at exit is stopped then.
+     */
+    static Profiler& getInstance();
+
+    [[nodiscard]] static Ticks now() noexcept { return Clock::now().time_since_epoch().count(); }
+
+    /**
+     * Every category is enabled at first. Disabled zones cost a relaxed atomic load, and the profiler isn't even
+     * created until an enabled zone ends.
+     */
+    static void setCategoryEnabled(ProfilerCategory category, bool enabled) noexcept;
+    static void setEnabledCategories(uint32_t mask) noexcept { s_enabledCategories.store(mask); }
+
+    [[nodiscard]] static bool isCategoryEnabled(ProfilerCategory category) noexcept
+    {
+        return (s_enabledCategories.load(std::memory_order_relaxed) & getCategoryMask(category)) != 0;
+    }
+
+    [[nodiscard]] static constexpr uint32_t getCategoryMask(ProfilerCategory category) noexcept
+    {
+        return 1u << static_cast<uint32_t>(category);
+    }
+
+    [[nodiscard]] static const char* getCategoryName(ProfilerCategory category) noexcept;
+
+    /**
+     * Lock free.
+     */
+    void record(const ZoneDescriptor& zone, Ticks begin, Ticks end) noexcept;
+
+    /**
+     * Ends the current frame of the calling thread, which becomes the frame thread if there was none. Lock free.
+     */
+    void markFrame() noexcept;
+
+    /**
+     * Stops the current trace first, if any, and starts the background thread.
+     */
+    void startTrace(const std::string& filePath);
+
+    /**
+     * Joins the background thread, writes the zones left in the buffers and closes the trace file.
+     */
+    void stopTrace();
+
+    [[nodiscard]] bool isTracing() const noexcept { return m_tracing.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t getDroppedZoneCount() const noexcept { return m_droppedZones.load(); }
+
+    /**
+     * Threads which recorded a zone, the exited ones included until their buffer is drained.
+     */
+    [[nodiscard]] size_t getThreadCount() const;
+
+    /**
+     * Call tree of the frame thread, averaged over the last frames. Zones which ended up to a few milliseconds ago
+     * may not be counted yet, call flush() first to include them.
+     */
+    [[nodiscard]] std::vector<FrameCallTree::Node> getFrameProfile() const;
+    void setFrameWindow(size_t frameCount);
+
+    /**
+     * Processes every zone recorded so far, instead of waiting for the background thread to.
+     */
+    void flush();
+
+    VULK_NO_MOVE_OR_COPY(Profiler)
+
+private:
+    struct ThreadBuffer
+    {
+        uint32_t threadId{0};
+        std::atomic<bool> retired{false};  // Its thread exited, no zone will be pushed anymore
+        SpscRingBuffer<Zone, s_zonesPerThread> zones{};
+    };
+
+    /**
+     * Retires the buffer of the calling thread when the thread exits.
+     */
+    struct ThreadBufferOwner
+    {
+        ThreadBuffer* buffer{nullptr};
+
+        ~ThreadBufferOwner();
+    };
+
+    Profiler();
+
+    /**
+     * Null once the calling thread is exiting, e.g. for the zones of its thread_local destructors.
+     */
+    ThreadBuffer* getThreadBuffer();
+    void push(const Zone& zone) noexcept;
+
+    void runFlusher();
+
+    /**
+     * With m_traceMutex locked.
+     */
+    void closeTrace();
+
+    /**
+     * With m_flushMutex locked.
+     */
+    void writeZone(const Zone& zone, uint32_t threadId);
+
+    static thread_local ThreadBufferOwner s_threadBuffer;
+    static thread_local bool s_threadExited;
+    static inline std::atomic<uint32_t> s_enabledCategories{~0u};
+
+    std::atomic<bool> m_tracing{false};
+    std::atomic<uint64_t> m_droppedZones{0};
+    std::atomic<const ThreadBuffer*> m_frameThreadBuffer{nullptr};
+
+    // Freed by flush() once retired and drained
+    mutable std::mutex m_buffersMutex{};
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers{};
+    uint32_t m_nextThreadId{1};
+
+    // Consuming the buffers, writing the trace and the call tree
+    mutable std::mutex m_flushMutex{};
+    std::ofstream m_output{};
+    Ticks m_traceStart{0};
+    bool m_firstZone{true};
+    std::vector<FrameCallTree::Zone> m_currentFrame{};
+    FrameCallTree m_frameCallTree{};
+
+    // Starting and stopping the trace, with its flusher thread
+    std::mutex m_traceMutex{};
+    std::mutex m_flusherMutex{};
+    std::condition_variable m_flusherWakeUp{};
+    bool m_stopFlusher{false};
+    std::thread m_flusher{};
+};
+
 class ScopedProfiler final
 {
 public:
-    using Clock = std::chrono::high_resolution_clock;
-    using TimePoint = decltype(Clock::now());
-    using DurationSeconds = std::chrono::duration<double>;
-    using DurationMillis = std::chrono::duration<double, std::milli>;
+    explicit ScopedProfiler(const ZoneDescriptor& zone) noexcept
+        : m_zone{Profiler::isCategoryEnabled(zone.category) ? &zone : nullptr}, m_begin{m_zone ? Profiler::now() : 0}
+    {
+    }
+
+    /**
+     * Only static descriptors, the zone is recorded by address.
+     */
+    explicit ScopedProfiler(const ZoneDescriptor&& zone) = delete;
 
-    explicit ScopedProfiler(const char* name) noexcept;
-    ~ScopedProfiler();
+    ~ScopedProfiler()
+    {
+        if (m_zone)
+            Profiler::getInstance().record(*m_zone, m_begin, Profiler::now());
+    }
 
     ScopedProfiler(ScopedProfiler&&) = delete;
     ScopedProfiler(const ScopedProfiler&) = delete;
@@ -40,8 +287,8 @@ public:
     ScopedProfiler& operator=(const ScopedProfiler&) = delete;
 
 private:
-    const TimePoint m_start;
-    const char* const m_name;
+    const ZoneDescriptor* const m_zone;
+    const Profiler::Ticks m_begin;
 };
 }  // namespace vulk::utils
 
@@ -49,7 +296,14 @@ private:
 #define VULK_STR(x, y)      VULK_STR_IMPL(x, y)
 
 #if VULK_WITH_SCOPED_PROFILER
-    #define VULK_SCOPED_PROFILER(x) const vulk::utils::ScopedProfiler VULK_STR(_SCOPED_PROFILER_, __LINE__)(x)
+    #define VULK_SCOPED_PROFILER_CATEGORY(x, category)                                                       \
+        static constexpr vulk::utils::ZoneDescriptor VULK_STR(_PROFILER_ZONE_, __LINE__){                   \
+          x, vulk::utils::ProfilerCategory::category};                                                       \
+        const vulk::utils::ScopedProfiler VULK_STR(_SCOPED_PROFILER_, __LINE__)(VULK_STR(_PROFILER_ZONE_, __LINE__))
+    #define VULK_SCOPED_PROFILER(x) VULK_SCOPED_PROFILER_CATEGORY(x, eGeneral)
+    #define VULK_PROFILER_FRAME()   vulk::utils::Profiler::getInstance().markFrame()
 #else
-    #define VULK_SCOPED_PROFILER(x) (void) 0
+    #define VULK_SCOPED_PROFILER_CATEGORY(x, category) (void) 0
+    #define VULK_SCOPED_PROFILER(x)                    (void) 0
+    #define VULK_PROFILER_FRAME()                      (void) 0
 #endif
@@ -19,31 +19,53 @@
 
 #pragma once
 
-#include <vulkan/vulkan.hpp>
-
 #include <cstdint>
+#include <memory>
+#include <span>
 #include <vector>
 
+#include "Vulk/ClassUtils.hpp"
+#include "Vulk/ShaderLibrary.hpp"
+#include "Vulk/ShaderReflection.hpp"
+#include "Vulk/SpecializationConstants.hpp"
+#include "Vulk/Vulkan.hpp"
+
 namespace vulk {
+/**
+ * A shader module used as a pipeline stage. Modules are usually shared through a ShaderLibrary, the constructors
+ * taking a file or code create a module of their own.
+ */
 class Shader
 {
 public:
     using Type = vk::ShaderStageFlagBits;
 
-    Shader(vk::Device& device, const char* filePath, Type type);
-    ~Shader();
+    Shader(const vk::Device& device, const char* filePath, Type type);
+    Shader(const vk::Device& device, std::span<const uint32_t> code, Type type);
+    Shader(std::shared_ptr<const ShaderLibrary::Module> module, Type type);
+
+    VULK_NO_MOVE_OR_COPY(Shader)
+
+    /**
+     * Selects a variant, the constants are copied into the stage create info. Every id must be declared by the shader
+     * as a 32 bit constant.
+     */
+    void specialize(const SpecializationConstants& constants);
 
     [[nodiscard]] const vk::PipelineShaderStageCreateInfo& getShaderStageCreateInfo() const noexcept
     {
         return m_pipelineShaderStageCreateInfo;
     }
 
+    [[nodiscard]] const ShaderReflection& getReflection() const noexcept { return m_module->getReflection(); }
+
 private:
-    vk::Device m_device;  // TODO: Remove once vk::raii is implemented
+    std::shared_ptr<const ShaderLibrary::Module> m_module;
 
-    std::vector<char> m_buffer{};
-    vk::ShaderModule m_shaderModule{};
     vk::PipelineShaderStageCreateInfo m_pipelineShaderStageCreateInfo{};
+    std::vector<vk::SpecializationMapEntry> m_specializationMapEntries{};
+    std::vector<uint32_t> m_specializationData{};
+    vk::SpecializationInfo m_specializationInfo{};
 
     Type m_type{};
 };
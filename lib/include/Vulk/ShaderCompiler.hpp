@@ -0,0 +1,104 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <shaderc/shaderc.hpp>
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "Vulk/ClassUtils.hpp"
+#include "Vulk/MappedFile.hpp"
+#include "Vulk/Vulkan.hpp"
+
+namespace vulk {
+/**
+ * SPIR-V words, either compiled in memory or memory-mapped from the cache.
+ */
+class SpirvCode
+{
+public:
+    explicit SpirvCode(std::vector<uint32_t> words) : m_storage{std::move(words)} {}
+    explicit SpirvCode(MappedFile file) : m_storage{std::move(file)} {}
+
+    [[nodiscard]] std::span<const uint32_t> getWords() const noexcept;
+    [[nodiscard]] bool isCached() const noexcept { return std::holds_alternative<MappedFile>(m_storage); }
+
+private:
+    std::variant<std::vector<uint32_t>, MappedFile> m_storage;
+};
+
+/**
+ * In-process GLSL to SPIR-V compilation through shaderc, with an on-disk cache.
+ *
+ * Sources are preprocessed first: the cache key is a hash of the preprocessed text, which already accounts for the
+ * included files and the macro definitions, along with the stage, the optimization level and the compiler version.
+ * Preprocessing is much cheaper than compiling, so requesting an already built variant costs one preprocessing pass
+ * and a mapping.
+ */
+class ShaderCompiler
+{
+public:
+    struct Define
+    {
+        std::string name{};
+        std::string value{};
+    };
+
+    explicit ShaderCompiler(std::string cacheDirectory = "shader-cache");
+
+    VULK_NO_MOVE_OR_COPY(ShaderCompiler)
+
+    /**
+     * Include directories are searched after the directory of the including file.
+     */
+    void addIncludeDirectory(std::string directory);
+
+    /**
+     * Defaults to no optimization in debug builds, to optimizing for performance otherwise.
+     */
+    void setOptimizationLevel(shaderc_optimization_level level) noexcept { m_optimizationLevel = level; }
+
+    /**
+     * @throw ShaderCompilationException with the compiler's messages
+     */
+    [[nodiscard]] SpirvCode compileFile(const char* filePath, vk::ShaderStageFlagBits stage,
+                                        std::span<const Define> defines = {}) const;
+    [[nodiscard]] SpirvCode compile(std::string_view source, const std::string& fileName,
+                                    vk::ShaderStageFlagBits stage, std::span<const Define> defines = {}) const;
+
+    /**
+     * Guesses the stage from .vert, .frag and .comp extensions, optionally followed by .spv.
+     */
+    [[nodiscard]] static vk::ShaderStageFlagBits getStageFromPath(std::string_view filePath);
+
+private:
+    [[nodiscard]] shaderc::CompileOptions makeOptions(std::span<const Define> defines) const;
+
+    shaderc::Compiler m_compiler{};
+    std::string m_cacheDirectory;
+    std::vector<std::string> m_includeDirectories{};
+    shaderc_optimization_level m_optimizationLevel;
+};
+}  // namespace vulk
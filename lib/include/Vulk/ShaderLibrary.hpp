@@ -0,0 +1,98 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+
+#include "Vulk/ClassUtils.hpp"
+#include "Vulk/ShaderReflection.hpp"
+#include "Vulk/Vulkan.hpp"
+
+namespace vulk {
+/**
+ * Loads each SPIR-V file once and keeps its shader module and reflection alive, so that rebuilding pipelines (e.g.
+ * when the swapchain is recreated) neither reads files nor creates modules.
+ *
+ * Thread safe, files are loaded outside of the lock. Modules are shared: one dropped from the library by evict() is
+ * only destroyed once the last shader using it is.
+ */
+class ShaderLibrary
+{
+public:
+    class Module
+    {
+    public:
+        Module(const vk::Device& device, std::span<const uint32_t> code);
+        ~Module();
+
+        VULK_NO_MOVE_OR_COPY(Module)
+
+        [[nodiscard]] vk::ShaderModule getHandle() const noexcept { return m_module; }
+        [[nodiscard]] const ShaderReflection& getReflection() const noexcept { return m_reflection; }
+
+    private:
+        vk::Device m_device;  // TODO: Remove once vk::raii is implemented
+        vk::ShaderModule m_module{};
+        ShaderReflection m_reflection;
+    };
+
+    struct Statistics
+    {
+        size_t hits{0};
+        size_t loads{0};
+    };
+
+    explicit ShaderLibrary(const vk::Device& device);
+
+    VULK_NO_MOVE_OR_COPY(ShaderLibrary)
+
+    /**
+     * Reads a module that isn't part of any library.
+     */
+    [[nodiscard]] static std::shared_ptr<const Module> loadModule(const vk::Device& device, const char* filePath);
+
+    /**
+     * Loads the file the first time it is requested.
+     */
+    [[nodiscard]] std::shared_ptr<const Module> getModule(const std::string& filePath);
+
+    /**
+     * Forgets a file, the next request reads it again. Meant for files rebuilt while running.
+     */
+    void evict(const std::string& filePath);
+
+    void clear();
+
+    [[nodiscard]] size_t getModuleCount() const;
+    [[nodiscard]] Statistics getStatistics() const;
+
+private:
+    vk::Device m_device;  // TODO: Remove once vk::raii is implemented
+
+    mutable std::mutex m_mutex{};
+    std::unordered_map<std::string, std::shared_ptr<const Module>> m_modules{};
+    Statistics m_statistics{};
+};
+}  // namespace vulk
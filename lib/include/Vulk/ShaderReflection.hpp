@@ -0,0 +1,117 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Vulk/Vulkan.hpp"
+
+namespace vulk {
+/**
+ * Resource interface of a SPIR-V module: descriptor bindings, push constants, vertex inputs and specialization
+ * constants.
+ *
+ * Only the module's global declarations are parsed, which is enough to build descriptor set layouts, pipeline layouts
+ * and the vertex input state without keeping them in sync with the shaders by hand.
+ */
+class ShaderReflection
+{
+public:
+    struct DescriptorBinding
+    {
+        uint32_t set{0};
+        uint32_t binding{0};
+        vk::DescriptorType type{};
+        uint32_t count{1};
+        vk::ShaderStageFlags stages{};
+    };
+
+    struct VertexInput
+    {
+        uint32_t location{0};
+        vk::Format format{};
+        uint32_t size{0};
+    };
+
+    struct SpecializationConstant
+    {
+        uint32_t id{0};
+        uint32_t size{0};  // Booleans are 32 bit wide VkBool32
+    };
+
+    struct VertexInputLayout
+    {
+        vk::VertexInputBindingDescription binding{};
+        std::vector<vk::VertexInputAttributeDescription> attributes{};
+    };
+
+    ShaderReflection() = default;
+    explicit ShaderReflection(std::span<const uint32_t> code);
+
+    /**
+     * Adds the interface of another stage of the same pipeline, bindings declared by both have their stages merged.
+     * Push constants are merged into a single range covering both. Specialization constants are set per stage, they
+     * aren't merged.
+     */
+    void merge(const ShaderReflection& other);
+
+    [[nodiscard]] vk::ShaderStageFlags getStages() const noexcept { return m_stages; }
+
+    /** Sorted by set, then binding. */
+    [[nodiscard]] const std::vector<DescriptorBinding>& getDescriptorBindings() const noexcept
+    {
+        return m_descriptorBindings;
+    }
+
+    [[nodiscard]] const std::optional<vk::PushConstantRange>& getPushConstantRange() const noexcept
+    {
+        return m_pushConstantRange;
+    }
+
+    /** Sorted by location, matrices and arrays are split into one input per location. */
+    [[nodiscard]] const std::vector<VertexInput>& getVertexInputs() const noexcept { return m_vertexInputs; }
+
+    /** Sorted by id. */
+    [[nodiscard]] const std::vector<SpecializationConstant>& getSpecializationConstants() const noexcept
+    {
+        return m_specializationConstants;
+    }
+
+    [[nodiscard]] uint32_t getSetCount() const noexcept;
+
+    /** Pool sizes needed to allocate `setCount` descriptor sets of the given set number. */
+    [[nodiscard]] std::vector<vk::DescriptorPoolSize> getPoolSizes(uint32_t set, uint32_t setCount) const;
+
+    /** A single interleaved vertex buffer, attributes packed in location order. */
+    [[nodiscard]] VertexInputLayout getVertexInputLayout(uint32_t binding = 0) const;
+
+private:
+    void addDescriptorBinding(const DescriptorBinding& descriptorBinding);
+
+    vk::ShaderStageFlags m_stages{};
+    std::vector<DescriptorBinding> m_descriptorBindings{};
+    std::optional<vk::PushConstantRange> m_pushConstantRange{};
+    std::vector<VertexInput> m_vertexInputs{};
+    std::vector<SpecializationConstant> m_specializationConstants{};
+};
+}  // namespace vulk
@@ -0,0 +1,76 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "Vulk/ClassUtils.hpp"
+#include "Vulk/ShaderCompiler.hpp"
+
+namespace vulk {
+/**
+ * Development helper, Linux only (inotify): recompiles GLSL sources in process when they are saved and notifies
+ * listeners when the matching SPIR-V output changes, including when it is rebuilt by CMake.
+ *
+ * Everything happens on a background thread, listeners included: they are expected to build what they need there
+ * and hand it over to the render thread.
+ */
+class ShaderWatcher
+{
+public:
+    /**
+     * @param shaderName output file name, e.g. "shader.vert.spv"
+     */
+    using Listener = std::function<void(const std::string& shaderName)>;
+
+    ShaderWatcher(std::string sourceDirectory, std::string outputDirectory);
+    ~ShaderWatcher();
+
+    VULK_NO_MOVE_OR_COPY(ShaderWatcher)
+
+    void addListener(const std::string& shaderName, Listener listener);
+
+private:
+    void run();
+
+    void compile(const std::string& sourceName) const;
+    void notify(const std::string& shaderName);
+
+    std::string m_sourceDirectory;
+    std::string m_outputDirectory;
+
+    ShaderCompiler m_compiler{};
+
+    int m_inotifyFd{-1};
+    int m_sourceWatch{-1};
+    int m_outputWatch{-1};
+
+    std::mutex m_listenersMutex{};
+    std::unordered_multimap<std::string, Listener> m_listeners{};
+
+    std::atomic<bool> m_running{true};
+    std::thread m_thread{};
+};
+}  // namespace vulk
@@ -0,0 +1,65 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Vulk/Vulkan.hpp"
+
+namespace vulk {
+/**
+ * Values of a shader's specialization constants, e.g. `layout(constant_id = 0) const uint LIGHT_COUNT = 4;`.
+ *
+ * Each combination of values is a shader variant: the driver folds the constants and strips the dead branches when
+ * the pipeline is built, without a source file per permutation. Constants that aren't set keep their default value.
+ * Every supported type is 32 bits wide, so the values are stored packed and used as the specialization data as is.
+ */
+class SpecializationConstants
+{
+public:
+    SpecializationConstants& set(uint32_t id, bool value);
+    SpecializationConstants& set(uint32_t id, int32_t value);
+    SpecializationConstants& set(uint32_t id, uint32_t value);
+    SpecializationConstants& set(uint32_t id, float value);
+
+    [[nodiscard]] bool empty() const noexcept { return m_ids.empty(); }
+    [[nodiscard]] size_t size() const noexcept { return m_ids.size(); }
+
+    /** Sorted. */
+    [[nodiscard]] const std::vector<uint32_t>& getIds() const noexcept { return m_ids; }
+
+    /** The data the map entries point into. */
+    [[nodiscard]] std::span<const uint32_t> getData() const noexcept { return m_values; }
+
+    [[nodiscard]] std::vector<vk::SpecializationMapEntry> getMapEntries() const;
+
+    [[nodiscard]] uint64_t hash(uint64_t seed) const noexcept;
+
+    bool operator==(const SpecializationConstants& rhs) const = default;
+
+private:
+    SpecializationConstants& setBits(uint32_t id, uint32_t bits);
+
+    std::vector<uint32_t> m_ids{};
+    std::vector<uint32_t> m_values{};  // Bit patterns, in the order of the ids
+};
+}  // namespace vulk
@@ -0,0 +1,106 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#include "Vulk/ClassUtils.hpp"
+
+namespace vulk {
+/**
+ * Fixed capacity queue between exactly one producer thread and one consumer thread. Neither side ever blocks, locks
+ * or allocates: the producer drops what doesn't fit instead.
+ */
+template<typename T, size_t Capacity>
+class SpscRingBuffer
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "The capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+    SpscRingBuffer() = default;
+
+    VULK_NO_MOVE_OR_COPY(SpscRingBuffer)
+
+    /**
+     * Producer only. Returns false, leaving the buffer untouched, when it is full.
+     */
+    bool tryPush(const T& item) noexcept
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+
+        // Only reads the consumer's index when the last known one says the buffer is full
+        if (head - m_cachedTail == Capacity)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+
+            if (head - m_cachedTail == Capacity)
+                return false;
+        }
+
+        m_items[head & s_mask] = item;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer only. Calls `consumer` with every item pushed so far, oldest first, returns how many there were.
+     */
+    template<typename Consumer>
+    size_t consume(Consumer&& consumer)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t head = m_head.load(std::memory_order_acquire);
+
+        for (size_t i = tail; i != head; ++i)
+            consumer(m_items[i & s_mask]);
+
+        m_tail.store(head, std::memory_order_release);
+        return head - tail;
+    }
+
+    /**
+     * Exact only when called from one side while the other is idle.
+     */
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] static constexpr size_t capacity() noexcept { return Capacity; }
+
+private:
+    static constexpr size_t s_mask = Capacity - 1;
+    static constexpr size_t s_cacheLineSize = 64;
+
+    // Each side writes its own cache line, so that they don't keep invalidating each other's
+    std::atomic<size_t> m_head{0};
+    size_t m_cachedTail{0};  // The producer's last view of m_tail
+    [[maybe_unused]] std::array<std::byte, s_cacheLineSize - 2 * sizeof(size_t)> m_producerPadding{};
+
+    std::atomic<size_t> m_tail{0};
+    [[maybe_unused]] std::array<std::byte, s_cacheLineSize - sizeof(size_t)> m_consumerPadding{};
+
+    std::array<T, Capacity> m_items{};
+};
+}  // namespace vulk
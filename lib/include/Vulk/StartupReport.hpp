@@ -0,0 +1,106 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Vulk/ClassUtils.hpp"
+#include "Vulk/Time.hpp"
+
+namespace vulk {
+/**
+ * Durations of the initialization phases, timed from the report's creation. Phases may run concurrently, on any
+ * thread: comparing the sum of their durations to the total shows how much of the work overlapped.
+ *
+ * Thread safe.
+ */
+class StartupReport
+{
+public:
+    struct Phase
+    {
+        std::string name{};
+        Duration start{};  // Since the report's creation
+        Duration duration{};
+        bool onWorkerThread{false};  // Any thread but the one which created the report
+    };
+
+    /**
+     * Records a phase when it goes out of scope.
+     */
+    class ScopedPhase
+    {
+    public:
+        ~ScopedPhase();
+
+        VULK_NO_MOVE_OR_COPY(ScopedPhase)
+
+    private:
+        friend class StartupReport;
+
+        ScopedPhase(StartupReport& report, std::string name);
+
+        StartupReport& m_report;
+        std::string m_name;
+        const TimePoint m_start;
+    };
+
+    StartupReport();
+
+    [[nodiscard]] ScopedPhase measure(std::string name) { return ScopedPhase{*this, std::move(name)}; }
+
+    void addPhase(std::string name, TimePoint start, TimePoint end);
+
+    /**
+     * Stops the total, phases can still be added afterwards.
+     */
+    void finish();
+
+    /**
+     * Sorted by start.
+     */
+    [[nodiscard]] std::vector<Phase> getPhases() const;
+
+    /**
+     * Wall time from the report's creation to finish(), or to now until then.
+     */
+    [[nodiscard]] Duration getTotal() const;
+
+    /**
+     * What the total would be if the phases had run one after the other.
+     */
+    [[nodiscard]] Duration getSequentialTotal() const;
+
+private:
+    const TimePoint m_start;
+    const std::thread::id m_ownerThread;
+
+    mutable std::mutex m_mutex{};
+    std::vector<Phase> m_phases{};
+    TimePoint m_end{};
+    bool m_finished{false};
+};
+}  // namespace vulk
+
+std::ostream& operator<<(std::ostream& os, const vulk::StartupReport& report);
@@ -0,0 +1,209 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Vulk/ClassUtils.hpp"
+#include "Vulk/RenderCounters.hpp"
+
+namespace vulk {
+class FrameManager;
+
+/**
+ * Unix only: streams telemetry to a local viewer over a Unix domain socket, to observe a running process without
+ * attaching a debugger. One client is served at a time, the next ones wait for it to disconnect.
+ *
+ * The protocol is a sequence of messages, each one a MessageHeader followed by `size` bytes of payload. Payloads
+ * are the structures below, in the machine's byte order. On connection the server sends eHello, then nothing until
+ * the client sends eSubscribe with the streams it wants and how often; later subscriptions replace it.
+ *
+ * Until then, and once the client is gone, publishing a frame is a relaxed atomic load. Samples are serialized on
+ * the frame thread and sent by a background thread; they are dropped, and counted, if the client can't keep up.
+ */
+class TelemetryServer
+{
+public:
+    static constexpr uint32_t s_protocolVersion{1};
+    static constexpr size_t s_maxPendingBytes{1u << 20};
+
+    enum class MessageType : uint32_t
+    {
+        eHello,  // Hello
+        eSubscribe,  // Subscription, from the client
+        eFrame,  // FrameSample
+        eCounters,  // CountersSample
+        eMemory,  // MemorySample
+        eZones  // ZonesSample, then `count` times a ZoneSample followed by its name
+    };
+
+    enum class Stream : uint32_t
+    {
+        eFrame = 1u << 0,
+        eCounters = 1u << 1,
+        eMemory = 1u << 2,  // With VULK_TRACK_ALLOCATIONS
+        eZones = 1u << 3  // With VULK_WITH_SCOPED_PROFILER
+    };
+
+    struct MessageHeader
+    {
+        MessageType type{};
+        uint32_t size{0};
+    };
+
+    struct Hello
+    {
+        uint32_t version{s_protocolVersion};
+        uint32_t processId{0};
+        uint32_t availableStreams{0};
+        uint32_t counterCount{RenderCounters::s_count};
+    };
+
+    struct Subscription
+    {
+        uint32_t streams{0};  // Stream mask, zero stops sampling
+        uint32_t period{1};  // In frames
+    };
+
+    /**
+     * Durations in seconds, over the window of FrameStatistics.
+     */
+    struct FrameSample
+    {
+        uint64_t frame{0};  // Counted since the server started
+        uint32_t framerate{0};
+        uint32_t overBudget{0};
+        uint32_t frameCount{0};
+        float deltaTime{0.0f};
+        float mean{0.0f};
+        float p50{0.0f};
+        float p95{0.0f};
+        float p99{0.0f};
+        float max{0.0f};
+        float jitter{0.0f};
+    };
+
+    struct CountersSample
+    {
+        uint64_t frame{0};
+        std::array<uint64_t, RenderCounters::s_count> values{};  // Indexed by RenderCounter
+    };
+
+    struct MemorySample
+    {
+        uint64_t frame{0};
+        uint64_t allocations{0};  // Heap, during the last frame
+        uint64_t deallocations{0};
+        uint64_t bytes{0};
+    };
+
+    struct ZonesSample
+    {
+        uint64_t frame{0};
+        uint32_t count{0};
+        uint32_t reserved{0};
+    };
+
+    /**
+     * A node of the profiler's call tree, averaged per frame.
+     */
+    struct ZoneSample
+    {
+        static constexpr uint32_t s_noParent{UINT32_MAX};
+
+        uint32_t parent{s_noParent};
+        uint32_t depth{0};
+        float calls{0.0f};
+        float total{0.0f};  // Milliseconds
+        float self{0.0f};
+        uint32_t nameLength{0};
+    };
+
+    /**
+     * Replaces any file at `socketPath`, e.g. left by a previous run. Throws IOException if listening fails.
+     */
+    explicit TelemetryServer(std::string socketPath);
+
+    /**
+     * Disconnects the client and removes the socket file.
+     */
+    ~TelemetryServer();
+
+    VULK_NO_MOVE_OR_COPY(TelemetryServer)
+
+    /**
+     * From the frame thread, once per frame. Doesn't allocate, except to sample the eZones stream.
+     */
+    void publish(const FrameManager& frameManager);
+
+    [[nodiscard]] bool hasClient() const noexcept { return m_connected.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t getDroppedSampleCount() const noexcept { return m_droppedSamples.load(); }
+
+    [[nodiscard]] static uint32_t getAvailableStreams() noexcept;
+
+private:
+    void run();
+
+    void acceptClient();
+    void disconnect() noexcept;
+
+    /**
+     * False when the client is gone or broke the protocol.
+     */
+    bool receive();
+
+    /**
+     * Sends what the socket accepts without blocking. False when the client is gone.
+     */
+    bool sendPending() noexcept;
+
+    /**
+     * With m_pendingMutex locked. `extraSize` bytes are expected to be appended right after the payload.
+     */
+    template<typename Payload>
+    void appendMessage(MessageType type, const Payload& payload, size_t extraSize = 0);
+    void append(const void* data, size_t size);
+
+    const std::string m_socketPath;
+    int m_listenFd{-1};
+    int m_clientFd{-1};  // Server thread only, like the buffers below
+    std::vector<char> m_received{};
+    std::vector<char> m_sending{};  // Swapped with m_pending once fully sent
+    size_t m_sentSize{0};
+
+    std::atomic<uint32_t> m_streams{0};
+    std::atomic<uint32_t> m_period{1};
+    std::atomic<bool> m_connected{false};
+    uint64_t m_frame{0};  // Frame thread only
+
+    std::mutex m_pendingMutex{};
+    std::vector<char> m_pending{};
+    std::atomic<uint64_t> m_droppedSamples{0};
+
+    std::atomic<bool> m_running{true};
+    std::thread m_thread{};
+};
+}  // namespace vulk
@@ -0,0 +1,85 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "Vulk/ClassUtils.hpp"
+
+namespace vulk {
+/**
+ * One `Accumulator` per thread, only written by its thread, and a way to fold all of them from any thread. There is
+ * one registry per `Accumulator` type, each user is expected to have its own.
+ *
+ * Accumulators outlive their thread, what is added just before it exits still makes it to the next fold. They are
+ * leaked, like the registry, so that accumulating keeps working from static destructors.
+ */
+template<typename Accumulator>
+class ThreadAccumulators final
+{
+public:
+    VULK_NO_MOVE_OR_COPY(ThreadAccumulators)
+
+    /**
+     * Of the calling thread, registered by its first call.
+     */
+    [[nodiscard]] static Accumulator& getLocal()
+    {
+        thread_local Accumulator* accumulator = getRegistry().add();
+        return *accumulator;
+    }
+
+    /**
+     * Calls `visitor(Accumulator&)` on the accumulator of every thread that ever had one, under a lock.
+     */
+    template<typename Visitor>
+    static void forEach(Visitor&& visitor)
+    {
+        ThreadAccumulators& registry = getRegistry();
+        const std::scoped_lock lock{registry.m_mutex};
+
+        for (Accumulator* accumulator : registry.m_accumulators)
+            visitor(*accumulator);
+    }
+
+private:
+    ThreadAccumulators() = default;
+
+    static ThreadAccumulators& getRegistry()
+    {
+        static auto* registry = new ThreadAccumulators{};
+        return *registry;
+    }
+
+    Accumulator* add()
+    {
+        auto* accumulator = new Accumulator{};
+
+        const std::scoped_lock lock{m_mutex};
+        m_accumulators.push_back(accumulator);
+
+        return accumulator;
+    }
+
+    std::mutex m_mutex{};
+    std::vector<Accumulator*> m_accumulators{};
+};
+}  // namespace vulk
@@ -0,0 +1,85 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Vulk/ClassUtils.hpp"
+
+namespace vulk {
+/**
+ * Fixed set of worker threads running jobs in submission order.
+ *
+ * Exceptions escaping a job are reported on the standard error and don't stop the worker.
+ */
+class ThreadPool
+{
+public:
+    using Job = std::function<void()>;
+
+    explicit ThreadPool(size_t threadCount = getDefaultThreadCount());
+
+    /**
+     * Runs the jobs still queued, then joins the workers.
+     */
+    ~ThreadPool();
+
+    VULK_NO_MOVE_OR_COPY(ThreadPool)
+
+    void submit(Job job);
+
+    /**
+     * Same as submit(), the returned future rethrows the exception escaping the job, if any, instead of it being
+     * reported. Waiting on it from a job of this pool may deadlock.
+     */
+    [[nodiscard]] std::future<void> async(Job job);
+
+    /**
+     * Blocks until the queue is empty and no job is running.
+     */
+    void waitIdle();
+
+    [[nodiscard]] size_t getThreadCount() const noexcept { return m_threads.size(); }
+
+    /**
+     * One thread per hardware thread, minus the one submitting (usually the render thread).
+     */
+    [[nodiscard]] static size_t getDefaultThreadCount() noexcept;
+
+private:
+    void run();
+
+    std::mutex m_mutex{};
+    std::condition_variable m_jobAvailable{};
+    std::condition_variable m_idle{};
+    std::deque<Job> m_jobs{};
+    size_t m_runningJobs{0};
+    bool m_stopping{false};
+
+    std::vector<std::thread> m_threads{};
+};
+}  // namespace vulk
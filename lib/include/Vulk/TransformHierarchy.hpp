@@ -0,0 +1,105 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace vulk {
+/**
+ * Scene graph transforms stored as structure of arrays, sorted depth first so every parent comes before its
+ * children and every subtree is a contiguous range.
+ *
+ * Only the subtrees of nodes whose local transform changed are recomputed by update(), which also reports the
+ * ranges of world transforms that changed so only those are uploaded. A static scene costs nothing per frame.
+ *
+ * Nodes are referred to by stable handles, their position in the arrays (getIndex()) changes when nodes are
+ * created or destroyed before them.
+ */
+class TransformHierarchy
+{
+public:
+    using NodeHandle = uint32_t;
+
+    static constexpr NodeHandle INVALID_NODE = ~0u;
+
+    struct Range
+    {
+        uint32_t first{};
+        uint32_t count{};
+    };
+
+    /**
+     * Adds the node as the last child of `parent`, or as a root. Appending nodes in depth first order, as when
+     * loading a scene, is constant time.
+     */
+    NodeHandle createNode(NodeHandle parent = INVALID_NODE, const glm::mat4& localTransform = glm::mat4{1.f});
+
+    /**
+     * Destroys the node and its whole subtree.
+     */
+    void destroyNode(NodeHandle node);
+
+    void setLocalTransform(NodeHandle node, const glm::mat4& localTransform);
+
+    [[nodiscard]] const glm::mat4& getLocalTransform(NodeHandle node) const;
+    [[nodiscard]] const glm::mat4& getWorldTransform(NodeHandle node) const;
+
+    [[nodiscard]] uint32_t getIndex(NodeHandle node) const;
+    [[nodiscard]] uint32_t getNodeCount() const noexcept { return static_cast<uint32_t>(m_handles.size()); }
+
+    /**
+     * World transforms by index, up to date after update().
+     */
+    [[nodiscard]] std::span<const glm::mat4> getWorldTransforms() const noexcept { return m_worldTransforms; }
+
+    /**
+     * Recomputes the world transforms of dirty subtrees.
+     *
+     * @return the sorted, non overlapping index ranges whose world transform changed since the last update,
+     * including the ones moved by structural changes
+     */
+    std::span<const Range> update();
+
+private:
+    void markDirty(uint32_t index);
+    void markMovedFrom(uint32_t index) noexcept;
+
+    // SoA storage, by index
+    std::vector<glm::mat4> m_localTransforms{};
+    std::vector<glm::mat4> m_worldTransforms{};
+    std::vector<uint32_t> m_parents{};
+    std::vector<uint32_t> m_subtreeEnds{};  // one past the last descendant
+    std::vector<NodeHandle> m_handles{};
+    std::vector<uint8_t> m_dirtyFlags{};
+
+    // By handle
+    std::vector<uint32_t> m_indices{};
+    std::vector<NodeHandle> m_freeHandles{};
+
+    std::vector<NodeHandle> m_dirtyNodes{};
+    uint32_t m_movedFrom{0};  // every index from here on moved since the last update
+    std::vector<Range> m_changedRanges{};
+    std::vector<uint32_t> m_dirtyIndices{};  // update() scratch, kept to reuse its capacity
+};
+}  // namespace vulk
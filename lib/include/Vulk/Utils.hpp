@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
 #include <vector>
 
 namespace vulk::utils {
@@ -26,4 +29,18 @@ template<typename T, typename Allocator>
 }
 
 std::vector<char> fileToBinary(const char* filePath);
+
+/**
+ * 64 bit FNV-1a, chain calls by passing the previous result as `hash`. Fast but not cryptographic, meant for keys.
+ */
+[[nodiscard]] constexpr uint64_t hashFnv1a(std::string_view data, uint64_t hash = 0xcbf29ce484222325) noexcept
+{
+    for (const char c : data)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3;
+    }
+
+    return hash;
+}
 }  // namespace vulk::utils
@@ -0,0 +1,99 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+/**
+ * Include this instead of <vulkan/vulkan.hpp>.
+ *
+ * With VULK_ACCOUNT_VULKAN_CALLS, the vk::Device and vk::Queue methods called without an explicit dispatcher go
+ * through AccountingDispatcher instead of the static one, which accounts the entry points listed in VulkanCall (see
+ * VulkanCallStats) and forwards everything else untouched. Call sites don't change, and nothing is added otherwise.
+ */
+#if VULK_ACCOUNT_VULKAN_CALLS
+namespace vulk {
+class AccountingDispatcher;
+
+inline const AccountingDispatcher& getAccountingDispatcher() noexcept;
+}  // namespace vulk
+
+    #define VULKAN_HPP_DEFAULT_DISPATCHER_TYPE ::vulk::AccountingDispatcher
+    #define VULKAN_HPP_DEFAULT_DISPATCHER      ::vulk::getAccountingDispatcher()
+#endif
+
+#include <vulkan/vulkan.hpp>
+
+#if VULK_ACCOUNT_VULKAN_CALLS
+    #include "Vulk/VulkanCalls.hpp"
+
+// Hides the command of the static dispatcher, vulkan.hpp calls it with the exact C types
+    #define VULK_ACCOUNTED_COMMAND(call, command)          \
+        template<typename... Args>                         \
+        auto command(Args... args) const noexcept          \
+        {                                                  \
+            const VulkanCallScope scope{VulkanCall::call}; \
+            return ::command(args...);                     \
+        }
+
+namespace vulk {
+class AccountingDispatcher : public vk::DispatchLoaderStatic
+{
+public:
+    VULK_ACCOUNTED_COMMAND(eAllocateMemory, vkAllocateMemory)
+    VULK_ACCOUNTED_COMMAND(eFreeMemory, vkFreeMemory)
+    VULK_ACCOUNTED_COMMAND(eMapMemory, vkMapMemory)
+    VULK_ACCOUNTED_COMMAND(eUnmapMemory, vkUnmapMemory)
+    VULK_ACCOUNTED_COMMAND(eBindBufferMemory, vkBindBufferMemory)
+    VULK_ACCOUNTED_COMMAND(eCreateBuffer, vkCreateBuffer)
+    VULK_ACCOUNTED_COMMAND(eDestroyBuffer, vkDestroyBuffer)
+    VULK_ACCOUNTED_COMMAND(eCreateImageView, vkCreateImageView)
+    VULK_ACCOUNTED_COMMAND(eCreateFramebuffer, vkCreateFramebuffer)
+    VULK_ACCOUNTED_COMMAND(eCreateRenderPass, vkCreateRenderPass)
+    VULK_ACCOUNTED_COMMAND(eCreateShaderModule, vkCreateShaderModule)
+    VULK_ACCOUNTED_COMMAND(eCreatePipelineLayout, vkCreatePipelineLayout)
+    VULK_ACCOUNTED_COMMAND(eCreateDescriptorSetLayout, vkCreateDescriptorSetLayout)
+    VULK_ACCOUNTED_COMMAND(eCreateGraphicsPipelines, vkCreateGraphicsPipelines)
+    VULK_ACCOUNTED_COMMAND(eCreateComputePipelines, vkCreateComputePipelines)
+    VULK_ACCOUNTED_COMMAND(eDestroyPipeline, vkDestroyPipeline)
+    VULK_ACCOUNTED_COMMAND(eCreateDescriptorPool, vkCreateDescriptorPool)
+    VULK_ACCOUNTED_COMMAND(eAllocateDescriptorSets, vkAllocateDescriptorSets)
+    VULK_ACCOUNTED_COMMAND(eUpdateDescriptorSets, vkUpdateDescriptorSets)
+    VULK_ACCOUNTED_COMMAND(eAllocateCommandBuffers, vkAllocateCommandBuffers)
+    VULK_ACCOUNTED_COMMAND(eFreeCommandBuffers, vkFreeCommandBuffers)
+    VULK_ACCOUNTED_COMMAND(eCreateSwapchain, vkCreateSwapchainKHR)
+    VULK_ACCOUNTED_COMMAND(eAcquireNextImage, vkAcquireNextImageKHR)
+    VULK_ACCOUNTED_COMMAND(eWaitForFences, vkWaitForFences)
+    VULK_ACCOUNTED_COMMAND(eResetFences, vkResetFences)
+    VULK_ACCOUNTED_COMMAND(eGetFenceStatus, vkGetFenceStatus)
+    VULK_ACCOUNTED_COMMAND(eGetQueryPoolResults, vkGetQueryPoolResults)
+    VULK_ACCOUNTED_COMMAND(eDeviceWaitIdle, vkDeviceWaitIdle)
+    VULK_ACCOUNTED_COMMAND(eQueueSubmit, vkQueueSubmit)
+    VULK_ACCOUNTED_COMMAND(eQueuePresent, vkQueuePresentKHR)
+    VULK_ACCOUNTED_COMMAND(eQueueWaitIdle, vkQueueWaitIdle)
+};
+
+inline const AccountingDispatcher& getAccountingDispatcher() noexcept
+{
+    static const AccountingDispatcher dispatcher{};
+    return dispatcher;
+}
+}  // namespace vulk
+
+    #undef VULK_ACCOUNTED_COMMAND
+#endif
@@ -0,0 +1,142 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "Vulk/ClassUtils.hpp"
+#include "Vulk/Time.hpp"
+
+namespace vulk {
+/**
+ * The device and queue entry points accounted with VULK_ACCOUNT_VULKAN_CALLS, see Vulk/Vulkan.hpp.
+ */
+enum class VulkanCall : size_t
+{
+    eAllocateMemory,
+    eFreeMemory,
+    eMapMemory,
+    eUnmapMemory,
+    eBindBufferMemory,
+    eCreateBuffer,
+    eDestroyBuffer,
+    eCreateImageView,
+    eCreateFramebuffer,
+    eCreateRenderPass,
+    eCreateShaderModule,
+    eCreatePipelineLayout,
+    eCreateDescriptorSetLayout,
+    eCreateGraphicsPipelines,
+    eCreateComputePipelines,
+    eDestroyPipeline,
+    eCreateDescriptorPool,
+    eAllocateDescriptorSets,
+    eUpdateDescriptorSets,
+    eAllocateCommandBuffers,
+    eFreeCommandBuffers,
+    eCreateSwapchain,
+    eAcquireNextImage,
+    eWaitForFences,
+    eResetFences,
+    eGetFenceStatus,
+    eGetQueryPoolResults,
+    eDeviceWaitIdle,
+    eQueueSubmit,
+    eQueuePresent,
+    eQueueWaitIdle,
+    eCount
+};
+
+/**
+ * How many times each entry point was called and how long it took, usually over a frame.
+ */
+class VulkanCallStats
+{
+public:
+    static constexpr size_t s_count{static_cast<size_t>(VulkanCall::eCount)};
+
+    struct Entry
+    {
+        uint64_t count{0};
+        uint64_t nanoseconds{0};
+
+        [[nodiscard]] Duration getTime() const noexcept { return Duration{static_cast<float>(nanoseconds) * 1e-9f}; }
+
+        [[nodiscard]] bool operator==(const Entry& other) const noexcept = default;
+    };
+
+    [[nodiscard]] const Entry& operator[](VulkanCall call) const noexcept
+    {
+        return m_entries[static_cast<size_t>(call)];
+    }
+
+    [[nodiscard]] Entry& operator[](VulkanCall call) noexcept { return m_entries[static_cast<size_t>(call)]; }
+
+    VulkanCallStats& operator+=(const VulkanCallStats& other) noexcept;
+
+    [[nodiscard]] bool operator==(const VulkanCallStats& other) const noexcept = default;
+
+    [[nodiscard]] Entry getTotal() const noexcept;
+
+    /**
+     * The Vulkan command, e.g. "vkCreateBuffer".
+     */
+    [[nodiscard]] static const char* getName(VulkanCall call) noexcept;
+
+private:
+    std::array<Entry, s_count> m_entries{};
+};
+
+/**
+ * Like RenderCounters, every thread adds to its own accumulator and fold() sums and resets them once per frame.
+ */
+namespace accounting {
+void add(VulkanCall call, uint64_t nanoseconds) noexcept;
+
+/**
+ * What every thread called since the previous fold(). Empty without VULK_ACCOUNT_VULKAN_CALLS.
+ */
+[[nodiscard]] VulkanCallStats fold();
+}  // namespace accounting
+
+/**
+ * Accounts the call made during its lifetime, which is also recorded as a profiler zone of the eVulkan category.
+ */
+class VulkanCallScope final
+{
+public:
+    explicit VulkanCallScope(VulkanCall call) noexcept;
+    ~VulkanCallScope();
+
+    VULK_NO_MOVE_OR_COPY(VulkanCallScope)
+
+private:
+    VulkanCall m_call;
+    int64_t m_begin;  // Profiler ticks
+};
+}  // namespace vulk
+
+/**
+ * Only the entry points called, most expensive first.
+ */
+std::ostream& operator<<(std::ostream& os, const vulk::VulkanCallStats& stats);
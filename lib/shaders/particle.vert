@@ -0,0 +1,53 @@
+#version 450
+
+layout(binding = 0) uniform UBO {
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+struct Particle {
+    vec4 positionLife;      // xyz: position, w: remaining life
+    vec4 velocityLifetime;  // xyz: velocity, w: total lifetime
+    vec4 color;
+};
+
+layout(std430, binding = 1) readonly buffer Particles {
+    Particle particles[];
+};
+
+layout(std430, binding = 3) readonly buffer AliveList {
+    uint aliveIndices[];
+};
+
+layout(push_constant) uniform Emitter {
+    vec4 position;
+    vec4 velocity;
+    vec4 color;
+    vec4 gravityDelta;
+    uint emitCount;
+    uint seed;
+    uint capacity;
+    float lifetime;
+    float size;
+} emitter;
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragOffset;
+
+const vec2 corners[6] = vec2[](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0),  //
+                               vec2(1.0, 1.0), vec2(-1.0, 1.0), vec2(-1.0, -1.0));
+
+void main()
+{
+    Particle particle = particles[aliveIndices[gl_InstanceIndex]];
+    vec2 corner = corners[gl_VertexIndex];
+
+    // Camera-facing quad: expand the corner in view space
+    vec4 viewPosition = ubo.view * vec4(particle.positionLife.xyz, 1.0);
+    viewPosition.xy += corner * emitter.size;
+    gl_Position = ubo.proj * viewPosition;
+
+    float fade = clamp(particle.positionLife.w / particle.velocityLifetime.w, 0.0, 1.0);
+    fragColor = vec4(particle.color.rgb, particle.color.a * fade);
+    fragOffset = corner;
+}
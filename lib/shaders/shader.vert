@@ -1,11 +1,15 @@
 #version 450
 
 layout(binding = 0) uniform UBO {
-    mat4 model;
     mat4 view;
     mat4 proj;
 } ubo;
 
+// World transforms of the scene nodes, the draw's first instance is the node index
+layout(std430, binding = 1) readonly buffer Transforms {
+    mat4 transforms[];
+};
+
 layout(location = 0) in vec2 inPosition;
 layout(location = 1) in vec3 inColor;
 
@@ -13,6 +17,6 @@ layout(location = 0) out vec3 fragColor;
 
 void main()
 {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 0.0, 1.0);
+    gl_Position = ubo.proj * ubo.view * transforms[gl_InstanceIndex] * vec4(inPosition, 0.0, 1.0);
     fragColor = inColor;
 }
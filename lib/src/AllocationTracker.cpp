@@ -0,0 +1,331 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/AllocationTracker.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if __has_include(<execinfo.h>)
+    #include <execinfo.h>
+    #define VULK_HAS_EXECINFO 1
+#else
+    #define VULK_HAS_EXECINFO 0
+#endif
+
+vulk::AllocationTracker vulk::AllocationTracker::s_instance{};
+thread_local uint32_t vulk::AllocationTracker::s_threadId{0};
+thread_local uint32_t vulk::AllocationTracker::s_steadyStateDepth{0};
+
+vulk::AllocationTracker& vulk::AllocationTracker::getInstance() noexcept
+{
+    return s_instance;
+}
+
+void vulk::AllocationTracker::onAllocate(size_t size) noexcept
+{
+    ThreadSlot& slot = getThreadSlot();
+    slot.allocations.fetch_add(1, std::memory_order_relaxed);
+    slot.bytes.fetch_add(size, std::memory_order_relaxed);
+
+    const bool steadyStateViolation =
+      s_steadyStateDepth > 0 && getFrameCount() >= m_steadyStateFrame.load(std::memory_order_relaxed);
+
+    if (steadyStateViolation || size >= getOutlierSize())
+        recordOutlier(size, steadyStateViolation);
+}
+
+void vulk::AllocationTracker::onDeallocate() noexcept
+{
+    getThreadSlot().deallocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32_t vulk::AllocationTracker::getCurrentThreadId() noexcept
+{
+    static_cast<void>(getThreadSlot());
+    return s_threadId - 1;
+}
+
+void vulk::AllocationTracker::markFrame()
+{
+    const std::scoped_lock lock{m_countsMutex};
+
+    for (size_t i = 0; i < s_maxThreads; ++i)
+    {
+        ThreadSlot& slot = m_threadSlots[i];
+        Counts& counts = m_lastFrameCounts[i];
+
+        counts.allocations = slot.allocations.exchange(0, std::memory_order_relaxed);
+        counts.deallocations = slot.deallocations.exchange(0, std::memory_order_relaxed);
+        counts.bytes = slot.bytes.exchange(0, std::memory_order_relaxed);
+
+        m_totalCounts.allocations += counts.allocations;
+        m_totalCounts.deallocations += counts.deallocations;
+        m_totalCounts.bytes += counts.bytes;
+    }
+
+    m_frame.fetch_add(1, std::memory_order_relaxed);
+}
+
+vulk::AllocationTracker::Counts vulk::AllocationTracker::getLastFrameCounts() const
+{
+    const std::scoped_lock lock{m_countsMutex};
+
+    Counts total{};
+
+    for (const Counts& counts : m_lastFrameCounts)
+    {
+        total.allocations += counts.allocations;
+        total.deallocations += counts.deallocations;
+        total.bytes += counts.bytes;
+    }
+
+    return total;
+}
+
+std::vector<vulk::AllocationTracker::ThreadCounts> vulk::AllocationTracker::getLastFrameThreadCounts() const
+{
+    std::vector<ThreadCounts> threadCounts{};
+    threadCounts.reserve(s_maxThreads);
+
+    const std::scoped_lock lock{m_countsMutex};
+
+    for (size_t i = 0; i < s_maxThreads; ++i)
+    {
+        const Counts& counts = m_lastFrameCounts[i];
+
+        if (counts.allocations > 0 || counts.deallocations > 0)
+            threadCounts.push_back({static_cast<uint32_t>(i), counts});
+    }
+
+    return threadCounts;
+}
+
+vulk::AllocationTracker::Counts vulk::AllocationTracker::getTotalCounts() const
+{
+    const std::scoped_lock lock{m_countsMutex};
+    return m_totalCounts;
+}
+
+std::vector<vulk::AllocationTracker::Outlier> vulk::AllocationTracker::getOutliers() const
+{
+    // Reserved before locking, allocating a large outlier would record it under the same lock
+    std::vector<Outlier> outliers{};
+    outliers.reserve(s_maxOutliers);
+
+    const std::scoped_lock lock{m_outliersMutex};
+    outliers.insert(outliers.end(), m_outliers.begin(), m_outliers.begin() + static_cast<ptrdiff_t>(m_outlierCount));
+
+    return outliers;
+}
+
+void vulk::AllocationTracker::clearOutliers()
+{
+    const std::scoped_lock lock{m_outliersMutex};
+
+    m_outlierCount = 0;
+    m_droppedOutliers = 0;
+}
+
+void vulk::AllocationTracker::writeOutliers(std::ostream& os) const
+{
+    for (const Outlier& outlier : getOutliers())
+    {
+        os << (outlier.steadyStateViolation ? "Steady state allocation" : "Allocation") << " of " << outlier.size
+           << " bytes, frame " << outlier.frame << ", thread " << outlier.threadId << '\n';
+
+#if VULK_HAS_EXECINFO
+        const auto depth = static_cast<int>(outlier.callStackDepth);
+        char** symbols = backtrace_symbols(outlier.callStack.data(), depth);
+
+        for (int i = 0; i < depth; ++i)
+            os << "    " << (symbols ? symbols[i] : "?") << '\n';
+
+        std::free(symbols);
+#endif
+    }
+
+    if (const uint64_t dropped = getDroppedOutlierCount(); dropped > 0)
+        os << dropped << " more outliers not kept\n";
+}
+
+void vulk::AllocationTracker::enableSteadyStateCheck(uint32_t warmUpFrames, bool abortOnViolation) noexcept
+{
+    m_abortOnViolation = abortOnViolation;
+    m_steadyStateFrame = getFrameCount() + warmUpFrames;
+}
+
+void vulk::AllocationTracker::disableSteadyStateCheck() noexcept
+{
+    m_steadyStateFrame = s_checkDisabled;
+}
+
+vulk::AllocationTracker::ThreadSlot& vulk::AllocationTracker::getThreadSlot() noexcept
+{
+    if (s_threadId == 0)
+    {
+        const uint32_t index = m_threadCount.fetch_add(1, std::memory_order_relaxed);
+        s_threadId = std::min(index, static_cast<uint32_t>(s_maxThreads - 1)) + 1;
+    }
+
+    return m_threadSlots[s_threadId - 1];
+}
+
+void vulk::AllocationTracker::recordOutlier(size_t size, bool steadyStateViolation) noexcept
+{
+    // Neither capturing the call stack nor storing it goes through operator new
+    Outlier outlier{};
+    outlier.frame = getFrameCount();
+    outlier.threadId = s_threadId - 1;
+    outlier.size = size;
+    outlier.steadyStateViolation = steadyStateViolation;
+
+#if VULK_HAS_EXECINFO
+    outlier.callStackDepth =
+      static_cast<uint32_t>(backtrace(outlier.callStack.data(), static_cast<int>(s_maxCallStackDepth)));
+#endif
+
+    if (steadyStateViolation)
+    {
+        ++m_violations;
+
+        if (m_abortOnViolation)
+        {
+            std::fprintf(stderr, "Allocation of %zu bytes in the steady state, frame %" PRIu64 ", thread %" PRIu32 "\n",
+                         size, outlier.frame, outlier.threadId);
+#if VULK_HAS_EXECINFO
+            backtrace_symbols_fd(outlier.callStack.data(), static_cast<int>(outlier.callStackDepth), 2);
+#endif
+            std::abort();
+        }
+    }
+
+    {
+        const std::scoped_lock lock{m_outliersMutex};
+
+        if (m_outlierCount < s_maxOutliers)
+        {
+            m_outliers[m_outlierCount++] = outlier;
+            return;
+        }
+    }
+
+    ++m_droppedOutliers;
+}
+
+#if VULK_TRACK_ALLOCATIONS
+
+namespace {
+void* allocate(std::size_t size)
+{
+    vulk::AllocationTracker::getInstance().onAllocate(size);
+
+    // Same as the default operator new
+    if (size == 0)
+        size = 1;
+
+    while (true)
+    {
+        if (void* pointer = std::malloc(size))
+            return pointer;
+
+        const std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc{};
+
+        handler();
+    }
+}
+
+void* allocateNoThrow(std::size_t size) noexcept
+{
+    try
+    {
+        return allocate(size);
+    } catch (const std::bad_alloc&)
+    {
+        return nullptr;
+    }
+}
+
+void deallocate(void* pointer) noexcept
+{
+    if (!pointer)
+        return;
+
+    vulk::AllocationTracker::getInstance().onDeallocate();
+    std::free(pointer);
+}
+}  // namespace
+
+// Over-aligned allocations keep the default operators and aren't counted
+void* operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocateNoThrow(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocateNoThrow(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    deallocate(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    deallocate(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    deallocate(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    deallocate(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    deallocate(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    deallocate(pointer);
+}
+
+#endif
@@ -23,14 +23,24 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <algorithm>
 #include <chrono>
+#include <future>
 #include <iostream>
 #include <set>
+#include <span>
 #include <string_view>
+#include <type_traits>
 
 #include "Vulk/Exceptions.hpp"
+#include "Vulk/MeshLoader.hpp"
+#include "Vulk/ParticleSystem.hpp"
+#include "Vulk/RenderCounters.hpp"
 #include "Vulk/ScopedProfiler.hpp"
 #include "Vulk/Shader.hpp"
+#if VULK_ENABLE_SHADER_HOT_RELOAD
+    #include "Vulk/ShaderWatcher.hpp"
+#endif
 #include "Vulk/Utils.hpp"
 
 const size_t vulk::ContextVulkan::s_maxFramesInFlight{2};
@@ -58,27 +68,76 @@ vulk::ContextVulkan::ContextVulkan(GLFWwindow* windowHandle) : m_windowHandle{wi
     printAvailableValidationLayers();
 #endif
 
-    createInstance();
-    createSurface();
-    pickPhysicalDevice();
-    createLogicalDevice();
-    createSwapChain();
-    createImageViews();
-    createRenderPass();
-    createDescriptorSetLayout();
-    createGraphicsPipeline();
-    createFrameBuffers();
-    createCommandPool();
-    createVertexBuffer();
-    createIndexBuffer();
-    createUniformBuffers();
-    createDescriptorPool();
-    createDescriptorSets();
-    createCommandBuffers();
-    createSyncObject();
+    runStartupPhase("createInstance", [this] { createInstance(); });
+    runStartupPhase("createSurface", [this] { createSurface(); });
+    runStartupPhase("pickPhysicalDevice", [this] { pickPhysicalDevice(); });
+    runStartupPhase("createLogicalDevice", [this] { createLogicalDevice(); });
+
+    m_threadPool = std::make_unique<ThreadPool>();
+    m_layoutCache = std::make_unique<PipelineLayoutCache>(m_device);
+    m_shaderLibrary = std::make_unique<ShaderLibrary>(m_device);
+    m_pipelineRegistry =
+      std::make_unique<PipelineRegistry>(m_device, *m_layoutCache, *m_shaderLibrary, *m_threadPool,
+                                         m_extendedDynamicState ? &m_extensionDispatcher : nullptr);
+
+    // From here on, the work that doesn't depend on each other overlaps on the worker threads. They use this object,
+    // it can only be destroyed by an exception once they are done.
+    try
+    {
+        loadShaders();
+
+        runStartupPhase("createSwapChain", [this] { createSwapChain(); });
+
+        m_presentTimer = std::make_unique<PresentTimer>(m_device, m_presentWait ? &m_extensionDispatcher : nullptr);
+        m_presentTimer->start(m_swapchain);
+
+        runStartupPhase("createImageViews", [this] { createImageViews(); });
+        runStartupPhase("createRenderPass", [this] { createRenderPass(); });
+
+        updatePipelineDescs();
+
+        std::future<void> pipelineBuild = m_threadPool->async([this] {
+            runStartupPhase("buildGraphicsPipeline",
+                            [this] { static_cast<void>(m_pipelineRegistry->getPipeline(m_meshPipelineDesc)); });
+        });
+
+        runStartupPhase("createCommandPool", [this] { createCommandPool(); });
+        runStartupPhase("createTimestampQueries", [this] { createTimestampQueries(); });
+
+        m_sceneRoot = m_transforms.createNode();
+
+        // Nothing else uses the command pool, the graphics queue or the transform hierarchy until it is done
+        std::future<void> meshUpload = m_threadPool->async([this] {
+            runStartupPhase("createDefaultMesh", [this] { createDefaultMesh(); });
+        });
+
+        runStartupPhase("createFrameBuffers", [this] { createFrameBuffers(); });
+        runStartupPhase("createUniformBuffers", [this] { createUniformBuffers(); });
+        runStartupPhase("createSyncObject", [this] { createSyncObject(); });
+
+        runStartupPhase("waitForDefaultMesh", [&meshUpload] { meshUpload.get(); });
+        runStartupPhase("createTransformBuffers", [this] { createTransformBuffers(); });
+        runStartupPhase("createCommandBuffers", [this] { createCommandBuffers(); });
+
+        runStartupPhase("waitForGraphicsPipeline", [&pipelineBuild] { pipelineBuild.get(); });
+        runStartupPhase("createGraphicsPipeline", [this] { createGraphicsPipeline(); });
+        runStartupPhase("createDescriptorPool", [this] { createDescriptorPool(); });
+        runStartupPhase("createDescriptorSets", [this] { createDescriptorSets(); });
+    } catch (...)
+    {
+        m_threadPool->waitIdle();
+        throw;
+    }
+
+#if VULK_ENABLE_SHADER_HOT_RELOAD
+    runStartupPhase("enableShaderHotReload", [this] { enableShaderHotReload(); });
+#endif
+
+    m_startupReport.finish();
 
 #if VULK_DEBUG
     std::cout << "Selected GPU name: " << m_physicalDevice.getProperties().deviceName << std::endl;
+    std::cout << m_startupReport;
 #endif
 }
 
@@ -90,8 +149,18 @@ vulk::ContextVulkan::~ContextVulkan()
 
     if (m_device)
     {
+#if VULK_ENABLE_SHADER_HOT_RELOAD
+        // Joins the watcher thread, which may be building a pipeline
+        m_shaderWatcher.reset();
+        m_device.destroy(m_pendingPipeline.built.pipeline);
+#endif
+
         m_device.waitIdle();
 
+        // Joins the present waiter thread, which uses the swapchain
+        m_presentTimer.reset();
+        m_particleSystem.reset();
+
         cleanupSwapchain(m_swapchain);
 
         for (size_t i = 0; i < s_maxFramesInFlight; ++i)
@@ -100,19 +169,23 @@ vulk::ContextVulkan::~ContextVulkan()
             m_device.freeMemory(m_uniformBuffersMemory[i]);
         }
 
+        for (auto& transformBuffer : m_transformBuffers)
+            transformBuffer.destroy(m_device);
+
         m_device.destroy(m_descriptorPool);
-        m_device.destroy(m_descriptorSetLayout);
+        m_pipelineRegistry.reset();
+        m_shaderLibrary.reset();
+        m_layoutCache.reset();
+        m_threadPool.reset();
 
         for (auto& frameSemaphore : m_frameSyncObjects)
             frameSemaphore.destroy(m_device);
 
         m_device.destroy(m_commandPool);
+        m_device.destroy(m_timestampQueryPool);
 
-        m_device.destroy(m_indexBuffer);
-        m_device.freeMemory(m_indexBufferMemory);
-
-        m_device.destroy(m_vertexBuffer);
-        m_device.freeMemory(m_vertexBufferMemory);
+        for (auto& mesh : m_meshes)
+            mesh.destroy(m_device);
     }
 
     m_instance.destroy(m_surface);
@@ -147,10 +220,16 @@ void vulk::ContextVulkan::cleanupSwapchainSubObjects()
     if (!m_device)
         return;
 
-    m_device.destroy(m_pipeline);
-    m_device.destroy(m_pipelineLayout);
+    // Every registered pipeline is built against the render pass
+    m_pipelineRegistry->clear();
+    m_pipeline = nullptr;
     m_device.destroy(m_renderPass);
 
+    // Only called once the device is idle
+    for (const auto& retired : m_retiredPipelines)
+        m_device.destroy(retired.pipeline);
+    m_retiredPipelines.clear();
+
     for (auto& imageView : m_swapchainImageViews)
         m_device.destroy(imageView);
     m_swapchainImageViews.clear();
@@ -171,6 +250,13 @@ void vulk::ContextVulkan::draw()
 {
     handleVulkanError(m_device.waitForFences(1, &m_frameSyncObjects[m_currentFrame].fence, true, s_noTimeout));
 
+    const TimePoint cpuStart = Clock::now();
+    m_frameWorkload = FrameWorkload{};
+    readGpuTime();
+
+    m_lastPresentId = 0;
+    m_presentTimings = m_presentTimer->update();
+
     const auto& [result, imageIndex] =
       m_device.acquireNextImageKHR(m_swapchain, s_noTimeout, m_frameSyncObjects[m_currentFrame].imageAvailable);
 
@@ -183,7 +269,9 @@ void vulk::ContextVulkan::draw()
         handleVulkanError(result);  // throws
     }
 
+    updatePipelines();
     updateUniformBuffer(static_cast<uint32_t>(m_currentFrame));
+    updateTransformBuffer(static_cast<uint32_t>(m_currentFrame));
     handleVulkanError(m_device.resetFences(1, &m_frameSyncObjects[m_currentFrame].fence));
     m_commandBuffers[m_currentFrame].reset();
     recordCommandBuffer(m_commandBuffers[m_currentFrame], imageIndex);
@@ -203,6 +291,10 @@ void vulk::ContextVulkan::draw()
     submitInfo.pSignalSemaphores = signalSemaphores.data();
 
     handleVulkanError(m_graphicsQueue.submit(1, &submitInfo, m_frameSyncObjects[m_currentFrame].fence));
+    counters::add(RenderCounter::eQueueSubmits);
+
+    // Presenting may block on v-sync, that isn't work
+    m_frameWorkload.cpuTime = Clock::now() - cpuStart;
 
     vk::PresentInfoKHR presentInfo{};
     presentInfo.waitSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
@@ -212,8 +304,24 @@ void vulk::ContextVulkan::draw()
     presentInfo.pImageIndices = &imageIndex;
     // presentInfo.pResults = nullptr; // would be useful if ever adding more swap chains
 
+    const uint64_t presentId = m_nextPresentId++;
+
+    vk::PresentIdKHR presentIdInfo{};
+    if (m_presentWait)
+    {
+        presentIdInfo.swapchainCount = static_cast<uint32_t>(swapChains.size());
+        presentIdInfo.pPresentIds = &presentId;
+        presentInfo.pNext = &presentIdInfo;
+    }
+
     const vk::Result res = m_presentQueue.presentKHR(&presentInfo);
 
+    if (res == vk::Result::eSuccess || res == vk::Result::eSuboptimalKHR)
+    {
+        m_lastPresentId = presentId;
+        m_presentTimer->onPresented(presentId, m_frameSyncObjects[m_currentFrame].fence);
+    }
+
     if (res == vk::Result::eErrorOutOfDateKHR || res == vk::Result::eSuboptimalKHR || m_frameBufferResized)
     {
         m_frameBufferResized = false;
@@ -224,8 +332,89 @@ void vulk::ContextVulkan::draw()
     }
 
     m_currentFrame = (m_currentFrame + 1) % s_maxFramesInFlight;
+    ++m_frameNumber;
+}
+
+void vulk::ContextVulkan::updatePipelines()
+{
+    // A pipeline retired at frame N may still be used by the frames in flight before N
+    std::erase_if(m_retiredPipelines, [this](const RetiredPipeline& retired) {
+        if (m_frameNumber - retired.frameNumber < s_maxFramesInFlight)
+            return false;
+
+        m_device.destroy(retired.pipeline);
+        return true;
+    });
+
+#if VULK_ENABLE_SHADER_HOT_RELOAD
+    // Never wait for a rebuild in progress, it will be picked up next frame
+    const std::unique_lock lock{m_pipelineMutex, std::try_to_lock};
+
+    if (!lock.owns_lock() || !m_pendingPipeline.built.pipeline)
+        return;
+
+    if (m_pendingPipeline.swapchainGeneration == m_swapchainGeneration)
+    {
+        m_pipeline = m_pendingPipeline.built.pipeline;
+
+        const vk::Pipeline previous =
+          m_pipelineRegistry->replacePipeline(m_meshPipelineDesc, std::move(m_pendingPipeline.built));
+        m_retiredPipelines.push_back(RetiredPipeline{previous, m_frameNumber});
+    } else
+    {
+        // Built against a destroyed render pass, the new swapchain pipeline already uses the new SPIR-V
+        m_device.destroy(m_pendingPipeline.built.pipeline);
+    }
+
+    m_pendingPipeline = PendingPipeline{};
+#endif
 }
 
+#if VULK_ENABLE_SHADER_HOT_RELOAD
+void vulk::ContextVulkan::enableShaderHotReload()
+{
+    VULK_SCOPED_PROFILER_CATEGORY("ContextVulkan::enableShaderHotReload()", eShaders);
+
+    m_shaderWatcher = std::make_unique<ShaderWatcher>(VULK_SHADER_SOURCE_DIR, "shaders/vulk");
+
+    // Runs on the watcher thread, the pipeline is only swapped at the next frame boundary
+    const auto rebuildGraphicsPipeline = [this](const std::string& shaderName) {
+        const std::scoped_lock lock{m_pipelineMutex};
+
+        // Pipelines being built keep the previous module until they are done
+        m_shaderLibrary->evict("shaders/vulk/" + shaderName);
+
+        try
+        {
+            PipelineRegistry::Pipeline pipeline = m_pipelineRegistry->buildPipeline(m_meshPipelineDesc);
+
+            try
+            {
+                adoptPipelineLayout(pipeline);
+            } catch (...)
+            {
+                m_device.destroy(pipeline.pipeline);
+                throw;
+            }
+
+            // Replaced before it was ever used
+            m_device.destroy(m_pendingPipeline.built.pipeline);
+            m_pendingPipeline = PendingPipeline{std::move(pipeline), m_swapchainGeneration};
+
+    #if VULK_DEBUG
+            std::cout << "Reloaded " << shaderName << '\n';
+    #endif
+        } catch (const std::exception& e)
+        {
+            std::cerr << "Unable to reload " << shaderName << ": " << e.what() << '\n';
+        }
+    };
+
+    m_shaderWatcher->addListener("shader.vert.spv", rebuildGraphicsPipeline);
+    m_shaderWatcher->addListener("shader.frag.spv", rebuildGraphicsPipeline);
+}
+#endif
+
 [[maybe_unused]] void vulk::ContextVulkan::printAvailableValidationLayers()
 {
     std::cout << "Available Layers:\n";
@@ -368,11 +557,47 @@ void vulk::ContextVulkan::createLogicalDevice()
     createInfo.enabledLayerCount = 0;
 
     // This could be better: here we only use static extensions at compile time, would be better to fetch them dynamically.
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(REQUIRED_EXTENSION_NAMES.size());
-    createInfo.ppEnabledExtensionNames = REQUIRED_EXTENSION_NAMES.data();
+    std::vector<const char*> extensionNames{REQUIRED_EXTENSION_NAMES.begin(), REQUIRED_EXTENSION_NAMES.end()};
+
+    // Optional: pipelines then share the cull mode, front face, topology and depth state as dynamic states
+    m_extendedDynamicState = supportsExtendedDynamicState();
+
+    // Optional: frames are then timed when they reach the screen, see PresentTimer
+    m_presentWait = supportsPresentWait();
+
+    void* featureChain = nullptr;
+
+    vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT extendedDynamicStateFeatures{};
+    if (m_extendedDynamicState)
+    {
+        extensionNames.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
+        extendedDynamicStateFeatures.extendedDynamicState = VK_TRUE;
+        extendedDynamicStateFeatures.pNext = featureChain;
+        featureChain = &extendedDynamicStateFeatures;
+    }
+
+    vk::PhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+    vk::PhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+    if (m_presentWait)
+    {
+        extensionNames.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+        extensionNames.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+        presentIdFeatures.presentId = VK_TRUE;
+        presentIdFeatures.pNext = featureChain;
+        presentWaitFeatures.presentWait = VK_TRUE;
+        presentWaitFeatures.pNext = &presentIdFeatures;
+        featureChain = &presentWaitFeatures;
+    }
+
+    createInfo.pNext = featureChain;
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(extensionNames.size());
+    createInfo.ppEnabledExtensionNames = extensionNames.data();
 
     handleVulkanError(m_physicalDevice.createDevice(&createInfo, nullptr, &m_device));
 
+    if (m_extendedDynamicState || m_presentWait)
+        m_extensionDispatcher.init(m_instance, vkGetInstanceProcAddr, m_device);
+
     m_device.getQueue(m_queueFamilyIndices.graphicsFamily.value(), 0, &m_graphicsQueue);
 
     if (!m_graphicsQueue)
@@ -402,9 +627,20 @@ void vulk::ContextVulkan::recreateSwapChain()
 
     m_device.waitIdle();
 
+    // The old swapchain is destroyed by createSwapChain()
+    m_presentTimer->stop();
+
+#if VULK_ENABLE_SHADER_HOT_RELOAD
+    // Hot reload builds pipelines against the render pass and layout, which are about to be replaced
+    const std::scoped_lock lock{m_pipelineMutex};
+    ++m_swapchainGeneration;
+#endif
+
     cleanupSwapchainSubObjects();
 
     createSwapChain();
+    m_presentTimer->start(m_swapchain);
+
     createImageViews();
     createRenderPass();
     createGraphicsPipeline();
@@ -413,6 +649,9 @@ void vulk::ContextVulkan::recreateSwapChain()
     createDescriptorPool();
     createDescriptorSets();
     createCommandBuffers();
+
+    if (m_particleSystem)
+        m_particleSystem->onSwapchainRecreated();
 }
 
 void vulk::ContextVulkan::createSwapChain()
@@ -542,117 +781,58 @@ void vulk::ContextVulkan::createRenderPass()
     assert(m_renderPass);
 }
 
-void vulk::ContextVulkan::createDescriptorSetLayout()
+void vulk::ContextVulkan::loadShaders()
 {
-    VULK_SCOPED_PROFILER("ContextVulkan::createDescriptorSetLayout()");
+    VULK_SCOPED_PROFILER_CATEGORY("ContextVulkan::loadShaders()", eShaders);
 
-    vk::DescriptorSetLayoutBinding uboLayoutBindings{};
-    uboLayoutBindings.binding = 0;
-    uboLayoutBindings.descriptorType = vk::DescriptorType::eUniformBuffer;
-    uboLayoutBindings.descriptorCount = 1;
-    uboLayoutBindings.stageFlags = vk::ShaderStageFlagBits::eVertex;
+    m_meshPipelineDesc.vertexShader = "shaders/vulk/shader.vert.spv";
+    m_meshPipelineDesc.fragmentShader = "shaders/vulk/shader.frag.spv";
 
-    vk::DescriptorSetLayoutCreateInfo createInfo{};
-    createInfo.bindingCount = 1;
-    createInfo.pBindings = &uboLayoutBindings;
+    for (const std::string& filePath : {m_meshPipelineDesc.vertexShader, m_meshPipelineDesc.fragmentShader})
+    {
+        // Failures are reported again by the pipeline build
+        m_threadPool->submit([this, filePath] {
+            runStartupPhase("loadShader " + filePath,
+                            [this, &filePath] { static_cast<void>(m_shaderLibrary->getModule(filePath)); });
+        });
+    }
+}
 
-    handleVulkanError(m_device.createDescriptorSetLayout(&createInfo, nullptr, &m_descriptorSetLayout));
+void vulk::ContextVulkan::updatePipelineDescs()
+{
+    m_meshPipelineDesc.vertexStride = sizeof(Vertex);
+    m_meshPipelineDesc.renderPass = m_renderPass;
+
+    for (auto& mesh : m_meshes)
+    {
+        if (mesh.pipelineDesc)
+            mesh.pipelineDesc->renderPass = m_renderPass;
+    }
 }
 
 void vulk::ContextVulkan::createGraphicsPipeline()
 {
-    VULK_SCOPED_PROFILER("ContextVulkan::createGraphicsPipeline()");
-
-    Shader vert{m_device, "shaders/vulk/shader.vert.spv", Shader::Type::eVertex};
-    Shader frag{m_device, "shaders/vulk/shader.frag.spv", Shader::Type::eFragment};
-
-    vk::PipelineShaderStageCreateInfo shaderStages[] = {vert.getShaderStageCreateInfo(),
-                                                        frag.getShaderStageCreateInfo()};
-
-    auto bindingDescription = Vertex::getBindingDescription();
-    auto attributeDescriptions = Vertex::getAttributeDescriptions();
-
-    vk::PipelineVertexInputStateCreateInfo vertexInputInfo{};
-    vertexInputInfo.vertexBindingDescriptionCount = 1;
-    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-    vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
-
-    vk::PipelineInputAssemblyStateCreateInfo inputAssembly{};
-    inputAssembly.topology = vk::PrimitiveTopology::eTriangleList;
-    inputAssembly.primitiveRestartEnable = false;
-
-    m_viewport.x = 0;
-    m_viewport.y = 0;
-    m_viewport.width = static_cast<float>(m_extent.width);
-    m_viewport.height = static_cast<float>(m_extent.height);
-    m_viewport.minDepth = 0;
-    m_viewport.maxDepth = 1;
-
-    vk::Rect2D scissor{};
-    scissor.offset = vk::Offset2D{0, 0};
-    scissor.extent = m_extent;
-
-    vk::PipelineViewportStateCreateInfo viewportState{};
-    viewportState.viewportCount = 1;
-    viewportState.pViewports = &m_viewport;
-    viewportState.scissorCount = 1;
-    viewportState.pScissors = &scissor;
-
-    vk::PipelineRasterizationStateCreateInfo rasterizer{};
-    rasterizer.depthClampEnable = false;
-    rasterizer.rasterizerDiscardEnable = false;
-    rasterizer.polygonMode = vk::PolygonMode::eFill;
-    rasterizer.lineWidth = 1;
-    rasterizer.cullMode = vk::CullModeFlagBits::eBack;
-    rasterizer.frontFace = vk::FrontFace::eCounterClockwise;
-    rasterizer.depthBiasEnable = false;
-
-    vk::PipelineMultisampleStateCreateInfo multisampling{};
-    multisampling.sampleShadingEnable = false;
-    multisampling.rasterizationSamples = vk::SampleCountFlagBits::e1;
-
-    vk::PipelineColorBlendAttachmentState colorBlendAttachment{};
-    colorBlendAttachment.colorWriteMask = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
-                                          vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
-    colorBlendAttachment.blendEnable = false;
-
-    vk::PipelineColorBlendStateCreateInfo colorBlending{};
-    colorBlending.attachmentCount = 1;
-    colorBlending.pAttachments = &colorBlendAttachment;
-
-    std::array dynamicStatesArray = {vk::DynamicState::eViewport, vk::DynamicState::eLineWidth};
-    vk::PipelineDynamicStateCreateInfo dynamicState{};
-    dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStatesArray.size());
-    dynamicState.pDynamicStates = dynamicStatesArray.data();
-
-    vk::PipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
-    pipelineLayoutCreateInfo.setLayoutCount = 1;
-    pipelineLayoutCreateInfo.pSetLayouts = &m_descriptorSetLayout;
-
-    handleVulkanError(m_device.createPipelineLayout(&pipelineLayoutCreateInfo, nullptr, &m_pipelineLayout));
-
-    vk::GraphicsPipelineCreateInfo pipelineInfo{};
-    pipelineInfo.stageCount = 2;
-    pipelineInfo.pStages = shaderStages;
-    pipelineInfo.pVertexInputState = &vertexInputInfo;
-    pipelineInfo.pInputAssemblyState = &inputAssembly;
-    pipelineInfo.pViewportState = &viewportState;
-    pipelineInfo.pRasterizationState = &rasterizer;
-    pipelineInfo.pMultisampleState = &multisampling;
-    pipelineInfo.pDepthStencilState = nullptr;
-    pipelineInfo.pColorBlendState = &colorBlending;
-    pipelineInfo.pDynamicState = nullptr;
-    pipelineInfo.layout = m_pipelineLayout;
-    pipelineInfo.renderPass = m_renderPass;
-    pipelineInfo.subpass = 0;
-
-    // Useless now, but will be useful and more efficient when modifying the pipeline
-    // I added it as a reminder :)
-    pipelineInfo.basePipelineHandle = nullptr;
-    pipelineInfo.basePipelineIndex = -1;
-
-    handleVulkanError(m_device.createGraphicsPipelines(nullptr, 1, &pipelineInfo, nullptr, &m_pipeline));
+    VULK_SCOPED_PROFILER_CATEGORY("ContextVulkan::createGraphicsPipeline()", eShaders);
+
+    updatePipelineDescs();
+
+    const PipelineRegistry::Pipeline& pipeline = m_pipelineRegistry->getPipeline(m_meshPipelineDesc);
+    adoptPipelineLayout(pipeline);
+
+    m_pipeline = pipeline.pipeline;
+}
+
+void vulk::ContextVulkan::adoptPipelineLayout(const PipelineRegistry::Pipeline& pipeline)
+{
+    if (!m_pipelineLayout)
+    {
+        m_pipelineLayout = pipeline.layout.pipelineLayout;
+        m_descriptorSetLayout = pipeline.layout.setLayouts.at(0);
+        m_descriptorPoolSizes = pipeline.reflection.getPoolSizes(0, static_cast<uint32_t>(s_maxFramesInFlight));
+    } else if (pipeline.layout.pipelineLayout != m_pipelineLayout)
+    {
+        throw ShaderReflectionException{"The shaders' descriptor interface changed"};
+    }
 }
 
 void vulk::ContextVulkan::createFrameBuffers()
@@ -692,58 +872,152 @@ void vulk::ContextVulkan::createCommandPool()
     handleVulkanError(m_device.createCommandPool(&commandPoolCreateInfo, nullptr, &m_commandPool));
 }
 
-void vulk::ContextVulkan::createVertexBuffer()
+void vulk::ContextVulkan::createDefaultMesh()
 {
-    static constexpr vk::DeviceSize BufferSize = sizeof(decltype(s_vertices)::value_type) * s_vertices.size();
+    VULK_SCOPED_PROFILER_CATEGORY("ContextVulkan::createDefaultMesh()", eLoading);
+
+    createMesh<decltype(s_indices)::value_type>(
+      static_cast<uint32_t>(s_vertices.size()), static_cast<uint32_t>(s_indices.size()),
+      mesh::OptimizationOptions{.enabled = false}, [](Vertex* vertices, auto* indices) {
+          std::copy(s_vertices.cbegin(), s_vertices.cend(), vertices);
+          std::copy(s_indices.cbegin(), s_indices.cend(), indices);
+      });
+}
 
-    vk::Buffer stagingBuffer;
-    vk::DeviceMemory stagingBufferMemory;
+vulk::ContextVulkan::MeshHandle vulk::ContextVulkan::loadMesh(const char* filePath,
+                                                              const mesh::OptimizationOptions& optimization)
+{
+    VULK_SCOPED_PROFILER_CATEGORY("ContextVulkan::loadMesh()", eLoading);
 
-    createBuffer(BufferSize, vk::BufferUsageFlagBits::eTransferSrc,
-                 vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, stagingBuffer,
-                 stagingBufferMemory);
+    const MeshLoader loader{filePath};
 
-    void* data;
-    handleVulkanError(m_device.mapMemory(stagingBufferMemory, 0, BufferSize, {}, &data));
-    std::memcpy(data, s_vertices.data(), BufferSize);
-    m_device.unmapMemory(stagingBufferMemory);
+    if (loader.getIndexCount() == 0)
+        throw InvalidFormatException(std::string{filePath} + ": mesh has no triangles");
 
-    createBuffer(BufferSize, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
-                 vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, m_vertexBuffer,
-                 m_vertexBufferMemory);
+    const auto write = [&loader](Vertex* vertices, auto* indices) { loader.write(vertices, indices); };
 
-    copyBuffer(stagingBuffer, m_vertexBuffer, BufferSize);
+    if (loader.needsUint32Indices())
+        return createMesh<uint32_t>(loader.getVertexCount(), loader.getIndexCount(), optimization, write);
 
-    // TODO: vk::raii
-    m_device.destroy(stagingBuffer);
-    m_device.freeMemory(stagingBufferMemory);
+    return createMesh<uint16_t>(loader.getVertexCount(), loader.getIndexCount(), optimization, write);
 }
 
-void vulk::ContextVulkan::createIndexBuffer()
+void vulk::ContextVulkan::setMeshPipeline(MeshHandle mesh, PipelineDesc desc)
 {
-    static constexpr vk::DeviceSize BufferSize = sizeof(decltype(s_indices)::value_type) * s_indices.size();
+    // Bound with the default pipeline's descriptor sets
+    desc.vertexStride = sizeof(Vertex);
+    desc.layout = m_pipelineLayout;
+    desc.renderPass = m_renderPass;
+
+    // Only sorts draws by pipeline, collisions merely interleave them; 0 stays the default pipeline's
+    constexpr uint64_t MaxPipelineId = (1u << DrawQueue::PIPELINE_BITS) - 1;
+    m_meshes[mesh].pipelineId = static_cast<uint32_t>(m_pipelineRegistry->getPipelineHash(desc) % MaxPipelineId) + 1;
+
+    // Starts compiling right away
+    m_pipelineRegistry->requestPipeline(desc);
+
+    m_meshes[mesh].pipelineDesc = std::move(desc);
+}
+
+template<typename IndexType, typename Writer>
+vulk::ContextVulkan::MeshHandle vulk::ContextVulkan::createMesh(uint32_t vertexCount, uint32_t indexCount,
+                                                                const mesh::OptimizationOptions& optimization,
+                                                                Writer&& writer)
+{
+    VULK_SCOPED_PROFILER_CATEGORY("ContextVulkan::createMesh()", eLoading);
+
+    // Indices follow the vertices in the staging buffer, they need to stay aligned
+    static_assert(sizeof(Vertex) % sizeof(uint32_t) == 0);
+
+    const vk::DeviceSize verticesSize = sizeof(Vertex) * vertexCount;
+    const vk::DeviceSize indicesSize = sizeof(IndexType) * indexCount;
+
+    // The optimizer reads the staging memory back, which is very slow when it is write-combined
+    vk::MemoryPropertyFlags preferredStagingProperties{};
+
+    if (optimization.enabled)
+        preferredStagingProperties = vk::MemoryPropertyFlagBits::eHostCached;
 
     vk::Buffer stagingBuffer;
     vk::DeviceMemory stagingBufferMemory;
 
-    createBuffer(BufferSize, vk::BufferUsageFlagBits::eTransferSrc,
+    createBuffer(verticesSize + indicesSize, vk::BufferUsageFlagBits::eTransferSrc,
                  vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, stagingBuffer,
-                 stagingBufferMemory);
+                 stagingBufferMemory, preferredStagingProperties);
 
-    void* data;
-    handleVulkanError(m_device.mapMemory(stagingBufferMemory, 0, BufferSize, {}, &data));
-    std::memcpy(data, s_indices.data(), BufferSize);
-    m_device.unmapMemory(stagingBufferMemory);
+    Mesh mesh{};
+    mesh.indexCount = indexCount;
+    mesh.indexType = getIndexType<IndexType>();
+
+    try
+    {
+        void* data;
+        handleVulkanError(m_device.mapMemory(stagingBufferMemory, 0, verticesSize + indicesSize, {}, &data));
+
+        const std::span<Vertex> vertices{static_cast<Vertex*>(data), vertexCount};
+        const std::span<IndexType> indices{
+          reinterpret_cast<IndexType*>(static_cast<char*>(data) + verticesSize), indexCount};
+
+        writer(vertices.data(), indices.data());
+
+        vk::DeviceSize uploadedVerticesSize = verticesSize;
+        vk::DeviceSize uploadedIndicesSize = indicesSize;
+
+        if (optimization.enabled)
+        {
+            // No optimizeOverdraw(): it sorts triangles by facing, and 2D meshes all face the camera
+            mesh::optimizeVertexCache(indices, vertexCount);
+
+            const uint32_t usedVertexCount = mesh::optimizeVertexFetch(vertices, indices);
+            uploadedVerticesSize = sizeof(Vertex) * usedVertexCount;
+
+            // Dropping unreferenced vertices may be enough to fit in 16 bit indices
+            if constexpr (std::is_same_v<IndexType, uint32_t>)
+            {
+                if (mesh::fitsUint16Indices(usedVertexCount))
+                {
+                    mesh::narrowIndices(indices.data(), indices.size());
+                    mesh.indexType = getIndexType<uint16_t>();
+                    uploadedIndicesSize = sizeof(uint16_t) * indexCount;
+                }
+            }
+        }
+
+        m_device.unmapMemory(stagingBufferMemory);
+
+        createBuffer(uploadedVerticesSize,
+                     vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
+                     vk::MemoryPropertyFlagBits::eDeviceLocal, mesh.vertexBuffer, mesh.vertexBufferMemory);
+        createBuffer(uploadedIndicesSize, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
+                     vk::MemoryPropertyFlagBits::eDeviceLocal, mesh.indexBuffer, mesh.indexBufferMemory);
+
+        executeOneTimeCommands([&](vk::CommandBuffer& commandBuffer) {
+            const vk::BufferCopy vertexRegion{0, 0, uploadedVerticesSize};
+            const vk::BufferCopy indexRegion{verticesSize, 0, uploadedIndicesSize};
 
-    createBuffer(BufferSize, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
-                 vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, m_indexBuffer,
-                 m_indexBufferMemory);
+            commandBuffer.copyBuffer(stagingBuffer, mesh.vertexBuffer, 1, &vertexRegion);
+            commandBuffer.copyBuffer(stagingBuffer, mesh.indexBuffer, 1, &indexRegion);
+        });
 
-    copyBuffer(stagingBuffer, m_indexBuffer, BufferSize);
+        counters::add(RenderCounter::eBufferUploads, 2);
+        counters::add(RenderCounter::eUploadedBytes, uploadedVerticesSize + uploadedIndicesSize);
+    } catch (...)
+    {
+        // Malformed files are only detected while writing
+        mesh.destroy(m_device);
+        m_device.destroy(stagingBuffer);
+        m_device.freeMemory(stagingBufferMemory);
+        throw;
+    }
 
     // TODO: vk::raii
     m_device.destroy(stagingBuffer);
     m_device.freeMemory(stagingBufferMemory);
+
+    mesh.node = m_transforms.createNode(m_sceneRoot);
+
+    m_meshes.push_back(mesh);
+    return static_cast<MeshHandle>(m_meshes.size() - 1);
 }
 
 void vulk::ContextVulkan::createUniformBuffers()
@@ -763,16 +1037,43 @@ void vulk::ContextVulkan::createUniformBuffers()
     }
 }
 
+void vulk::ContextVulkan::createTransformBuffers()
+{
+    VULK_SCOPED_PROFILER("ContextVulkan::createTransformBuffers()");
+
+    static constexpr uint32_t INITIAL_CAPACITY = 1024;
+
+    m_transformBuffers.resize(s_maxFramesInFlight);
+
+    for (auto& transformBuffer : m_transformBuffers)
+        createTransformBuffer(transformBuffer, INITIAL_CAPACITY);
+}
+
+void vulk::ContextVulkan::createTransformBuffer(TransformBuffer& transformBuffer, uint32_t capacity)
+{
+    VULK_SCOPED_PROFILER("ContextVulkan::createTransformBuffer()");
+
+    createBuffer(sizeof(glm::mat4) * capacity, vk::BufferUsageFlagBits::eStorageBuffer,
+                 vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+                 transformBuffer.buffer, transformBuffer.memory);
+
+    void* data;
+    handleVulkanError(m_device.mapMemory(transformBuffer.memory, 0, VK_WHOLE_SIZE, {}, &data));
+
+    transformBuffer.transforms = static_cast<glm::mat4*>(data);
+    transformBuffer.capacity = capacity;
+
+    // A new buffer has none of the transforms yet
+    transformBuffer.pendingRanges.assign(1, TransformHierarchy::Range{0, m_transforms.getNodeCount()});
+}
+
 void vulk::ContextVulkan::createDescriptorPool()
 {
     VULK_SCOPED_PROFILER("ContextVulkan::createDescriptorPool()");
 
-    vk::DescriptorPoolSize poolSize{};
-    poolSize.descriptorCount = static_cast<uint32_t>(s_maxFramesInFlight);
-
     vk::DescriptorPoolCreateInfo createInfo{};
-    createInfo.poolSizeCount = 1;
-    createInfo.pPoolSizes = &poolSize;
+    createInfo.poolSizeCount = static_cast<uint32_t>(m_descriptorPoolSizes.size());
+    createInfo.pPoolSizes = m_descriptorPoolSizes.data();
     createInfo.maxSets = static_cast<uint32_t>(s_maxFramesInFlight);
 
     handleVulkanError(m_device.createDescriptorPool(&createInfo, nullptr, &m_descriptorPool));
@@ -807,9 +1108,29 @@ void vulk::ContextVulkan::createDescriptorSets()
         descriptorWrite.pBufferInfo = &bufferInfo;
 
         m_device.updateDescriptorSets(1, &descriptorWrite, 0, nullptr);
+
+        writeTransformDescriptor(i);
     }
 }
 
+void vulk::ContextVulkan::writeTransformDescriptor(size_t frameIndex)
+{
+    vk::DescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = m_transformBuffers[frameIndex].buffer;
+    bufferInfo.offset = 0;
+    bufferInfo.range = VK_WHOLE_SIZE;
+
+    vk::WriteDescriptorSet descriptorWrite{};
+    descriptorWrite.dstSet = m_descriptorSets[frameIndex];
+    descriptorWrite.dstBinding = 1;
+    descriptorWrite.dstArrayElement = 0;
+    descriptorWrite.descriptorType = vk::DescriptorType::eStorageBuffer;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pBufferInfo = &bufferInfo;
+
+    m_device.updateDescriptorSets(1, &descriptorWrite, 0, nullptr);
+}
+
 void vulk::ContextVulkan::createCommandBuffers()
 {
     VULK_SCOPED_PROFILER("ContextVulkan::createCommandBuffers()");
@@ -842,6 +1163,45 @@ void vulk::ContextVulkan::createSyncObject()
     }
 }
 
+void vulk::ContextVulkan::createTimestampQueries()
+{
+    VULK_SCOPED_PROFILER("ContextVulkan::createTimestampQueries()");
+
+    const auto queueFamilies = m_physicalDevice.getQueueFamilyProperties();
+
+    if (queueFamilies[m_queueFamilyIndices.graphicsFamily.value()].timestampValidBits == 0)
+        return;
+
+    m_timestampPeriod = m_physicalDevice.getProperties().limits.timestampPeriod;
+
+    vk::QueryPoolCreateInfo createInfo{};
+    createInfo.queryType = vk::QueryType::eTimestamp;
+    createInfo.queryCount = static_cast<uint32_t>(2 * s_maxFramesInFlight);
+
+    handleVulkanError(m_device.createQueryPool(&createInfo, nullptr, &m_timestampQueryPool));
+    m_timestampsWritten.assign(s_maxFramesInFlight, false);
+}
+
+void vulk::ContextVulkan::readGpuTime()
+{
+    if (!m_timestampQueryPool || !m_timestampsWritten[m_currentFrame])
+        return;
+
+    std::array<uint64_t, 2> timestamps{};
+
+    const vk::Result result = m_device.getQueryPoolResults(
+      m_timestampQueryPool, static_cast<uint32_t>(2 * m_currentFrame), static_cast<uint32_t>(timestamps.size()),
+      sizeof(timestamps), timestamps.data(), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+
+    // Not ready would mean the frame's fence was signaled before its commands completed
+    if (result != vk::Result::eSuccess || timestamps[1] < timestamps[0])
+        return;
+
+    const std::chrono::duration<double, std::nano> gpuTime{static_cast<double>(timestamps[1] - timestamps[0]) *
+                                                           static_cast<double>(m_timestampPeriod)};
+    m_frameWorkload.gpuTime = std::chrono::duration_cast<Duration>(gpuTime);
+}
+
 void vulk::ContextVulkan::recordCommandBuffer(vk::CommandBuffer& commandBuffer, uint32_t imageIndex)
 {
     vk::CommandBufferBeginInfo beginInfo{};
@@ -850,6 +1210,17 @@ void vulk::ContextVulkan::recordCommandBuffer(vk::CommandBuffer& commandBuffer,
 
     handleVulkanError(commandBuffer.begin(&beginInfo));
 
+    const auto firstTimestamp = static_cast<uint32_t>(2 * m_currentFrame);
+
+    if (m_timestampQueryPool)
+    {
+        commandBuffer.resetQueryPool(m_timestampQueryPool, firstTimestamp, 2);
+        commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, m_timestampQueryPool, firstTimestamp);
+    }
+
+    if (m_particleSystem)
+        m_particleSystem->recordCompute(commandBuffer, m_currentFrame);
+
     vk::ClearValue clearValue{};
     clearValue.color = vk::ClearColorValue{std::array{0.f, 0.f, 0.f, 1.f}};
 
@@ -861,19 +1232,58 @@ void vulk::ContextVulkan::recordCommandBuffer(vk::CommandBuffer& commandBuffer,
     renderPassBeginInfo.clearValueCount = 1;
     renderPassBeginInfo.pClearValues = &clearValue;
 
-    std::array vertexBuffers{m_vertexBuffer};
-    std::array offsets{vk::DeviceSize{0}};
-    static_assert(vertexBuffers.size() == offsets.size());
-
     commandBuffer.beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eInline);
-    commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_pipeline);
-    commandBuffer.bindVertexBuffers(0, static_cast<uint32_t>(vertexBuffers.size()), vertexBuffers.data(),
-                                    offsets.data());
-    commandBuffer.bindIndexBuffer(m_indexBuffer, 0, getIndexType<decltype(s_indices)::value_type>());
-    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipelineLayout, 0, 1,
-                                     &m_descriptorSets[m_currentFrame], 0, nullptr);
-    commandBuffer.drawIndexed(static_cast<uint32_t>(s_indices.size()), 1, 0, 0, 0);
+
+    // Dynamic in every pipeline
+    const vk::Viewport viewport{0, 0, static_cast<float>(m_extent.width), static_cast<float>(m_extent.height), 0, 1};
+    const vk::Rect2D scissor{vk::Offset2D{0, 0}, m_extent};
+    commandBuffer.setViewport(0, 1, &viewport);
+    commandBuffer.setScissor(0, 1, &scissor);
+
+    // Every mesh shares the per frame uniform buffer set for now
+    constexpr uint32_t MeshMaterialId = 0;
+
+    m_drawQueue.clear();
+
+    for (size_t i = 0; i < m_meshes.size(); ++i)
+    {
+        const Mesh& mesh = m_meshes[i];
+
+        // Drawn with the default pipeline while its own one compiles
+        const PipelineRegistry::Pipeline* pipeline =
+          mesh.pipelineDesc ? m_pipelineRegistry->requestPipeline(*mesh.pipelineDesc) : nullptr;
+
+        DrawQueue::Draw draw{};
+        draw.pipeline = pipeline ? pipeline->pipeline : m_pipeline;
+        draw.pipelineLayout = m_pipelineLayout;
+        draw.descriptorSet = m_descriptorSets[m_currentFrame];
+        draw.vertexBuffer = mesh.vertexBuffer;
+        draw.indexBuffer = mesh.indexBuffer;
+        draw.indexType = mesh.indexType;
+        draw.indexCount = mesh.indexCount;
+        draw.firstInstance = m_transforms.getIndex(mesh.node);
+        draw.renderState = pipeline ? static_cast<uint32_t>(i + 1) : 0;  // Mesh index + 1, 0 is the default state
+
+        m_drawQueue.submit(DrawQueue::makeKey(0, pipeline ? mesh.pipelineId : 0, MeshMaterialId, 0), draw);
+    }
+
+    m_drawQueue.record(commandBuffer, [&](uint32_t renderState) {
+        const PipelineDesc& desc = renderState == 0 ? m_meshPipelineDesc : *m_meshes[renderState - 1].pipelineDesc;
+        m_pipelineRegistry->recordDynamicState(commandBuffer, desc);
+    });
+
+    if (m_particleSystem)
+        m_particleSystem->recordDraw(commandBuffer, m_currentFrame);
+
     commandBuffer.endRenderPass();
+
+    if (m_timestampQueryPool)
+    {
+        commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, m_timestampQueryPool,
+                                     firstTimestamp + 1);
+        m_timestampsWritten[m_currentFrame] = true;
+    }
+
     commandBuffer.end();
 }
 
@@ -939,8 +1349,10 @@ void vulk::ContextVulkan::updateUniformBuffer(uint32_t currentImage)
     auto currentTime = Clock::now();
     auto delta = vulk::Duration{currentTime - startTime}.count();
 
+    m_transforms.setLocalTransform(
+      m_sceneRoot, glm::rotate(glm::mat4(1.0f), delta * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
+
     UniformBufferObject ubo{
-      glm::rotate(glm::mat4(1.0f), delta * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f)),
       glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)),
       glm::perspective(glm::radians(45.0f), static_cast<float>(m_extent.width) / static_cast<float>(m_extent.height),
                        0.1f, 10.0f)};
@@ -950,13 +1362,60 @@ void vulk::ContextVulkan::updateUniformBuffer(uint32_t currentImage)
     handleVulkanError(m_device.mapMemory(m_uniformBuffersMemory[currentImage], 0, sizeof(ubo), {}, &data));
     std::memcpy(data, &ubo, sizeof(ubo));
     m_device.unmapMemory(m_uniformBuffersMemory[currentImage]);
+
+    counters::add(RenderCounter::eBufferUploads);
+    counters::add(RenderCounter::eUploadedBytes, sizeof(ubo));
+}
+
+void vulk::ContextVulkan::updateTransformBuffer(uint32_t currentImage)
+{
+    VULK_SCOPED_PROFILER_CATEGORY("ContextVulkan::updateTransformBuffer()", eFrame);
+
+    const auto changedRanges = m_transforms.update();
+
+    // Every frame in flight has its own copy, each one catches up when its frame comes
+    for (auto& transformBuffer : m_transformBuffers)
+    {
+        transformBuffer.pendingRanges.insert(transformBuffer.pendingRanges.end(), changedRanges.begin(),
+                                             changedRanges.end());
+    }
+
+    TransformBuffer& transformBuffer = m_transformBuffers[currentImage];
+    const uint32_t nodeCount = m_transforms.getNodeCount();
+
+    // The fence of this frame was waited on, its buffer can be replaced but not the other ones
+    if (nodeCount > transformBuffer.capacity)
+    {
+        transformBuffer.destroy(m_device);
+        createTransformBuffer(transformBuffer, std::max(nodeCount, transformBuffer.capacity * 2));
+        writeTransformDescriptor(currentImage);
+    }
+
+    const auto worldTransforms = m_transforms.getWorldTransforms();
+
+    for (const auto& range : transformBuffer.pendingRanges)
+    {
+        // Nodes may have been destroyed since the range was recorded
+        const uint32_t last = std::min(range.first + range.count, nodeCount);
+
+        if (range.first < last)
+        {
+            std::copy(worldTransforms.begin() + range.first, worldTransforms.begin() + last,
+                      transformBuffer.transforms + range.first);
+
+            counters::add(RenderCounter::eBufferUploads);
+            counters::add(RenderCounter::eUploadedBytes, sizeof(glm::mat4) * (last - range.first));
+        }
+    }
+
+    transformBuffer.pendingRanges.clear();
 }
 
 void vulk::ContextVulkan::createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage,
                                        vk::MemoryPropertyFlags properties, vk::Buffer& outBuffer,
-                                       vk::DeviceMemory& outDeviceMemory)
+                                       vk::DeviceMemory& outDeviceMemory, vk::MemoryPropertyFlags preferredProperties)
 {
-    VULK_SCOPED_PROFILER("ContextVulkan::createBuffer()");
+    VULK_SCOPED_PROFILER_CATEGORY("ContextVulkan::createBuffer()", eLoading);
 
     vk::BufferCreateInfo bufferInfo{};
     bufferInfo.size = size;
@@ -968,15 +1427,37 @@ void vulk::ContextVulkan::createBuffer(vk::DeviceSize size, vk::BufferUsageFlags
     vk::MemoryRequirements memoryRequirements{m_device.getBufferMemoryRequirements(outBuffer)};
     vk::MemoryAllocateInfo allocateInfo{};
     allocateInfo.allocationSize = memoryRequirements.size;
-    allocateInfo.memoryTypeIndex = findMemoryType(memoryRequirements.memoryTypeBits, properties);
+
+    if (const std::optional<uint32_t> memoryType =
+          tryFindMemoryType(memoryRequirements.memoryTypeBits, properties | preferredProperties))
+        allocateInfo.memoryTypeIndex = *memoryType;
+    else
+        allocateInfo.memoryTypeIndex = findMemoryType(memoryRequirements.memoryTypeBits, properties);
 
     handleVulkanError(m_device.allocateMemory(&allocateInfo, nullptr, &outDeviceMemory));
+    counters::add(RenderCounter::eAllocations);
+    counters::add(RenderCounter::eAllocatedBytes, allocateInfo.allocationSize);
     m_device.bindBufferMemory(outBuffer, outDeviceMemory, 0);
 }
 
 void vulk::ContextVulkan::copyBuffer(const vk::Buffer& sourceBuffer, vk::Buffer& destinationBuffer, vk::DeviceSize size)
 {
-    VULK_SCOPED_PROFILER("ContextVulkan::copyBuffer()");
+    VULK_SCOPED_PROFILER_CATEGORY("ContextVulkan::copyBuffer()", eLoading);
+
+    executeOneTimeCommands([&](vk::CommandBuffer& commandBuffer) {
+        vk::BufferCopy copyRegion{};
+        copyRegion.size = size;
+
+        commandBuffer.copyBuffer(sourceBuffer, destinationBuffer, 1, &copyRegion);
+    });
+
+    counters::add(RenderCounter::eBufferUploads);
+    counters::add(RenderCounter::eUploadedBytes, size);
+}
+
+void vulk::ContextVulkan::executeOneTimeCommands(const std::function<void(vk::CommandBuffer&)>& recorder)
+{
+    VULK_SCOPED_PROFILER_CATEGORY("ContextVulkan::executeOneTimeCommands()", eLoading);
 
     vk::CommandBufferAllocateInfo allocateInfo{};
     allocateInfo.level = vk::CommandBufferLevel::ePrimary;
@@ -990,11 +1471,7 @@ void vulk::ContextVulkan::copyBuffer(const vk::Buffer& sourceBuffer, vk::Buffer&
     beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
 
     handleVulkanError(commandBuffer.begin(&beginInfo));
-
-    vk::BufferCopy copyRegion{};
-    copyRegion.size = size;
-
-    commandBuffer.copyBuffer(sourceBuffer, destinationBuffer, 1, &copyRegion);
+    recorder(commandBuffer);
     commandBuffer.end();
 
     vk::SubmitInfo submitInfo{};
@@ -1002,6 +1479,7 @@ void vulk::ContextVulkan::copyBuffer(const vk::Buffer& sourceBuffer, vk::Buffer&
     submitInfo.pCommandBuffers = &commandBuffer;
 
     handleVulkanError(m_graphicsQueue.submit(1, &submitInfo, nullptr));
+    counters::add(RenderCounter::eQueueSubmits);
     m_graphicsQueue.waitIdle();
 
     // TODO: vk::raii
@@ -1030,6 +1508,43 @@ bool vulk::ContextVulkan::verifyExtensionsSupport(const vk::PhysicalDevice& devi
     return allValid;
 }
 
+bool vulk::ContextVulkan::supportsExtendedDynamicState() const
+{
+    VULK_SCOPED_PROFILER("ContextVulkan::supportsExtendedDynamicState()");
+
+    const auto& extensions = m_physicalDevice.enumerateDeviceExtensionProperties();
+    const bool available = std::any_of(extensions.cbegin(), extensions.cend(), [](const auto& props) {
+        return std::string_view{props.extensionName} == VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME;
+    });
+
+    if (!available)
+        return false;
+
+    const auto features =
+      m_physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>();
+    return features.get<vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>().extendedDynamicState == VK_TRUE;
+}
+
+bool vulk::ContextVulkan::supportsPresentWait() const
+{
+    VULK_SCOPED_PROFILER("ContextVulkan::supportsPresentWait()");
+
+    const auto& extensions = m_physicalDevice.enumerateDeviceExtensionProperties();
+    const auto isAvailable = [&extensions](std::string_view name) {
+        return std::any_of(extensions.cbegin(), extensions.cend(),
+                           [name](const auto& props) { return std::string_view{props.extensionName} == name; });
+    };
+
+    if (!isAvailable(VK_KHR_PRESENT_ID_EXTENSION_NAME) || !isAvailable(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+        return false;
+
+    const auto features = m_physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2,
+                                                        vk::PhysicalDevicePresentIdFeaturesKHR,
+                                                        vk::PhysicalDevicePresentWaitFeaturesKHR>();
+    return features.get<vk::PhysicalDevicePresentIdFeaturesKHR>().presentId == VK_TRUE &&
+           features.get<vk::PhysicalDevicePresentWaitFeaturesKHR>().presentWait == VK_TRUE;
+}
+
 vulk::ContextVulkan::QueueFamilyEntry
 vulk::ContextVulkan::findQueueFamilies(const vk::PhysicalDevice& physicalDevice) const noexcept
 {
@@ -1057,6 +1572,15 @@ vulk::ContextVulkan::findQueueFamilies(const vk::PhysicalDevice& physicalDevice)
 }
 
 uint32_t vulk::ContextVulkan::findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const
+{
+    if (const std::optional<uint32_t> memoryType = tryFindMemoryType(typeFilter, properties))
+        return *memoryType;
+
+    throw VulkanException("Could not find a suitable memory type");
+}
+
+std::optional<uint32_t> vulk::ContextVulkan::tryFindMemoryType(uint32_t typeFilter,
+                                                               vk::MemoryPropertyFlags properties) const noexcept
 {
     vk::PhysicalDeviceMemoryProperties memoryProperties{m_physicalDevice.getMemoryProperties()};
 
@@ -1068,7 +1592,7 @@ uint32_t vulk::ContextVulkan::findMemoryType(uint32_t typeFilter, vk::MemoryProp
         }
     }
 
-    throw VulkanException("Could not find a suitable memory type");
+    return std::nullopt;
 }
 
 vulk::ContextVulkan::SwapChainSupportDetails
@@ -1081,6 +1605,14 @@ vulk::ContextVulkan::querySwapChainSupport(const vk::PhysicalDevice& device) con
     return details;
 }
 
+vulk::ParticleSystem& vulk::ContextVulkan::enableParticleSystem(uint32_t capacity)
+{
+    if (!m_particleSystem)
+        m_particleSystem = std::make_unique<ParticleSystem>(*this, capacity);
+
+    return *m_particleSystem;
+}
+
 vulk::ContextVulkan& vulk::ContextVulkan::getInstance()
 {
     assert(s_instance);
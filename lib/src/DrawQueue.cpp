@@ -0,0 +1,180 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/DrawQueue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <optional>
+#include <utility>
+
+#include "Vulk/RenderCounters.hpp"
+#include "Vulk/ScopedProfiler.hpp"
+
+uint32_t vulk::DrawQueue::quantizeDepth(float depth, bool backToFront) noexcept
+{
+    constexpr uint32_t MaxDepth = (1u << DEPTH_BITS) - 1;
+
+    const auto quantized =
+      static_cast<uint32_t>(std::lround(static_cast<double>(std::clamp(depth, 0.f, 1.f)) * MaxDepth));
+
+    return backToFront ? MaxDepth - quantized : quantized;
+}
+
+void vulk::DrawQueue::clear() noexcept
+{
+    m_draws.clear();
+    m_entries.clear();
+    m_sorted = true;
+}
+
+void vulk::DrawQueue::submit(uint64_t key, const Draw& draw)
+{
+    m_entries.push_back(SortEntry{key, static_cast<uint32_t>(m_draws.size())});
+    m_draws.push_back(draw);
+    m_sorted = false;
+}
+
+void vulk::DrawQueue::sort()
+{
+    VULK_SCOPED_PROFILER_CATEGORY("DrawQueue::sort()", eFrame);
+
+    if (m_sorted)
+        return;
+
+    constexpr size_t DigitBits = 8;
+    constexpr size_t Passes = 64 / DigitBits;
+    constexpr size_t Buckets = 1 << DigitBits;
+
+    // All histograms in a single read of the keys
+    std::array<std::array<uint32_t, Buckets>, Passes> histograms{};
+
+    for (const SortEntry& entry : m_entries)
+    {
+        for (size_t pass = 0; pass < Passes; ++pass)
+            ++histograms[pass][(entry.key >> (pass * DigitBits)) & (Buckets - 1)];
+    }
+
+    m_scratch.resize(m_entries.size());
+
+    for (size_t pass = 0; pass < Passes; ++pass)
+    {
+        auto& histogram = histograms[pass];
+        const uint64_t firstDigit = (m_entries.front().key >> (pass * DigitBits)) & (Buckets - 1);
+
+        if (histogram[firstDigit] == m_entries.size())
+            continue;
+
+        // Exclusive prefix sum: bucket start offsets
+        uint32_t offset = 0;
+
+        for (uint32_t& count : histogram)
+            offset += std::exchange(count, offset);
+
+        for (const SortEntry& entry : m_entries)
+            m_scratch[histogram[(entry.key >> (pass * DigitBits)) & (Buckets - 1)]++] = entry;
+
+        m_entries.swap(m_scratch);
+    }
+
+    m_sorted = true;
+}
+
+void vulk::DrawQueue::record(const vk::CommandBuffer& commandBuffer, const RenderStateRecorder& recordRenderState)
+{
+    VULK_SCOPED_PROFILER_CATEGORY("DrawQueue::record()", eFrame);
+
+    sort();
+
+    m_statistics = Statistics{};
+
+    vk::Pipeline boundPipeline{};
+    vk::PipelineLayout boundLayout{};
+    vk::DescriptorSet boundDescriptorSet{};
+    vk::Buffer boundVertexBuffer{};
+    vk::Buffer boundIndexBuffer{};
+    vk::IndexType boundIndexType{};
+    std::optional<uint32_t> renderState{};
+
+    for (const SortEntry& entry : m_entries)
+    {
+        const Draw& draw = m_draws[entry.drawIndex];
+
+        if (draw.pipeline != boundPipeline)
+        {
+            commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, draw.pipeline);
+            boundPipeline = draw.pipeline;
+            ++m_statistics.pipelineBinds;
+        }
+
+        if (recordRenderState && draw.renderState != renderState)
+        {
+            recordRenderState(draw.renderState);
+            renderState = draw.renderState;
+            ++m_statistics.renderStateChanges;
+        }
+
+        // Sets stay bound across pipelines only if the layouts are compatible, identical ones are the easy case
+        if (draw.descriptorSet && (draw.descriptorSet != boundDescriptorSet || draw.pipelineLayout != boundLayout))
+        {
+            commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, draw.pipelineLayout, 0, 1,
+                                             &draw.descriptorSet, 0, nullptr);
+            boundDescriptorSet = draw.descriptorSet;
+            boundLayout = draw.pipelineLayout;
+            ++m_statistics.descriptorSetBinds;
+        }
+
+        if (draw.vertexBuffer && draw.vertexBuffer != boundVertexBuffer)
+        {
+            static constexpr vk::DeviceSize Offset{0};
+
+            commandBuffer.bindVertexBuffers(0, 1, &draw.vertexBuffer, &Offset);
+            boundVertexBuffer = draw.vertexBuffer;
+            ++m_statistics.vertexBufferBinds;
+        }
+
+        if (draw.indexBuffer)
+        {
+            if (draw.indexBuffer != boundIndexBuffer || draw.indexType != boundIndexType)
+            {
+                commandBuffer.bindIndexBuffer(draw.indexBuffer, 0, draw.indexType);
+                boundIndexBuffer = draw.indexBuffer;
+                boundIndexType = draw.indexType;
+                ++m_statistics.indexBufferBinds;
+            }
+
+            commandBuffer.drawIndexed(draw.indexCount, draw.instanceCount, draw.firstIndex, draw.vertexOffset,
+                                      draw.firstInstance);
+        } else
+        {
+            commandBuffer.draw(draw.indexCount, draw.instanceCount, draw.firstIndex, draw.firstInstance);
+        }
+
+        ++m_statistics.draws;
+        m_statistics.instances += draw.instanceCount;
+        m_statistics.triangles += uint64_t{draw.indexCount / 3} * draw.instanceCount;
+    }
+
+    counters::add(RenderCounter::eDrawCalls, m_statistics.draws);
+    counters::add(RenderCounter::eInstances, m_statistics.instances);
+    counters::add(RenderCounter::eTriangles, m_statistics.triangles);
+    counters::add(RenderCounter::ePipelineBinds, m_statistics.pipelineBinds);
+    counters::add(RenderCounter::eDescriptorSetBinds, m_statistics.descriptorSetBinds);
+}
@@ -20,7 +20,6 @@
 #include "Vulk/Exceptions.hpp"
 
 #include <GLFW/glfw3.h>
-#include <vulkan/vulkan.hpp>
 
 vulk::VulkanException::VulkanException(vk::Result result) : LibraryException{vk::to_string(result), "VulkanException"}
 {
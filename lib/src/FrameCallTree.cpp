@@ -0,0 +1,174 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/FrameCallTree.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <string_view>
+
+namespace {
+using TickDuration = std::chrono::steady_clock::duration;
+}  // namespace
+
+vulk::utils::FrameCallTree::FrameCallTree(size_t windowSize) : m_windowSize{windowSize}, m_nodes(1)
+{
+    assert(m_windowSize > 0);
+}
+
+void vulk::utils::FrameCallTree::addFrame(std::span<const Zone> zones)
+{
+    std::vector<Zone> sortedZones{zones.begin(), zones.end()};
+
+    // Parents first: they start before their children, or at the same tick and end after them
+    std::sort(sortedZones.begin(), sortedZones.end(), [](const Zone& lhs, const Zone& rhs) {
+        return lhs.begin < rhs.begin || (lhs.begin == rhs.begin && lhs.end > rhs.end);
+    });
+
+    struct OpenZone
+    {
+        size_t node;
+        Ticks end;
+        size_t contribution;
+    };
+
+    std::vector<OpenZone> openZones{};
+    std::vector<Contribution> frame{};
+    frame.reserve(sortedZones.size());
+
+    for (const auto& zone : sortedZones)
+    {
+        // Every zone still open starts before this one, those which end before it aren't its ancestors
+        while (!openZones.empty() && zone.end > openZones.back().end)
+            openZones.pop_back();
+
+        const size_t parent = openZones.empty() ? s_root : openZones.back().node;
+        const size_t node = findOrAddChild(parent, zone.name);
+        const Ticks duration = zone.end - zone.begin;
+
+        if (!openZones.empty())
+            frame[openZones.back().contribution].self -= duration;
+
+        frame.push_back(Contribution{node, duration, duration});
+        openZones.push_back(OpenZone{node, zone.end, frame.size() - 1});
+    }
+
+    for (const auto& contribution : frame)
+    {
+        TreeNode& node = m_nodes[contribution.node];
+        ++node.calls;
+        node.total += contribution.total;
+        node.self += contribution.self;
+    }
+
+    m_frames.push_back(std::move(frame));
+
+    while (m_frames.size() > m_windowSize)
+        removeOldestFrame();
+}
+
+std::vector<vulk::utils::FrameCallTree::Node> vulk::utils::FrameCallTree::getNodes() const
+{
+    std::vector<Node> nodes{};
+
+    if (m_frames.empty())
+        return nodes;
+
+    const auto frameCount = static_cast<double>(m_frames.size());
+
+    const auto visit = [&](const auto& self, size_t treeIndex, size_t parent, uint32_t depth) -> void {
+        std::vector<size_t> children{};
+
+        for (const size_t child : m_nodes[treeIndex].children)
+        {
+            if (m_nodes[child].calls > 0)
+                children.push_back(child);
+        }
+
+        std::sort(children.begin(), children.end(),
+                  [this](size_t lhs, size_t rhs) { return m_nodes[lhs].total > m_nodes[rhs].total; });
+
+        for (const size_t child : children)
+        {
+            const TreeNode& treeNode = m_nodes[child];
+
+            Node node{};
+            node.name = treeNode.name;
+            node.parent = parent;
+            node.depth = depth;
+            node.calls = static_cast<double>(treeNode.calls) / frameCount;
+            node.total = Milliseconds{TickDuration{treeNode.total}} / frameCount;
+            node.self = Milliseconds{TickDuration{treeNode.self}} / frameCount;
+
+            nodes.push_back(node);
+            self(self, child, nodes.size() - 1, depth + 1);
+        }
+    };
+
+    visit(visit, s_root, Node::s_noParent, 0);
+    return nodes;
+}
+
+void vulk::utils::FrameCallTree::setWindowSize(size_t windowSize)
+{
+    assert(windowSize > 0);
+    m_windowSize = windowSize;
+
+    while (m_frames.size() > m_windowSize)
+        removeOldestFrame();
+}
+
+void vulk::utils::FrameCallTree::clear()
+{
+    m_nodes.assign(1, TreeNode{});
+    m_frames.clear();
+}
+
+size_t vulk::utils::FrameCallTree::findOrAddChild(size_t parent, const char* name)
+{
+    for (const size_t child : m_nodes[parent].children)
+    {
+        // The same literal may have a different address in another translation unit
+        if (m_nodes[child].name == name || std::string_view{m_nodes[child].name} == name)
+            return child;
+    }
+
+    const size_t child = m_nodes.size();
+
+    TreeNode node{};
+    node.name = name;
+    node.parent = parent;
+    m_nodes.push_back(std::move(node));
+
+    m_nodes[parent].children.push_back(child);
+    return child;
+}
+
+void vulk::utils::FrameCallTree::removeOldestFrame()
+{
+    for (const auto& contribution : m_frames.front())
+    {
+        TreeNode& node = m_nodes[contribution.node];
+        --node.calls;
+        node.total -= contribution.total;
+        node.self -= contribution.self;
+    }
+
+    m_frames.pop_front();
+}
@@ -27,7 +27,7 @@ vulk::FrameManager::FrameManager() : m_lastFrame{Clock::now()}
 {
 }
 
-void vulk::FrameManager::update() noexcept
+void vulk::FrameManager::update()
 {
     const auto timePoint = Clock::now();
 
@@ -35,6 +35,14 @@ void vulk::FrameManager::update() noexcept
     m_duration = timePoint - m_lastFrame;
     m_deltaTime = m_duration.count();
     m_lastFrame = timePoint;
+    m_statistics.addFrame(m_duration);
+    m_renderCounters = counters::fold();
+#if VULK_ACCOUNT_VULKAN_CALLS
+    m_vulkanCalls = accounting::fold();
+#endif
+
+    if (m_recorder)
+        m_recorder->append(timePoint, m_duration, m_workload, m_renderCounters);
 
     // Compute frame per seconds
     m_duration = timePoint - m_lastSecond;
@@ -49,7 +57,28 @@ void vulk::FrameManager::update() noexcept
         if (m_onSecondCallback.has_value())
             (*m_onSecondCallback)(*this);
     }
+
+#if VULK_ENABLE_TELEMETRY_SERVER
+    if (m_telemetryServer)
+        m_telemetryServer->publish(*this);
+#endif
+}
+
+void vulk::FrameManager::startRecording(const std::string& filePath)
+{
+    // Closes the previous file first, it may be the same one
+    m_recorder.reset();
+    m_recorder = std::make_unique<FrameRecorder>(filePath);
+}
+
+#if VULK_ENABLE_TELEMETRY_SERVER
+void vulk::FrameManager::startTelemetryServer(const std::string& socketPath)
+{
+    // Stopped first, it may listen on the same path
+    m_telemetryServer.reset();
+    m_telemetryServer = std::make_unique<TelemetryServer>(socketPath);
 }
+#endif
 
 // TODO: There is probably a more optimal way of doing this
 vulk::FrameManager::FramerateStringBuffer vulk::FrameManager::getFramerateCString() const noexcept
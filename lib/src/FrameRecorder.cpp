@@ -0,0 +1,152 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/FrameRecorder.hpp"
+
+#include <array>
+#include <cstring>
+
+#include "Vulk/Exceptions.hpp"
+#include "Vulk/ScopedProfiler.hpp"
+
+namespace {
+constexpr std::array<char, 8> Magic{'V', 'U', 'L', 'K', 'F', 'R', 'M', 'S'};
+constexpr std::chrono::milliseconds WritePeriod{100};
+
+struct FileHeader
+{
+    std::array<char, 8> magic{Magic};
+    uint32_t version{vulk::FrameRecorder::s_formatVersion};
+    uint32_t recordSize{sizeof(vulk::FrameRecorder::Record)};
+};
+}  // namespace
+
+vulk::FrameRecorder::FrameRecorder(const std::string& filePath)
+    : m_output{filePath, std::ios::binary | std::ios::trunc}, m_start{Clock::now()}
+{
+    if (!m_output)
+        throw IOException{"Unable to create " + filePath};
+
+    const FileHeader header{};
+    m_output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    m_writer = std::thread{&FrameRecorder::runWriter, this};
+}
+
+vulk::FrameRecorder::~FrameRecorder()
+{
+    {
+        const std::scoped_lock lock{m_writerMutex};
+        m_stopWriter = true;
+    }
+
+    m_writerWakeUp.notify_one();
+    m_writer.join();
+
+    writeBuffered();
+}
+
+void vulk::FrameRecorder::append(TimePoint frameEnd, Duration deltaTime, const FrameWorkload& workload,
+                                 const RenderCounters& counters) noexcept
+{
+    Record record{};
+    record.frame = m_nextFrame++;
+    record.timestamp =
+      static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(frameEnd - m_start).count());
+    record.uploadedBytes = counters[RenderCounter::eUploadedBytes];
+    record.deltaTime = deltaTime.count();
+    record.cpuTime = workload.cpuTime.count();
+    record.gpuTime = workload.gpuTime.count();
+    record.drawCount = static_cast<uint32_t>(counters[RenderCounter::eDrawCalls]);
+
+    if (!m_records.tryPush(record))
+        ++m_droppedRecords;
+}
+
+std::vector<vulk::FrameRecorder::Record> vulk::FrameRecorder::read(const std::string& filePath)
+{
+    VULK_SCOPED_PROFILER_CATEGORY("FrameRecorder::read()", eLoading);
+
+    std::ifstream input{filePath, std::ios::binary};
+    if (!input)
+        throw FileNotFoundException{filePath};
+
+    FileHeader header{};
+    input.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    if (!input || header.magic != Magic)
+        throw InvalidFormatException{filePath + ": not a frame recording"};
+    if (header.version != s_formatVersion || header.recordSize != sizeof(Record))
+        throw InvalidFormatException{filePath + ": unsupported frame recording version"};
+
+    std::vector<Record> records{};
+    Record record{};
+
+    while (input.read(reinterpret_cast<char*>(&record), sizeof(record)))
+        records.push_back(record);
+
+    return records;
+}
+
+void vulk::FrameRecorder::writeCsv(std::span<const Record> records, std::ostream& os)
+{
+    os << "frame,timestamp_ns,delta_time_ms,cpu_time_ms,gpu_time_ms,draw_count,uploaded_bytes\n";
+
+    const auto toMilliseconds = [](float seconds) { return static_cast<double>(seconds) * 1000.0; };
+
+    for (const auto& record : records)
+    {
+        os << record.frame << ',' << record.timestamp << ',' << toMilliseconds(record.deltaTime) << ','
+           << toMilliseconds(record.cpuTime) << ',' << toMilliseconds(record.gpuTime) << ',' << record.drawCount
+           << ',' << record.uploadedBytes << '\n';
+    }
+}
+
+void vulk::FrameRecorder::convertToCsv(const std::string& recordPath, const std::string& csvPath)
+{
+    const std::vector<Record> records = read(recordPath);
+
+    std::ofstream output{csvPath, std::ios::trunc};
+    if (!output)
+        throw IOException{"Unable to create " + csvPath};
+
+    writeCsv(records, output);
+}
+
+void vulk::FrameRecorder::runWriter()
+{
+    std::unique_lock lock{m_writerMutex};
+
+    while (!m_stopWriter)
+    {
+        m_writerWakeUp.wait_for(lock, WritePeriod, [this] { return m_stopWriter; });
+
+        lock.unlock();
+        writeBuffered();
+        lock.lock();
+    }
+}
+
+void vulk::FrameRecorder::writeBuffered()
+{
+    m_records.consume(
+      [this](const Record& record) { m_output.write(reinterpret_cast<const char*>(&record), sizeof(record)); });
+
+    m_output.flush();
+}
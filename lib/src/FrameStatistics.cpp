@@ -0,0 +1,211 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/FrameStatistics.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+using Milliseconds = std::chrono::duration<float, std::milli>;
+
+constexpr float MinOctave = -4.0f;  // log2 of the lower bound of the first bucket, in milliseconds
+}  // namespace
+
+vulk::FrameStatistics::FrameStatistics(size_t windowSize, Duration budget)
+    : m_frameTimes(windowSize), m_differences(windowSize), m_maxQueue(windowSize), m_budget{budget.count()}
+{
+    assert(windowSize > 0);
+}
+
+void vulk::FrameStatistics::addFrame(Duration frameTime) noexcept
+{
+    const float seconds = frameTime.count();
+    const size_t windowSize = m_frameTimes.size();
+    const size_t slot = m_nextFrame % windowSize;
+
+    // The new frame takes the slot of the oldest one
+    if (m_frameCount == windowSize)
+    {
+        const float oldest = m_frameTimes[slot];
+
+        --m_histogram[getBucket(Duration{oldest})];
+        m_sum -= static_cast<double>(oldest);
+        m_differenceSum -= static_cast<double>(m_differences[slot]);
+
+        if (oldest > m_budget)
+            --m_overBudget;
+
+        if (m_maxQueueSize > 0 && m_maxQueue[m_maxQueueFront] == m_nextFrame - windowSize)
+        {
+            m_maxQueueFront = (m_maxQueueFront + 1) % windowSize;
+            --m_maxQueueSize;
+        }
+    } else
+    {
+        ++m_frameCount;
+    }
+
+    const float previous = m_nextFrame > 0 ? m_frameTimes[(m_nextFrame - 1) % windowSize] : 0.0f;
+    const float difference = m_nextFrame > 0 ? std::abs(seconds - previous) : 0.0f;
+
+    m_frameTimes[slot] = seconds;
+    m_differences[slot] = difference;
+
+    ++m_histogram[getBucket(frameTime)];
+    m_sum += static_cast<double>(seconds);
+    m_differenceSum += static_cast<double>(difference);
+
+    if (seconds > m_budget)
+    {
+        ++m_overBudget;
+        ++m_totalOverBudget;
+    }
+
+    // Frames shorter than this one can't be the max anymore, this one stays in the window longer
+    while (m_maxQueueSize > 0 &&
+           m_frameTimes[m_maxQueue[(m_maxQueueFront + m_maxQueueSize - 1) % windowSize] % windowSize] <= seconds)
+    {
+        --m_maxQueueSize;
+    }
+
+    m_maxQueue[(m_maxQueueFront + m_maxQueueSize) % windowSize] = m_nextFrame;
+    ++m_maxQueueSize;
+
+    ++m_nextFrame;
+}
+
+vulk::Duration vulk::FrameStatistics::getPercentile(float percentile) const noexcept
+{
+    if (m_frameCount == 0)
+        return Duration{};
+
+    const float rank = std::ceil(std::clamp(percentile, 0.0f, 1.0f) * static_cast<float>(m_frameCount));
+    const size_t targetCount = std::max<size_t>(static_cast<size_t>(rank), 1);
+
+    size_t count = 0;
+
+    for (size_t bucket = 0; bucket < s_bucketCount; ++bucket)
+    {
+        count += m_histogram[bucket];
+
+        if (count >= targetCount)
+            return std::min(getBucketLowerBound(bucket + 1), getMax());
+    }
+
+    return getMax();
+}
+
+vulk::Duration vulk::FrameStatistics::getMax() const noexcept
+{
+    if (m_maxQueueSize == 0)
+        return Duration{};
+
+    return Duration{m_frameTimes[m_maxQueue[m_maxQueueFront] % m_frameTimes.size()]};
+}
+
+vulk::Duration vulk::FrameStatistics::getMean() const noexcept
+{
+    if (m_frameCount == 0)
+        return Duration{};
+
+    return Duration{static_cast<float>(m_sum / static_cast<double>(m_frameCount))};
+}
+
+vulk::Duration vulk::FrameStatistics::getJitter() const noexcept
+{
+    if (m_frameCount < 2)
+        return Duration{};
+
+    // The oldest frame's difference is with a frame that already left the window
+    const size_t oldestSlot = (m_nextFrame - m_frameCount) % m_frameTimes.size();
+    const double differenceSum = m_differenceSum - static_cast<double>(m_differences[oldestSlot]);
+
+    return Duration{static_cast<float>(differenceSum / static_cast<double>(m_frameCount - 1))};
+}
+
+vulk::FrameStatistics::Summary vulk::FrameStatistics::getSummary() const noexcept
+{
+    Summary summary{};
+    summary.frameCount = m_frameCount;
+    summary.mean = getMean();
+    summary.p50 = getPercentile(0.50f);
+    summary.p95 = getPercentile(0.95f);
+    summary.p99 = getPercentile(0.99f);
+    summary.max = getMax();
+    summary.jitter = getJitter();
+    summary.overBudget = m_overBudget;
+
+    return summary;
+}
+
+void vulk::FrameStatistics::setBudget(Duration budget) noexcept
+{
+    m_budget = budget.count();
+
+    const size_t windowSize = m_frameTimes.size();
+
+    m_overBudget = 0;
+    for (size_t frame = m_nextFrame - m_frameCount; frame < m_nextFrame; ++frame)
+    {
+        if (m_frameTimes[frame % windowSize] > m_budget)
+            ++m_overBudget;
+    }
+}
+
+vulk::Duration vulk::FrameStatistics::getBucketLowerBound(size_t bucket) noexcept
+{
+    const float octave = MinOctave + static_cast<float>(bucket) / static_cast<float>(s_bucketsPerOctave);
+    return Milliseconds{std::exp2(octave)};
+}
+
+size_t vulk::FrameStatistics::getBucket(Duration frameTime) noexcept
+{
+    const float milliseconds = Milliseconds{frameTime}.count();
+
+    if (!(milliseconds > 0.0f))
+        return 0;
+
+    const float bucket = (std::log2(milliseconds) - MinOctave) * static_cast<float>(s_bucketsPerOctave);
+    return static_cast<size_t>(std::clamp(bucket, 0.0f, static_cast<float>(s_bucketCount - 1)));
+}
+
+void vulk::FrameStatistics::clear() noexcept
+{
+    m_frameCount = 0;
+    m_nextFrame = 0;
+    m_histogram.fill(0);
+    m_maxQueueFront = 0;
+    m_maxQueueSize = 0;
+    m_sum = 0.0;
+    m_differenceSum = 0.0;
+    m_overBudget = 0;
+    m_totalOverBudget = 0;
+}
+
+std::ostream& operator<<(std::ostream& os, const vulk::FrameStatistics::Summary& summary)
+{
+    const auto toMilliseconds = [](vulk::Duration duration) { return Milliseconds{duration}.count(); };
+
+    return os << "p50 " << toMilliseconds(summary.p50) << " ms, p95 " << toMilliseconds(summary.p95) << " ms, p99 "
+              << toMilliseconds(summary.p99) << " ms, max " << toMilliseconds(summary.max) << " ms, jitter "
+              << toMilliseconds(summary.jitter) << " ms, " << summary.overBudget << '/' << summary.frameCount
+              << " frames over budget";
+}
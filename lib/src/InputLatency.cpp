@@ -0,0 +1,65 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/InputLatency.hpp"
+
+vulk::InputLatency::InputLatency(size_t windowSize, Duration budget) : m_statistics{windowSize, budget}
+{
+}
+
+void vulk::InputLatency::onInput(TimePoint arrival) noexcept
+{
+    if (!m_pendingInput || arrival < *m_pendingInput)
+        m_pendingInput = arrival;
+}
+
+void vulk::InputLatency::onFrameSubmitted(uint64_t presentId) noexcept
+{
+    if (presentId == 0 || !m_pendingInput)
+        return;
+
+    // Frames never reported presented would otherwise pile up, e.g. across a swapchain recreation
+    if (m_pendingFrameCount == s_maxPendingFrames)
+    {
+        m_firstPendingFrame = (m_firstPendingFrame + 1) % s_maxPendingFrames;
+        --m_pendingFrameCount;
+    }
+
+    m_pendingFrames[(m_firstPendingFrame + m_pendingFrameCount) % s_maxPendingFrames] = {presentId, *m_pendingInput};
+    ++m_pendingFrameCount;
+
+    m_pendingInput.reset();
+}
+
+void vulk::InputLatency::onFramePresented(const PresentTiming& timing) noexcept
+{
+    while (m_pendingFrameCount > 0)
+    {
+        const PendingFrame& frame = m_pendingFrames[m_firstPendingFrame];
+
+        if (frame.presentId > timing.presentId)
+            break;
+
+        m_lastLatency = timing.presentTime - frame.input;
+        m_statistics.addFrame(m_lastLatency);
+
+        m_firstPendingFrame = (m_firstPendingFrame + 1) % s_maxPendingFrames;
+        --m_pendingFrameCount;
+    }
+}
@@ -34,8 +34,11 @@ vulk::Keyboard::~Keyboard()
 {
 }
 
-void vulk::Keyboard::onKeyPressed(int scancode, int action)
+void vulk::Keyboard::onKeyPressed(int scancode, int action, TimePoint arrival)
 {
+    if (!m_firstEventTime)
+        m_firstEventTime = arrival;
+
     if (action == GLFW_PRESS)
     {
         std::cout << "Key Pressed ! " << std::endl;
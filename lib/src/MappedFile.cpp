@@ -0,0 +1,188 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/MappedFile.hpp"
+
+#include <cerrno>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "Vulk/Exceptions.hpp"
+#include "Vulk/ScopedProfiler.hpp"
+
+#ifdef _WIN32
+vulk::MappedFile::MappedFile(const char* filePath)
+{
+    VULK_SCOPED_PROFILER_CATEGORY("MappedFile::MappedFile()", eLoading);
+
+    m_fileHandle = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (m_fileHandle == INVALID_HANDLE_VALUE)
+    {
+        m_fileHandle = nullptr;
+
+        switch (GetLastError())
+        {
+        case ERROR_FILE_NOT_FOUND:
+        case ERROR_PATH_NOT_FOUND: throw FileNotFoundException(std::string{filePath} + ": file not found");
+        case ERROR_ACCESS_DENIED: throw PermissionDeniedException(std::string{filePath} + ": permission denied");
+        default: throw IOException(std::string{filePath} + ": unable to open file");
+        }
+    }
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(m_fileHandle, &size))
+    {
+        unmap();
+        throw IOException(std::string{filePath} + ": unable to query file size");
+    }
+
+    m_size = static_cast<size_t>(size.QuadPart);
+
+    // Mapping an empty file is an error on Windows, an empty view is all we need
+    if (m_size == 0)
+        return;
+
+    m_mappingHandle = CreateFileMappingA(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mappingHandle)
+        m_data = static_cast<const char*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+
+    if (!m_data)
+    {
+        unmap();
+        throw IOException(std::string{filePath} + ": unable to map file");
+    }
+}
+
+void vulk::MappedFile::unmap() noexcept
+{
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mappingHandle)
+        CloseHandle(m_mappingHandle);
+    if (m_fileHandle)
+        CloseHandle(m_fileHandle);
+
+    m_data = nullptr;
+    m_size = 0;
+    m_mappingHandle = nullptr;
+    m_fileHandle = nullptr;
+}
+#else
+vulk::MappedFile::MappedFile(const char* filePath)
+{
+    VULK_SCOPED_PROFILER_CATEGORY("MappedFile::MappedFile()", eLoading);
+
+    const int fd = ::open(filePath, O_RDONLY);
+
+    if (fd < 0)
+    {
+        switch (errno)
+        {
+        case ENOENT: throw FileNotFoundException(std::string{filePath} + ": file not found");
+        case EACCES: throw PermissionDeniedException(std::string{filePath} + ": permission denied");
+        default: throw IOException(std::string{filePath} + ": unable to open file");
+        }
+    }
+
+    struct stat fileStat
+    {
+    };
+
+    if (::fstat(fd, &fileStat) != 0)
+    {
+        ::close(fd);
+        throw IOException(std::string{filePath} + ": unable to query file size");
+    }
+
+    m_size = static_cast<size_t>(fileStat.st_size);
+
+    if (m_size > 0)
+    {
+        void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (data == MAP_FAILED)
+        {
+            ::close(fd);
+            throw IOException(std::string{filePath} + ": unable to map file");
+        }
+
+        // Parsers read front to back: ask for aggressive read-ahead
+        ::madvise(data, m_size, MADV_SEQUENTIAL);
+        ::madvise(data, m_size, MADV_WILLNEED);
+        m_data = static_cast<const char*>(data);
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+}
+
+void vulk::MappedFile::unmap() noexcept
+{
+    if (m_data)
+        ::munmap(const_cast<char*>(m_data), m_size);
+
+    m_data = nullptr;
+    m_size = 0;
+}
+#endif
+
+vulk::MappedFile::~MappedFile()
+{
+    unmap();
+}
+
+vulk::MappedFile::MappedFile(MappedFile&& rhs) noexcept
+    : m_data{std::exchange(rhs.m_data, nullptr)}, m_size{std::exchange(rhs.m_size, 0)}
+#ifdef _WIN32
+    ,
+      m_fileHandle{std::exchange(rhs.m_fileHandle, nullptr)},
+      m_mappingHandle{std::exchange(rhs.m_mappingHandle, nullptr)}
+#endif
+{
+}
+
+vulk::MappedFile& vulk::MappedFile::operator=(MappedFile&& rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        unmap();
+
+        m_data = std::exchange(rhs.m_data, nullptr);
+        m_size = std::exchange(rhs.m_size, 0);
+#ifdef _WIN32
+        m_fileHandle = std::exchange(rhs.m_fileHandle, nullptr);
+        m_mappingHandle = std::exchange(rhs.m_mappingHandle, nullptr);
+#endif
+    }
+
+    return *this;
+}
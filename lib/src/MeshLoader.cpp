@@ -0,0 +1,729 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/MeshLoader.hpp"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+#include "Vulk/Exceptions.hpp"
+#include "Vulk/ScopedProfiler.hpp"
+
+// glTF 2.0 constants, see https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html
+static constexpr uint32_t GlbMagic = 0x46546C67;      // "glTF"
+static constexpr uint32_t GlbChunkJson = 0x4E4F534A;  // "JSON"
+static constexpr uint32_t GlbChunkBin = 0x004E4942;   // "BIN\0"
+static constexpr uint32_t GltfUnsignedByte = 5121;
+static constexpr uint32_t GltfUnsignedShort = 5123;
+static constexpr uint32_t GltfUnsignedInt = 5125;
+static constexpr uint32_t GltfFloat = 5126;
+static constexpr uint64_t GltfModeTriangles = 4;
+
+namespace {
+struct GltfAccessor
+{
+    const char* data{nullptr};  // first element, inside the mapped binary chunk
+    size_t stride{0};
+    uint32_t count{0};
+    uint32_t componentType{0};
+    uint32_t componentCount{0};
+    bool normalized{false};
+
+    [[nodiscard]] bool isValid() const noexcept { return data != nullptr; }
+};
+
+struct GltfPrimitive
+{
+    GltfAccessor position{};
+    GltfAccessor color{};
+    GltfAccessor indices{};
+};
+}  // namespace
+
+[[noreturn]] static void throwMalformed(const char* what)
+{
+    throw vulk::InvalidFormatException(std::string{"malformed mesh file: "} + what);
+}
+
+template<typename T>
+static T readUnaligned(const char* data) noexcept
+{
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+namespace {
+/**
+ * Read-only view over a JSON value, navigated lazily without building a DOM.
+ * glTF headers are small, but this keeps the loader allocation-free on the metadata too.
+ */
+class JsonView
+{
+public:
+    JsonView() = default;
+    explicit JsonView(std::string_view text) : m_text{text} {}
+
+    [[nodiscard]] bool isValid() const noexcept { return !m_text.empty(); }
+
+    // Returns an invalid view when the key is missing
+    [[nodiscard]] JsonView operator[](std::string_view key) const
+    {
+        JsonView result{};
+
+        forEachElement('{', '}', [&](std::string_view text, size_t pos) {
+            const size_t keyEnd = skipString(text, pos);
+            const auto currentKey = text.substr(pos + 1, keyEnd - pos - 2);
+
+            pos = skipWhitespace(text, keyEnd);
+            if (pos >= text.size() || text[pos] != ':')
+                throwMalformed("expected ':' in JSON object");
+
+            pos = skipWhitespace(text, pos + 1);
+            if (currentKey == key)
+                result = JsonView{text.substr(pos)};
+
+            return skipValue(text, pos);
+        });
+
+        return result;
+    }
+
+    // Returns an invalid view when out of bounds
+    [[nodiscard]] JsonView operator[](size_t index) const
+    {
+        JsonView result{};
+        size_t current = 0;
+
+        forEachElement('[', ']', [&](std::string_view text, size_t pos) {
+            if (current++ == index)
+                result = JsonView{text.substr(pos)};
+
+            return skipValue(text, pos);
+        });
+
+        return result;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        size_t count = 0;
+
+        forEachElement('[', ']', [&](std::string_view text, size_t pos) {
+            ++count;
+            return skipValue(text, pos);
+        });
+
+        return count;
+    }
+
+    [[nodiscard]] uint64_t asUint(uint64_t fallback) const
+    {
+        if (!isValid())
+            return fallback;
+
+        uint64_t value{};
+        const auto [end, error] = std::from_chars(m_text.data(), m_text.data() + m_text.size(), value);
+
+        if (error != std::errc{})
+            throwMalformed("expected an unsigned integer in JSON");
+
+        return value;
+    }
+
+    [[nodiscard]] bool asBool(bool fallback) const
+    {
+        if (!isValid())
+            return fallback;
+
+        return m_text.substr(0, 4) == "true";
+    }
+
+    [[nodiscard]] std::string_view asString() const
+    {
+        if (!isValid() || m_text[0] != '"')
+            return {};
+
+        return m_text.substr(1, skipString(m_text, 0) - 2);
+    }
+
+private:
+    static size_t skipWhitespace(std::string_view text, size_t pos) noexcept
+    {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\n' || text[pos] == '\r' || text[pos] == '\t'))
+            ++pos;
+        return pos;
+    }
+
+    // `pos` is on the opening quote, returns the position after the closing quote
+    static size_t skipString(std::string_view text, size_t pos)
+    {
+        for (++pos; pos < text.size(); ++pos)
+        {
+            if (text[pos] == '\\')
+                ++pos;
+            else if (text[pos] == '"')
+                return pos + 1;
+        }
+
+        throwMalformed("unterminated JSON string");
+    }
+
+    static size_t skipValue(std::string_view text, size_t pos)
+    {
+        if (pos >= text.size())
+            throwMalformed("unexpected end of JSON");
+
+        if (text[pos] == '"')
+            return skipString(text, pos);
+
+        if (text[pos] == '{' || text[pos] == '[')
+        {
+            size_t depth = 0;
+
+            while (pos < text.size())
+            {
+                const char c = text[pos];
+
+                if (c == '"')
+                {
+                    pos = skipString(text, pos);
+                    continue;
+                }
+
+                if (c == '{' || c == '[')
+                    ++depth;
+                else if ((c == '}' || c == ']') && --depth == 0)
+                    return pos + 1;
+
+                ++pos;
+            }
+
+            throwMalformed("unterminated JSON object or array");
+        }
+
+        // number, true, false or null
+        while (pos < text.size() && text[pos] != ',' && text[pos] != '}' && text[pos] != ']' && text[pos] != ' ' &&
+               text[pos] != '\n' && text[pos] != '\r' && text[pos] != '\t')
+            ++pos;
+
+        return pos;
+    }
+
+    // Calls `func(text, elementPos)` for each element of the object or array, `func` returns the element end
+    template<typename Func>
+    void forEachElement(char open, char close, Func&& func) const
+    {
+        if (!isValid() || m_text[0] != open)
+            return;
+
+        size_t pos = skipWhitespace(m_text, 1);
+
+        if (pos < m_text.size() && m_text[pos] == close)
+            return;
+
+        while (pos < m_text.size())
+        {
+            pos = skipWhitespace(m_text, func(m_text, pos));
+
+            if (pos >= m_text.size())
+                break;
+            if (m_text[pos] == close)
+                return;
+            if (m_text[pos] != ',')
+                throwMalformed("expected ',' in JSON");
+
+            pos = skipWhitespace(m_text, pos + 1);
+        }
+
+        throwMalformed("unexpected end of JSON");
+    }
+
+    std::string_view m_text{};
+};
+}  // namespace
+
+static uint32_t componentSize(uint32_t componentType)
+{
+    switch (componentType)
+    {
+    case 5120:  // byte
+    case GltfUnsignedByte: return 1;
+    case 5122:  // short
+    case GltfUnsignedShort: return 2;
+    case GltfUnsignedInt:
+    case GltfFloat: return 4;
+    default: throwMalformed("unknown glTF component type");
+    }
+}
+
+static uint32_t componentCount(std::string_view type)
+{
+    if (type == "SCALAR")
+        return 1;
+    if (type == "VEC2")
+        return 2;
+    if (type == "VEC3")
+        return 3;
+    if (type == "VEC4")
+        return 4;
+
+    throwMalformed("unsupported glTF accessor type");
+}
+
+static float readComponent(const GltfAccessor& accessor, uint32_t element, uint32_t component)
+{
+    const char* data = accessor.data + accessor.stride * element;
+
+    switch (accessor.componentType)
+    {
+    case GltfFloat: return readUnaligned<float>(data + component * sizeof(float));
+    case GltfUnsignedByte:
+    {
+        const auto value = static_cast<float>(readUnaligned<uint8_t>(data + component));
+        return accessor.normalized ? value / 255.f : value;
+    }
+    case GltfUnsignedShort:
+    {
+        const auto value = static_cast<float>(readUnaligned<uint16_t>(data + component * sizeof(uint16_t)));
+        return accessor.normalized ? value / 65535.f : value;
+    }
+    default: throwMalformed("unsupported glTF vertex component type");
+    }
+}
+
+static uint32_t readIndex(const GltfAccessor& accessor, uint32_t element)
+{
+    const char* data = accessor.data + accessor.stride * element;
+
+    switch (accessor.componentType)
+    {
+    case GltfUnsignedByte: return readUnaligned<uint8_t>(data);
+    case GltfUnsignedShort: return readUnaligned<uint16_t>(data);
+    case GltfUnsignedInt: return readUnaligned<uint32_t>(data);
+    default: throwMalformed("unsupported glTF index component type");
+    }
+}
+
+static GltfAccessor resolveAccessor(const JsonView& json, std::string_view bin, const JsonView& index)
+{
+    GltfAccessor result{};
+
+    if (!index.isValid())
+        return result;
+
+    const auto accessor = json["accessors"][index.asUint(0)];
+    if (!accessor.isValid())
+        throwMalformed("glTF accessor index out of range");
+
+    // Sparse or zero-initialized accessors don't reference a buffer view
+    const auto bufferView = json["bufferViews"][accessor["bufferView"].asUint(std::numeric_limits<uint64_t>::max())];
+    if (!bufferView.isValid())
+        throwMalformed("glTF accessors without a buffer view are not supported");
+    if (bufferView["buffer"].asUint(0) != 0)
+        throwMalformed("only the GLB binary chunk is supported as a glTF buffer");
+
+    result.componentType = static_cast<uint32_t>(accessor["componentType"].asUint(0));
+    result.componentCount = componentCount(accessor["type"].asString());
+    result.count = static_cast<uint32_t>(accessor["count"].asUint(0));
+    result.normalized = accessor["normalized"].asBool(false);
+
+    const uint64_t elementSize = uint64_t{componentSize(result.componentType)} * result.componentCount;
+    const uint64_t viewOffset = bufferView["byteOffset"].asUint(0);
+    const uint64_t viewLength = bufferView["byteLength"].asUint(0);
+    const uint64_t accessorOffset = accessor["byteOffset"].asUint(0);
+    const uint64_t stride = bufferView["byteStride"].asUint(elementSize);
+
+    // Written so that nothing wraps around, whatever the file says
+    if (viewOffset > bin.size() || viewLength > bin.size() - viewOffset)
+        throwMalformed("glTF buffer view out of the binary chunk");
+
+    if (result.count > 0)
+    {
+        if (accessorOffset > viewLength || elementSize > viewLength - accessorOffset)
+            throwMalformed("glTF accessor out of its buffer view");
+
+        const uint64_t lastElementRange = viewLength - accessorOffset - elementSize;
+        if (stride > 0 && result.count - 1 > lastElementRange / stride)
+            throwMalformed("glTF accessor out of its buffer view");
+    }
+
+    result.data = bin.data() + viewOffset + accessorOffset;
+    result.stride = static_cast<size_t>(stride);
+
+    return result;
+}
+
+// Resolves every triangle primitive of every mesh, in order. Metadata is re-parsed on each call: it is tiny
+// compared to the geometry and keeps the loader free of intermediate storage.
+template<typename Func>
+static void forEachGltfPrimitive(std::string_view file, Func&& func)
+{
+    // Header: magic, version, length. Then chunks: length, type, data (4-byte aligned)
+    if (file.size() < 20 || readUnaligned<uint32_t>(file.data() + 4) != 2)
+        throwMalformed("unsupported GLB version");
+
+    const auto jsonLength = readUnaligned<uint32_t>(file.data() + 12);
+    if (readUnaligned<uint32_t>(file.data() + 16) != GlbChunkJson || 20 + uint64_t{jsonLength} > file.size())
+        throwMalformed("missing GLB JSON chunk");
+
+    const JsonView json{file.substr(20, jsonLength)};
+    std::string_view bin{};
+
+    const size_t binHeader = 20 + size_t{jsonLength};
+    if (binHeader + 8 <= file.size() && readUnaligned<uint32_t>(file.data() + binHeader + 4) == GlbChunkBin)
+    {
+        const auto binLength = readUnaligned<uint32_t>(file.data() + binHeader);
+        if (binHeader + 8 + uint64_t{binLength} > file.size())
+            throwMalformed("truncated GLB binary chunk");
+
+        bin = file.substr(binHeader + 8, binLength);
+    }
+
+    const auto meshes = json["meshes"];
+    for (size_t meshIndex = 0, meshCount = meshes.size(); meshIndex < meshCount; ++meshIndex)
+    {
+        const auto primitives = meshes[meshIndex]["primitives"];
+
+        for (size_t primitiveIndex = 0, count = primitives.size(); primitiveIndex < count; ++primitiveIndex)
+        {
+            const auto primitive = primitives[primitiveIndex];
+
+            // Points and lines can't go through the triangle list pipeline
+            if (primitive["mode"].asUint(GltfModeTriangles) != GltfModeTriangles)
+                continue;
+
+            const auto attributes = primitive["attributes"];
+            const GltfPrimitive result{resolveAccessor(json, bin, attributes["POSITION"]),
+                                       resolveAccessor(json, bin, attributes["COLOR_0"]),
+                                       resolveAccessor(json, bin, primitive["indices"])};
+
+            if (!result.position.isValid() || result.position.componentCount < 2)
+                throwMalformed("glTF primitive without positions");
+            const auto& color = result.color;
+            if (color.isValid() && (color.componentCount < 3 || color.count < result.position.count))
+                throwMalformed("invalid glTF vertex colors");
+            if (result.indices.isValid() && result.indices.componentCount != 1)
+                throwMalformed("invalid glTF indices");
+
+            func(result);
+        }
+    }
+}
+
+static size_t skipBlanks(std::string_view text, size_t pos) noexcept
+{
+    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t'))
+        ++pos;
+    return pos;
+}
+
+// Minimal locale-independent float parser, works on non null-terminated mapped memory
+static bool parseFloat(std::string_view text, size_t& pos, float& out) noexcept
+{
+    static constexpr uint64_t MantissaLimit = 100'000'000'000'000'000ull;
+
+    pos = skipBlanks(text, pos);
+
+    bool negative = false;
+    if (pos < text.size() && (text[pos] == '-' || text[pos] == '+'))
+        negative = text[pos++] == '-';
+
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    size_t digits = 0;
+
+    for (; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos, ++digits)
+    {
+        if (mantissa < MantissaLimit)
+            mantissa = mantissa * 10 + static_cast<uint64_t>(text[pos] - '0');
+        else
+            ++exponent;
+    }
+
+    if (pos < text.size() && text[pos] == '.')
+    {
+        for (++pos; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos, ++digits)
+        {
+            if (mantissa < MantissaLimit)
+            {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(text[pos] - '0');
+                --exponent;
+            }
+        }
+    }
+
+    if (digits == 0)
+        return false;
+
+    if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E'))
+    {
+        int exponentValue = 0;
+        const char* begin = text.data() + pos + 1;
+
+        if (begin < text.data() + text.size() && *begin == '+')
+            ++begin;
+
+        const auto [end, error] = std::from_chars(begin, text.data() + text.size(), exponentValue);
+        if (error != std::errc{})
+            return false;
+
+        exponent += exponentValue;
+        pos = static_cast<size_t>(end - text.data());
+    }
+
+    const double value = static_cast<double>(mantissa) * std::pow(10.0, exponent);
+    out = static_cast<float>(negative ? -value : value);
+
+    return true;
+}
+
+// Parses the position part of an OBJ face element (`v`, `v/vt`, `v//vn` or `v/vt/vn`)
+static bool parseFaceIndex(std::string_view text, size_t& pos, int64_t& out) noexcept
+{
+    pos = skipBlanks(text, pos);
+
+    const auto [end, error] = std::from_chars(text.data() + pos, text.data() + text.size(), out);
+    if (error != std::errc{})
+        return false;
+
+    pos = static_cast<size_t>(end - text.data());
+
+    // Skip texture coordinate and normal references
+    while (pos < text.size() && text[pos] != ' ' && text[pos] != '\t')
+        ++pos;
+
+    return true;
+}
+
+template<typename Func>
+static void forEachLine(std::string_view text, Func&& func)
+{
+    size_t start = 0;
+
+    while (start < text.size())
+    {
+        size_t end = text.find('\n', start);
+        if (end == std::string_view::npos)
+            end = text.size();
+
+        auto line = text.substr(start, end - start);
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+
+        const size_t first = skipBlanks(line, 0);
+        if (first + 1 < line.size())
+            func(line.substr(first));
+
+        start = end + 1;
+    }
+}
+
+static bool isObjStatement(std::string_view line, char statement) noexcept
+{
+    return line[0] == statement && (line[1] == ' ' || line[1] == '\t');
+}
+
+vulk::MeshLoader::MeshLoader(const char* filePath) : m_file{filePath}
+{
+    VULK_SCOPED_PROFILER_CATEGORY("MeshLoader::MeshLoader()", eLoading);
+
+    const auto view = m_file.getView();
+    const std::string_view path{filePath};
+
+    if (view.size() >= sizeof(uint32_t) && readUnaligned<uint32_t>(view.data()) == GlbMagic)
+    {
+        m_format = Format::eGlb;
+        countGlb();
+    } else if (path.size() >= 4 && (path.substr(path.size() - 4) == ".obj" || path.substr(path.size() - 4) == ".OBJ"))
+    {
+        m_format = Format::eObj;
+        countObj();
+    } else
+    {
+        throw InvalidFormatException(std::string{filePath} + ": unsupported mesh format, expected .glb or .obj");
+    }
+}
+
+void vulk::MeshLoader::countObj()
+{
+    uint64_t vertexCount = 0;
+    uint64_t indexCount = 0;
+
+    forEachLine(m_file.getView(), [&](std::string_view line) {
+        if (isObjStatement(line, 'v'))
+        {
+            ++vertexCount;
+        } else if (isObjStatement(line, 'f'))
+        {
+            size_t pos = 1;
+            size_t corners = 0;
+            int64_t index{};
+
+            while (parseFaceIndex(line, pos, index))
+                ++corners;
+
+            if (corners < 3)
+                throwMalformed("OBJ face with less than 3 vertices");
+
+            indexCount += 3 * (corners - 2);  // triangle fan
+        }
+    });
+
+    if (vertexCount > std::numeric_limits<uint32_t>::max() || indexCount > std::numeric_limits<uint32_t>::max())
+        throwMalformed("mesh too large");
+
+    m_vertexCount = static_cast<uint32_t>(vertexCount);
+    m_indexCount = static_cast<uint32_t>(indexCount);
+}
+
+void vulk::MeshLoader::countGlb()
+{
+    uint64_t vertexCount = 0;
+    uint64_t indexCount = 0;
+
+    forEachGltfPrimitive(m_file.getView(), [&](const GltfPrimitive& primitive) {
+        vertexCount += primitive.position.count;
+        indexCount += primitive.indices.isValid() ? primitive.indices.count : primitive.position.count;
+    });
+
+    if (vertexCount > std::numeric_limits<uint32_t>::max() || indexCount > std::numeric_limits<uint32_t>::max())
+        throwMalformed("mesh too large");
+
+    m_vertexCount = static_cast<uint32_t>(vertexCount);
+    m_indexCount = static_cast<uint32_t>(indexCount);
+}
+
+void vulk::MeshLoader::write(Vertex* vertices, uint16_t* indices) const
+{
+    assert(!needsUint32Indices());
+
+    if (m_format == Format::eGlb)
+        writeGlb(vertices, indices);
+    else
+        writeObj(vertices, indices);
+}
+
+void vulk::MeshLoader::write(Vertex* vertices, uint32_t* indices) const
+{
+    if (m_format == Format::eGlb)
+        writeGlb(vertices, indices);
+    else
+        writeObj(vertices, indices);
+}
+
+template<typename IndexType>
+void vulk::MeshLoader::writeObj(Vertex* vertices, IndexType* indices) const
+{
+    VULK_SCOPED_PROFILER_CATEGORY("MeshLoader::writeObj()", eLoading);
+
+    uint32_t vertexCount = 0;
+
+    forEachLine(m_file.getView(), [&](std::string_view line) {
+        if (isObjStatement(line, 'v'))
+        {
+            size_t pos = 1;
+            std::array<float, 6> values{0.f, 0.f, 0.f, 1.f, 1.f, 1.f};  // x y z [r g b]
+
+            for (auto& value : values)
+            {
+                if (!parseFloat(line, pos, value))
+                    break;
+            }
+
+            vertices[vertexCount++] = Vertex{{values[0], values[1]}, {values[3], values[4], values[5]}};
+        } else if (isObjStatement(line, 'f'))
+        {
+            size_t pos = 1;
+            size_t corner = 0;
+            int64_t reference{};
+            IndexType first{};
+            IndexType previous{};
+
+            while (parseFaceIndex(line, pos, reference))
+            {
+                // Positive references are 1-based, negative ones are relative to the last parsed vertex
+                const int64_t resolved = reference > 0 ? reference - 1 : int64_t{vertexCount} + reference;
+
+                if (reference == 0 || resolved < 0 || resolved >= int64_t{m_vertexCount})
+                    throwMalformed("OBJ face references a missing vertex");
+
+                const auto current = static_cast<IndexType>(resolved);
+
+                if (corner == 0)
+                    first = current;
+
+                if (corner >= 2)
+                {
+                    *indices++ = first;
+                    *indices++ = previous;
+                    *indices++ = current;
+                }
+
+                previous = current;
+                ++corner;
+            }
+        }
+    });
+}
+
+template<typename IndexType>
+void vulk::MeshLoader::writeGlb(Vertex* vertices, IndexType* indices) const
+{
+    VULK_SCOPED_PROFILER_CATEGORY("MeshLoader::writeGlb()", eLoading);
+
+    uint32_t baseVertex = 0;
+
+    forEachGltfPrimitive(m_file.getView(), [&](const GltfPrimitive& primitive) {
+        const auto& position = primitive.position;
+        const auto& color = primitive.color;
+
+        for (uint32_t i = 0; i < position.count; ++i)
+        {
+            const glm::vec2 xy{readComponent(position, i, 0), readComponent(position, i, 1)};
+            const glm::vec3 rgb = color.isValid() ? glm::vec3{readComponent(color, i, 0), readComponent(color, i, 1),
+                                                              readComponent(color, i, 2)}
+                                                  : glm::vec3{1.f};
+
+            vertices[baseVertex + i] = Vertex{xy, rgb};
+        }
+
+        if (primitive.indices.isValid())
+        {
+            for (uint32_t i = 0; i < primitive.indices.count; ++i)
+            {
+                const uint32_t index = readIndex(primitive.indices, i);
+
+                if (index >= position.count)
+                    throwMalformed("glTF index out of range");
+
+                *indices++ = static_cast<IndexType>(baseVertex + index);
+            }
+        } else
+        {
+            for (uint32_t i = 0; i < position.count; ++i)
+                *indices++ = static_cast<IndexType>(baseVertex + i);
+        }
+
+        baseVertex += position.count;
+    });
+}
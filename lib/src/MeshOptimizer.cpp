@@ -0,0 +1,455 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+#include "Vulk/ScopedProfiler.hpp"
+
+namespace {
+// Forsyth's tuning values, the cache size here is the modelled LRU one, not the hardware FIFO
+constexpr uint32_t ScoringCacheSize = 32;
+constexpr float CacheDecayPower = 1.5f;
+constexpr float LastTriangleScore = 0.75f;
+constexpr float ValenceBoostScale = 2.f;
+constexpr float ValenceBoostPower = 0.5f;
+
+constexpr uint32_t InvalidIndex = ~0u;
+
+float computeVertexScore(uint32_t cachePosition, uint32_t liveTriangles) noexcept
+{
+    if (liveTriangles == 0)
+        return -1.f;
+
+    float score = 0.f;
+
+    if (cachePosition < 3)
+    {
+        // The last triangle's vertices get a fixed score so its neighbours aren't favoured over the strip
+        score = LastTriangleScore;
+    } else if (cachePosition < ScoringCacheSize)
+    {
+        const float scaler = 1.f / static_cast<float>(ScoringCacheSize - 3);
+        score = std::pow(1.f - static_cast<float>(cachePosition - 3) * scaler, CacheDecayPower);
+    }
+
+    // Vertices with few triangles left are boosted to get rid of them and avoid lone triangles
+    return score + ValenceBoostScale * std::pow(static_cast<float>(liveTriangles), -ValenceBoostPower);
+}
+
+/**
+ * Simulates a FIFO cache and returns the number of misses for a triangle range, the cache is reset first.
+ */
+template<typename IndexType>
+uint32_t countCacheMisses(std::span<const IndexType> indices, size_t firstTriangle, size_t lastTriangle,
+                          std::vector<uint32_t>& timestamps, uint32_t& time, uint32_t cacheSize)
+{
+    // Entries older than `cacheSize` misses are out of the cache, bumping the start time resets everything
+    time += cacheSize + 1;
+
+    uint32_t misses = 0;
+
+    for (size_t i = firstTriangle * 3; i < lastTriangle * 3; ++i)
+    {
+        const auto vertex = static_cast<uint32_t>(indices[i]);
+
+        if (time - timestamps[vertex] > cacheSize)
+        {
+            timestamps[vertex] = time++;
+            ++misses;
+        }
+    }
+
+    return misses;
+}
+}  // namespace
+
+template<typename IndexType>
+vulk::mesh::VertexCacheStatistics vulk::mesh::analyzeVertexCache(std::span<const IndexType> indices,
+                                                                 uint32_t vertexCount, uint32_t cacheSize)
+{
+    VULK_SCOPED_PROFILER_CATEGORY("mesh::analyzeVertexCache()", eLoading);
+
+    assert(indices.size() % 3 == 0);
+
+    VertexCacheStatistics statistics{};
+
+    if (indices.empty() || vertexCount == 0)
+        return statistics;
+
+    std::vector<uint32_t> timestamps(vertexCount, 0);
+    uint32_t time = 0;
+
+    statistics.vertexTransforms = countCacheMisses(indices, 0, indices.size() / 3, timestamps, time, cacheSize);
+    statistics.acmr = static_cast<float>(statistics.vertexTransforms) / static_cast<float>(indices.size() / 3);
+    statistics.atvr = static_cast<float>(statistics.vertexTransforms) / static_cast<float>(vertexCount);
+
+    return statistics;
+}
+
+template<typename IndexType>
+void vulk::mesh::optimizeVertexCache(std::span<IndexType> indices, uint32_t vertexCount)
+{
+    VULK_SCOPED_PROFILER_CATEGORY("mesh::optimizeVertexCache()", eLoading);
+
+    assert(indices.size() % 3 == 0);
+
+    const size_t triangleCount = indices.size() / 3;
+
+    if (triangleCount == 0)
+        return;
+
+    // Vertex to triangles adjacency, as one flat array with per vertex offsets
+    std::vector<uint32_t> liveTriangles(vertexCount, 0);
+
+    for (const IndexType index : indices)
+        ++liveTriangles[index];
+
+    std::vector<uint32_t> adjacencyOffsets(static_cast<size_t>(vertexCount) + 1, 0);
+    std::partial_sum(liveTriangles.begin(), liveTriangles.end(), adjacencyOffsets.begin() + 1);
+
+    std::vector<uint32_t> adjacency(indices.size());
+
+    {
+        std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+
+        for (size_t i = 0; i < indices.size(); ++i)
+            adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    std::vector<uint32_t> cachePositions(vertexCount, InvalidIndex);
+    std::vector<float> vertexScores(vertexCount);
+
+    for (uint32_t v = 0; v < vertexCount; ++v)
+        vertexScores[v] = computeVertexScore(InvalidIndex, liveTriangles[v]);
+
+    std::vector<float> triangleScores(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        triangleScores[t] =
+          vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+    }
+
+    std::vector<IndexType> output(indices.size());
+
+    // Room for the 3 new vertices before trimming back to the modelled size
+    std::array<uint32_t, ScoringCacheSize + 3> cache{};
+    std::array<uint32_t, ScoringCacheSize + 3> nextCache{};
+    uint32_t cacheCount = 0;
+
+    size_t deadEndCursor = 0;
+    auto bestTriangle = static_cast<size_t>(std::max_element(triangleScores.begin(), triangleScores.end()) -
+                                            triangleScores.begin());
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+    {
+        if (bestTriangle == InvalidIndex)
+        {
+            // Dead end: nothing in the cache has triangles left, restart from the input order
+            while (emitted[deadEndCursor])
+                ++deadEndCursor;
+
+            bestTriangle = deadEndCursor;
+        }
+
+        const IndexType* triangle = &indices[bestTriangle * 3];
+
+        std::copy_n(triangle, 3, &output[emittedCount * 3]);
+        emitted[bestTriangle] = true;
+
+        // Remove the triangle from its vertices' adjacency, live triangles are kept at the front of each range
+        for (size_t i = 0; i < 3; ++i)
+        {
+            const uint32_t v = triangle[i];
+            uint32_t* first = &adjacency[adjacencyOffsets[v]];
+            uint32_t* last = first + liveTriangles[v];
+
+            std::iter_swap(std::find(first, last, static_cast<uint32_t>(bestTriangle)), last - 1);
+            --liveTriangles[v];
+        }
+
+        // Move the triangle's vertices to the front of the LRU cache
+        uint32_t nextCacheCount = 0;
+
+        for (size_t i = 0; i < 3; ++i)
+            nextCache[nextCacheCount++] = triangle[i];
+
+        for (uint32_t i = 0; i < cacheCount; ++i)
+        {
+            const uint32_t v = cache[i];
+
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+                nextCache[nextCacheCount++] = v;
+        }
+
+        for (uint32_t i = ScoringCacheSize; i < nextCacheCount; ++i)
+        {
+            const uint32_t evicted = nextCache[i];
+
+            cachePositions[evicted] = InvalidIndex;
+            vertexScores[evicted] = computeVertexScore(InvalidIndex, liveTriangles[evicted]);
+        }
+
+        cacheCount = std::min(nextCacheCount, ScoringCacheSize);
+        std::swap(cache, nextCache);
+
+        // Only triangles touching the cache changed score, the best next one is picked among them
+        for (uint32_t i = 0; i < cacheCount; ++i)
+        {
+            const uint32_t v = cache[i];
+
+            cachePositions[v] = i;
+            vertexScores[v] = computeVertexScore(i, liveTriangles[v]);
+        }
+
+        bestTriangle = InvalidIndex;
+        float bestScore = -1.f;
+
+        for (uint32_t i = 0; i < cacheCount; ++i)
+        {
+            const uint32_t v = cache[i];
+            const uint32_t first = adjacencyOffsets[v];
+
+            for (uint32_t j = first; j < first + liveTriangles[v]; ++j)
+            {
+                const uint32_t t = adjacency[j];
+                const float score = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] +
+                                    vertexScores[indices[t * 3 + 2]];
+
+                triangleScores[t] = score;
+
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    bestTriangle = t;
+                }
+            }
+        }
+    }
+
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+template<typename IndexType>
+void vulk::mesh::optimizeOverdraw(std::span<IndexType> indices, std::span<const glm::vec3> positions, float threshold)
+{
+    VULK_SCOPED_PROFILER_CATEGORY("mesh::optimizeOverdraw()", eLoading);
+
+    assert(indices.size() % 3 == 0);
+
+    constexpr uint32_t CacheSize = 16;
+
+    const size_t triangleCount = indices.size() / 3;
+
+    if (triangleCount == 0)
+        return;
+
+    const std::span<const IndexType> constIndices{indices};
+    std::vector<uint32_t> timestamps(positions.size(), 0);
+    uint32_t time = 0;
+
+    // Hard boundaries: triangles where the cache restarted, i.e. all 3 vertices missed
+    std::vector<size_t> hardClusters{0};
+
+    time += CacheSize + 1;
+
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        uint32_t misses = 0;
+
+        for (size_t i = t * 3; i < t * 3 + 3; ++i)
+        {
+            const auto vertex = static_cast<uint32_t>(indices[i]);
+
+            if (time - timestamps[vertex] > CacheSize)
+            {
+                timestamps[vertex] = time++;
+                ++misses;
+            }
+        }
+
+        if (t > 0 && misses == 3)
+            hardClusters.push_back(t);
+    }
+
+    hardClusters.push_back(triangleCount);
+
+    // Soft boundaries: split hard clusters wherever the running miss ratio is close enough to the whole cluster's
+    std::vector<size_t> clusters{};
+
+    for (size_t c = 0; c + 1 < hardClusters.size(); ++c)
+    {
+        const size_t start = hardClusters[c];
+        const size_t end = hardClusters[c + 1];
+
+        const float clusterAcmr = static_cast<float>(countCacheMisses(constIndices, start, end, timestamps, time,
+                                                                      CacheSize)) /
+                                  static_cast<float>(end - start);
+
+        time += CacheSize + 1;
+
+        size_t clusterStart = start;
+        uint32_t misses = 0;
+
+        clusters.push_back(start);
+
+        for (size_t t = start; t < end; ++t)
+        {
+            for (size_t i = t * 3; i < t * 3 + 3; ++i)
+            {
+                const auto vertex = static_cast<uint32_t>(indices[i]);
+
+                if (time - timestamps[vertex] > CacheSize)
+                {
+                    timestamps[vertex] = time++;
+                    ++misses;
+                }
+            }
+
+            const auto clusterTriangles = static_cast<float>(t + 1 - clusterStart);
+
+            if (t + 1 < end && static_cast<float>(misses) / clusterTriangles <= threshold * clusterAcmr)
+            {
+                clusterStart = t + 1;
+                misses = 0;
+                time += CacheSize + 1;
+                clusters.push_back(clusterStart);
+            }
+        }
+    }
+
+    clusters.push_back(triangleCount);
+
+    // Sort key: how much the cluster faces away from the mesh centroid, outer surfaces are drawn first
+    glm::vec3 meshCentroid{0.f};
+
+    for (const IndexType index : indices)
+        meshCentroid += positions[index];
+
+    meshCentroid /= static_cast<float>(indices.size());
+
+    const size_t clusterCount = clusters.size() - 1;
+    std::vector<float> sortKeys(clusterCount);
+
+    for (size_t c = 0; c < clusterCount; ++c)
+    {
+        glm::vec3 centroid{0.f};
+        glm::vec3 normal{0.f};
+        float area = 0.f;
+
+        for (size_t t = clusters[c]; t < clusters[c + 1]; ++t)
+        {
+            const glm::vec3 a = positions[indices[t * 3]];
+            const glm::vec3 b = positions[indices[t * 3 + 1]];
+            const glm::vec3 d = positions[indices[t * 3 + 2]];
+
+            const glm::vec3 cross = glm::cross(b - a, d - a);
+            const float triangleArea = glm::length(cross);
+
+            centroid += (a + b + d) * (triangleArea / 3.f);
+            normal += cross;
+            area += triangleArea;
+        }
+
+        const float normalLength = glm::length(normal);
+
+        if (area > 0.f && normalLength > 0.f)
+            sortKeys[c] = glm::dot(centroid / area - meshCentroid, normal / normalLength);
+        else
+            sortKeys[c] = 0.f;
+    }
+
+    std::vector<size_t> order(clusterCount);
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) { return sortKeys[lhs] > sortKeys[rhs]; });
+
+    std::vector<IndexType> output{};
+    output.reserve(indices.size());
+
+    for (const size_t c : order)
+        output.insert(output.end(), indices.begin() + static_cast<ptrdiff_t>(clusters[c] * 3),
+                      indices.begin() + static_cast<ptrdiff_t>(clusters[c + 1] * 3));
+
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+template<typename IndexType>
+uint32_t vulk::mesh::optimizeVertexFetch(std::span<Vertex> vertices, std::span<IndexType> indices)
+{
+    VULK_SCOPED_PROFILER_CATEGORY("mesh::optimizeVertexFetch()", eLoading);
+
+    std::vector<uint32_t> remap(vertices.size(), InvalidIndex);
+    std::vector<Vertex> reordered{};
+    reordered.reserve(vertices.size());
+
+    for (IndexType& index : indices)
+    {
+        uint32_t& newIndex = remap[index];
+
+        if (newIndex == InvalidIndex)
+        {
+            newIndex = static_cast<uint32_t>(reordered.size());
+            reordered.push_back(vertices[index]);
+        }
+
+        index = static_cast<IndexType>(newIndex);
+    }
+
+    std::copy(reordered.begin(), reordered.end(), vertices.begin());
+
+    return static_cast<uint32_t>(reordered.size());
+}
+
+uint16_t* vulk::mesh::narrowIndices(uint32_t* indices, size_t count) noexcept
+{
+    // Each 16 bit write lands before the 32 bit index read next, going forward never overwrites unread data
+    auto* bytes = reinterpret_cast<unsigned char*>(indices);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t index = 0;
+        std::memcpy(&index, bytes + i * sizeof(uint32_t), sizeof(uint32_t));
+
+        assert(index <= std::numeric_limits<uint16_t>::max());
+        const auto narrowed = static_cast<uint16_t>(index);
+        std::memcpy(bytes + i * sizeof(uint16_t), &narrowed, sizeof(uint16_t));
+    }
+
+    return reinterpret_cast<uint16_t*>(indices);
+}
+
+template vulk::mesh::VertexCacheStatistics vulk::mesh::analyzeVertexCache(std::span<const uint16_t>, uint32_t,
+                                                                          uint32_t);
+template vulk::mesh::VertexCacheStatistics vulk::mesh::analyzeVertexCache(std::span<const uint32_t>, uint32_t,
+                                                                          uint32_t);
+template void vulk::mesh::optimizeVertexCache(std::span<uint16_t>, uint32_t);
+template void vulk::mesh::optimizeVertexCache(std::span<uint32_t>, uint32_t);
+template void vulk::mesh::optimizeOverdraw(std::span<uint16_t>, std::span<const glm::vec3>, float);
+template void vulk::mesh::optimizeOverdraw(std::span<uint32_t>, std::span<const glm::vec3>, float);
+template uint32_t vulk::mesh::optimizeVertexFetch(std::span<Vertex>, std::span<uint16_t>);
+template uint32_t vulk::mesh::optimizeVertexFetch(std::span<Vertex>, std::span<uint32_t>);
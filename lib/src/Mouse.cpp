@@ -34,8 +34,11 @@ vulk::Mouse::~Mouse()
 {
 }
 
-void vulk::Mouse::onButtonPressed(int button, int action)
+void vulk::Mouse::onButtonPressed(int button, int action, TimePoint arrival)
 {
+    if (!m_firstEventTime)
+        m_firstEventTime = arrival;
+
     if (action == GLFW_PRESS)
     {
         std::cout << "Button pressed !" << std::endl;
@@ -0,0 +1,375 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/ParticleSystem.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+
+#include "Vulk/Contexts/ContextVulkan.hpp"
+#include "Vulk/Exceptions.hpp"
+#include "Vulk/PipelineDesc.hpp"
+#include "Vulk/PipelineRegistry.hpp"
+#include "Vulk/RenderCounters.hpp"
+#include "Vulk/ScopedProfiler.hpp"
+#include "Vulk/Shader.hpp"
+#include "Vulk/ShaderLibrary.hpp"
+#include "Vulk/ShaderReflection.hpp"
+#include "Vulk/SpecializationConstants.hpp"
+
+// Matches `struct Particle` in the particle shaders: position + life, velocity + lifetime, color
+static constexpr vk::DeviceSize ParticleStride = 3 * sizeof(glm::vec4);
+
+// Avoids a burst of emission (and particles jumping) after a long stall such as a window resize
+static constexpr float MaxDeltaTime = 0.1f;
+
+// Emit and simulate compute shaders, then the vertex and fragment shaders
+static constexpr std::array ShaderPaths{"shaders/vulk/particles_emit.comp.spv",
+                                        "shaders/vulk/particles_simulate.comp.spv", "shaders/vulk/particle.vert.spv",
+                                        "shaders/vulk/particle.frag.spv"};
+
+vulk::ParticleSystem::ParticleSystem(ContextVulkan& context, uint32_t capacity)
+    : m_context{context}, m_device{context.m_device}, m_capacity{capacity}, m_lastUpdate{Clock::now()}
+{
+    VULK_SCOPED_PROFILER("ParticleSystem::ParticleSystem()");
+
+    assert(m_capacity > 0);
+
+    const auto graphicsFamily = m_context.m_queueFamilyIndices.graphicsFamily.value();
+    if (!(m_context.m_queueFamilyProperties[graphicsFamily].queueFlags & vk::QueueFlagBits::eCompute))
+        throw VulkanException("The graphics queue does not support compute, GPU particles are unavailable");
+
+    createBuffers();
+    createPipelineLayout();
+    createComputePipelines();
+    createGraphicsPipeline();
+    createDescriptorPool();
+    createDescriptorSets();
+}
+
+vulk::ParticleSystem::~ParticleSystem()
+{
+    VULK_SCOPED_PROFILER("ParticleSystem::~ParticleSystem()");
+
+    m_device.destroy(m_descriptorPool);
+
+    m_device.destroy(m_simulatePipeline);
+    m_device.destroy(m_emitPipeline);
+
+    m_device.destroy(m_drawCommandBuffer);
+    m_device.freeMemory(m_drawCommandBufferMemory);
+    m_device.destroy(m_aliveListBuffer);
+    m_device.freeMemory(m_aliveListBufferMemory);
+    m_device.destroy(m_freeListBuffer);
+    m_device.freeMemory(m_freeListBufferMemory);
+    m_device.destroy(m_particleBuffer);
+    m_device.freeMemory(m_particleBufferMemory);
+}
+
+void vulk::ParticleSystem::createBuffers()
+{
+    VULK_SCOPED_PROFILER_CATEGORY("ParticleSystem::createBuffers()", eLoading);
+
+    const vk::DeviceSize particlesSize = ParticleStride * m_capacity;
+    const vk::DeviceSize freeListSize = sizeof(int32_t) + sizeof(uint32_t) * m_capacity;
+    const vk::DeviceSize aliveListSize = sizeof(uint32_t) * m_capacity;
+
+    static constexpr auto StorageUsage = vk::BufferUsageFlagBits::eStorageBuffer;
+    static constexpr auto DeviceLocal = vk::MemoryPropertyFlagBits::eDeviceLocal;
+
+    m_context.createBuffer(particlesSize, StorageUsage | vk::BufferUsageFlagBits::eTransferDst, DeviceLocal,
+                           m_particleBuffer, m_particleBufferMemory);
+    m_context.createBuffer(freeListSize, StorageUsage | vk::BufferUsageFlagBits::eTransferDst, DeviceLocal,
+                           m_freeListBuffer, m_freeListBufferMemory);
+    m_context.createBuffer(aliveListSize, StorageUsage, DeviceLocal, m_aliveListBuffer, m_aliveListBufferMemory);
+    m_context.createBuffer(
+      sizeof(vk::DrawIndirectCommand),
+      StorageUsage | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst, DeviceLocal,
+      m_drawCommandBuffer, m_drawCommandBufferMemory);
+
+    // Every slot starts dead (zeroed particles) and in the free list
+    vk::Buffer stagingBuffer;
+    vk::DeviceMemory stagingBufferMemory;
+
+    m_context.createBuffer(freeListSize, vk::BufferUsageFlagBits::eTransferSrc,
+                           vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+                           stagingBuffer, stagingBufferMemory);
+
+    void* data;
+    handleVulkanError(m_device.mapMemory(stagingBufferMemory, 0, freeListSize, {}, &data));
+    *static_cast<int32_t*>(data) = static_cast<int32_t>(m_capacity);
+    auto* freeIndices = reinterpret_cast<uint32_t*>(static_cast<char*>(data) + sizeof(int32_t));
+    std::iota(freeIndices, freeIndices + m_capacity, 0u);
+    m_device.unmapMemory(stagingBufferMemory);
+
+    const vk::DrawIndirectCommand drawCommand{6, 0, 0, 0};  // one quad per instance, no instance until simulated
+
+    m_context.executeOneTimeCommands([&](vk::CommandBuffer& commandBuffer) {
+        const vk::BufferCopy copyRegion{0, 0, freeListSize};
+
+        commandBuffer.fillBuffer(m_particleBuffer, 0, VK_WHOLE_SIZE, 0);
+        commandBuffer.copyBuffer(stagingBuffer, m_freeListBuffer, 1, &copyRegion);
+        commandBuffer.updateBuffer(m_drawCommandBuffer, 0, sizeof(drawCommand), &drawCommand);
+    });
+
+    counters::add(RenderCounter::eBufferUploads, 2);
+    counters::add(RenderCounter::eUploadedBytes, freeListSize + sizeof(drawCommand));
+
+    // TODO: vk::raii
+    m_device.destroy(stagingBuffer);
+    m_device.freeMemory(stagingBufferMemory);
+}
+
+void vulk::ParticleSystem::createPipelineLayout()
+{
+    VULK_SCOPED_PROFILER_CATEGORY("ParticleSystem::createPipelineLayout()", eShaders);
+
+    // Compute and graphics share the layout and the descriptor sets, so it covers the interface of every stage
+    // Loaded once, the pipelines are built from the same modules
+    ShaderReflection reflection{};
+    for (const char* filePath : ShaderPaths)
+        reflection.merge(m_context.m_shaderLibrary->getModule(filePath)->getReflection());
+
+    const auto& pushConstantRange = reflection.getPushConstantRange();
+    if (!pushConstantRange || pushConstantRange->offset != 0 || pushConstantRange->size != sizeof(PushConstants))
+        throw ShaderReflectionException{"The particle shaders' push constants don't match PushConstants"};
+
+    const PipelineLayoutCache::Layout layout = m_context.m_layoutCache->getLayout(reflection);
+
+    m_pipelineLayout = layout.pipelineLayout;
+    m_descriptorSetLayout = layout.setLayouts.at(0);
+    m_pushConstantStages = pushConstantRange->stageFlags;
+    m_descriptorPoolSizes = reflection.getPoolSizes(0, static_cast<uint32_t>(ContextVulkan::s_maxFramesInFlight));
+}
+
+void vulk::ParticleSystem::createComputePipelines()
+{
+    VULK_SCOPED_PROFILER_CATEGORY("ParticleSystem::createComputePipelines()", eShaders);
+
+    Shader emit{m_context.m_shaderLibrary->getModule(ShaderPaths[0]), Shader::Type::eCompute};
+    Shader simulate{m_context.m_shaderLibrary->getModule(ShaderPaths[1]), Shader::Type::eCompute};
+
+    SpecializationConstants constants{};
+    constants.set(0, s_workGroupSize);
+    emit.specialize(constants);
+    simulate.specialize(constants);
+
+    std::array<vk::ComputePipelineCreateInfo, 2> pipelineInfos{};
+    pipelineInfos[0].stage = emit.getShaderStageCreateInfo();
+    pipelineInfos[0].layout = m_pipelineLayout;
+    pipelineInfos[1].stage = simulate.getShaderStageCreateInfo();
+    pipelineInfos[1].layout = m_pipelineLayout;
+
+    std::array<vk::Pipeline, 2> pipelines{};
+    handleVulkanError(m_device.createComputePipelines(nullptr, static_cast<uint32_t>(pipelineInfos.size()),
+                                                      pipelineInfos.data(), nullptr, pipelines.data()));
+
+    m_emitPipeline = pipelines[0];
+    m_simulatePipeline = pipelines[1];
+}
+
+void vulk::ParticleSystem::createGraphicsPipeline()
+{
+    VULK_SCOPED_PROFILER_CATEGORY("ParticleSystem::createGraphicsPipeline()", eShaders);
+
+    // Quads are expanded from gl_VertexIndex, particles are fetched from gl_InstanceIndex: no vertex input
+    m_graphicsPipelineDesc.vertexShader = ShaderPaths[2];
+    m_graphicsPipelineDesc.fragmentShader = ShaderPaths[3];
+    m_graphicsPipelineDesc.cullMode = vk::CullModeFlagBits::eNone;
+    m_graphicsPipelineDesc.blendMode = PipelineDesc::BlendMode::eAdditive;
+    m_graphicsPipelineDesc.layout = m_pipelineLayout;
+    m_graphicsPipelineDesc.renderPass = m_context.m_renderPass;
+
+    // Compiled in the background, particles are simulated but not drawn until it is ready
+    m_context.m_pipelineRegistry->requestPipeline(m_graphicsPipelineDesc);
+}
+
+void vulk::ParticleSystem::createDescriptorPool()
+{
+    VULK_SCOPED_PROFILER("ParticleSystem::createDescriptorPool()");
+
+    vk::DescriptorPoolCreateInfo createInfo{};
+    createInfo.poolSizeCount = static_cast<uint32_t>(m_descriptorPoolSizes.size());
+    createInfo.pPoolSizes = m_descriptorPoolSizes.data();
+    createInfo.maxSets = static_cast<uint32_t>(ContextVulkan::s_maxFramesInFlight);
+
+    handleVulkanError(m_device.createDescriptorPool(&createInfo, nullptr, &m_descriptorPool));
+}
+
+void vulk::ParticleSystem::createDescriptorSets()
+{
+    VULK_SCOPED_PROFILER("ParticleSystem::createDescriptorSets()");
+
+    const auto setCount = ContextVulkan::s_maxFramesInFlight;
+
+    std::vector<vk::DescriptorSetLayout> layouts(setCount, m_descriptorSetLayout);
+    vk::DescriptorSetAllocateInfo allocateInfo{};
+    allocateInfo.descriptorPool = m_descriptorPool;
+    allocateInfo.descriptorSetCount = static_cast<uint32_t>(setCount);
+    allocateInfo.pSetLayouts = layouts.data();
+
+    m_descriptorSets.resize(setCount);
+    handleVulkanError(m_device.allocateDescriptorSets(&allocateInfo, m_descriptorSets.data()));
+
+    const std::array storageBuffers{vk::DescriptorBufferInfo{m_particleBuffer, 0, VK_WHOLE_SIZE},
+                                    vk::DescriptorBufferInfo{m_freeListBuffer, 0, VK_WHOLE_SIZE},
+                                    vk::DescriptorBufferInfo{m_aliveListBuffer, 0, VK_WHOLE_SIZE},
+                                    vk::DescriptorBufferInfo{m_drawCommandBuffer, 0, VK_WHOLE_SIZE}};
+
+    for (const auto& descriptorSet : m_descriptorSets)
+    {
+        vk::WriteDescriptorSet descriptorWrite{};
+        descriptorWrite.dstSet = descriptorSet;
+        descriptorWrite.dstBinding = 1;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType = vk::DescriptorType::eStorageBuffer;
+        descriptorWrite.descriptorCount = static_cast<uint32_t>(storageBuffers.size());
+        descriptorWrite.pBufferInfo = storageBuffers.data();
+
+        m_device.updateDescriptorSets(1, &descriptorWrite, 0, nullptr);
+    }
+
+    writeUniformDescriptors();
+}
+
+void vulk::ParticleSystem::writeUniformDescriptors()
+{
+    for (size_t i = 0; i < m_descriptorSets.size(); ++i)
+    {
+        vk::DescriptorBufferInfo bufferInfo{};
+        bufferInfo.buffer = m_context.m_uniformBuffers[i];
+        bufferInfo.offset = 0;
+        bufferInfo.range = sizeof(UniformBufferObject);
+
+        vk::WriteDescriptorSet descriptorWrite{};
+        descriptorWrite.dstSet = m_descriptorSets[i];
+        descriptorWrite.dstBinding = 0;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType = vk::DescriptorType::eUniformBuffer;
+        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.pBufferInfo = &bufferInfo;
+
+        m_device.updateDescriptorSets(1, &descriptorWrite, 0, nullptr);
+    }
+}
+
+void vulk::ParticleSystem::onSwapchainRecreated()
+{
+    VULK_SCOPED_PROFILER("ParticleSystem::onSwapchainRecreated()");
+
+    // The registry destroyed the previous pipeline along with the render pass
+    createGraphicsPipeline();
+    writeUniformDescriptors();
+}
+
+vulk::ParticleSystem::PushConstants vulk::ParticleSystem::makePushConstants(float deltaTime,
+                                                                            uint32_t emitCount) const noexcept
+{
+    PushConstants pushConstants{};
+
+    pushConstants.position = glm::vec4{m_emitter.position, m_emitter.spawnRadius};
+    pushConstants.velocity = glm::vec4{m_emitter.velocity, m_emitter.velocitySpread};
+    pushConstants.color = m_emitter.color;
+    pushConstants.gravityDelta = glm::vec4{m_emitter.gravity, deltaTime};
+    pushConstants.emitCount = emitCount;
+    pushConstants.seed = m_seed;
+    pushConstants.capacity = m_capacity;
+    pushConstants.lifetime = m_emitter.lifetime;
+    pushConstants.size = m_emitter.size;
+
+    return pushConstants;
+}
+
+void vulk::ParticleSystem::recordCompute(vk::CommandBuffer& commandBuffer, size_t frameIndex)
+{
+    const auto now = Clock::now();
+    const float deltaTime = std::min(Duration{now - m_lastUpdate}.count(), MaxDeltaTime);
+    m_lastUpdate = now;
+
+    m_emitAccumulator += m_emitter.rate * deltaTime;
+    const float wanted = std::floor(m_emitAccumulator);
+    m_emitAccumulator -= wanted;
+
+    const auto emitCount = static_cast<uint32_t>(std::min(wanted, static_cast<float>(m_capacity)));
+
+    ++m_seed;
+    m_pushConstants = makePushConstants(deltaTime, emitCount);
+
+    // The previous frame may still be reading the alive list and the draw command
+    const vk::MemoryBarrier previousFrameBarrier{
+      vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eIndirectCommandRead,
+      vk::AccessFlagBits::eTransferWrite | vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite};
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eDrawIndirect,
+                                  vk::PipelineStageFlagBits::eTransfer | vk::PipelineStageFlagBits::eComputeShader, {},
+                                  previousFrameBarrier, nullptr, nullptr);
+
+    // Reset the live count, the simulation pass rebuilds it
+    commandBuffer.fillBuffer(m_drawCommandBuffer, sizeof(uint32_t), sizeof(uint32_t), 0);  // instanceCount
+
+    const vk::MemoryBarrier resetBarrier{vk::AccessFlagBits::eTransferWrite,
+                                         vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite};
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader, {},
+                                  resetBarrier, nullptr, nullptr);
+
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_pipelineLayout, 0, 1,
+                                     &m_descriptorSets[frameIndex], 0, nullptr);
+    commandBuffer.pushConstants(m_pipelineLayout, m_pushConstantStages, 0, sizeof(PushConstants), &m_pushConstants);
+
+    if (emitCount > 0)
+    {
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_emitPipeline);
+        commandBuffer.dispatch((emitCount + s_workGroupSize - 1) / s_workGroupSize, 1, 1);
+
+        const vk::MemoryBarrier emitBarrier{vk::AccessFlagBits::eShaderWrite,
+                                            vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite};
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                                      vk::PipelineStageFlagBits::eComputeShader, {}, emitBarrier, nullptr, nullptr);
+    }
+
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_simulatePipeline);
+    commandBuffer.dispatch((m_capacity + s_workGroupSize - 1) / s_workGroupSize, 1, 1);
+
+    const vk::MemoryBarrier simulateBarrier{vk::AccessFlagBits::eShaderWrite,
+                                            vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eIndirectCommandRead};
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                                  vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eDrawIndirect,
+                                  {}, simulateBarrier, nullptr, nullptr);
+}
+
+void vulk::ParticleSystem::recordDraw(vk::CommandBuffer& commandBuffer, size_t frameIndex)
+{
+    const PipelineRegistry::Pipeline* pipeline = m_context.m_pipelineRegistry->requestPipeline(m_graphicsPipelineDesc);
+    if (!pipeline)
+        return;
+
+    // The viewport and scissor are already set by the context
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline->pipeline);
+    m_context.m_pipelineRegistry->recordDynamicState(commandBuffer, m_graphicsPipelineDesc);
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipelineLayout, 0, 1,
+                                     &m_descriptorSets[frameIndex], 0, nullptr);
+    commandBuffer.pushConstants(m_pipelineLayout, m_pushConstantStages, 0, sizeof(PushConstants), &m_pushConstants);
+    commandBuffer.drawIndirect(m_drawCommandBuffer, 0, 1, sizeof(vk::DrawIndirectCommand));
+
+    // The instance count is only known to the GPU
+    counters::add(RenderCounter::eDrawCalls);
+    counters::add(RenderCounter::ePipelineBinds);
+    counters::add(RenderCounter::eDescriptorSetBinds);
+}
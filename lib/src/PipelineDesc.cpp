@@ -0,0 +1,86 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/PipelineDesc.hpp"
+
+#include <string_view>
+
+#include "Vulk/Utils.hpp"
+
+vk::PrimitiveTopology vulk::PipelineDesc::getTopologyClass(vk::PrimitiveTopology topology) noexcept
+{
+    switch (topology)
+    {
+    case vk::PrimitiveTopology::ePointList: return vk::PrimitiveTopology::ePointList;
+    case vk::PrimitiveTopology::eLineList:
+    case vk::PrimitiveTopology::eLineStrip:
+    case vk::PrimitiveTopology::eLineListWithAdjacency:
+    case vk::PrimitiveTopology::eLineStripWithAdjacency: return vk::PrimitiveTopology::eLineList;
+    case vk::PrimitiveTopology::ePatchList: return vk::PrimitiveTopology::ePatchList;
+    default: return vk::PrimitiveTopology::eTriangleList;
+    }
+}
+
+uint64_t vulk::PipelineDesc::hash(bool ignoreDynamicState) const noexcept
+{
+    // Paths keep their null terminator, so that characters moving from one to the other change the hash
+    uint64_t result = utils::hashFnv1a({vertexShader.c_str(), vertexShader.size() + 1});
+    result = utils::hashFnv1a({fragmentShader.c_str(), fragmentShader.size() + 1}, result);
+    result = vertexConstants.hash(result);
+    result = fragmentConstants.hash(result);
+
+    // Every other member is a plain value without padding
+    const auto hashValue = [&result](const auto& value) {
+        result = utils::hashFnv1a({reinterpret_cast<const char*>(&value), sizeof(value)}, result);
+    };
+
+    hashValue(vertexStride);
+    hashValue(polygonMode);
+    hashValue(blendMode);
+    hashValue(layout);
+    hashValue(renderPass);
+    hashValue(subpass);
+
+    if (ignoreDynamicState)
+    {
+        hashValue(getTopologyClass(topology));
+    } else
+    {
+        hashValue(topology);
+        hashValue(cullMode);
+        hashValue(frontFace);
+        hashValue(depthTest);
+        hashValue(depthWrite);
+        hashValue(depthCompareOp);
+    }
+
+    return result;
+}
+
+bool vulk::PipelineDesc::isSamePipeline(const PipelineDesc& rhs, bool ignoreDynamicState) const noexcept
+{
+    if (!ignoreDynamicState)
+        return *this == rhs;
+
+    return vertexShader == rhs.vertexShader && fragmentShader == rhs.fragmentShader &&
+           vertexConstants == rhs.vertexConstants && fragmentConstants == rhs.fragmentConstants &&
+           vertexStride == rhs.vertexStride && getTopologyClass(topology) == getTopologyClass(rhs.topology) &&
+           polygonMode == rhs.polygonMode && blendMode == rhs.blendMode && layout == rhs.layout &&
+           renderPass == rhs.renderPass && subpass == rhs.subpass;
+}
@@ -0,0 +1,145 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/PipelineLayoutCache.hpp"
+
+#include <algorithm>
+
+#include "Vulk/Exceptions.hpp"
+#include "Vulk/ScopedProfiler.hpp"
+
+vulk::PipelineLayoutCache::PipelineLayoutCache(const vk::Device& device) : m_device{device} {}
+
+vulk::PipelineLayoutCache::~PipelineLayoutCache()
+{
+    for (const auto& [key, layout] : m_layouts)
+        m_device.destroy(layout.pipelineLayout);
+
+    for (const auto& setLayout : m_setLayouts)
+        m_device.destroy(setLayout);
+}
+
+vulk::PipelineLayoutCache::Layout vulk::PipelineLayoutCache::getLayout(const ShaderReflection& reflection)
+{
+    VULK_SCOPED_PROFILER_CATEGORY("PipelineLayoutCache::getLayout()", eShaders);
+
+    const auto& bindings = reflection.getDescriptorBindings();
+    const auto& pushConstantRange = reflection.getPushConstantRange();
+
+    const std::scoped_lock lock{m_mutex};
+
+    // Set count and set layout ids, then the push constant range
+    Key key{reflection.getSetCount()};
+    key.reserve(reflection.getSetCount() + 4);
+
+    for (uint32_t set = 0; set < reflection.getSetCount(); ++set)
+    {
+        // Sets no stage uses still need a layout, it is simply empty
+        const auto first = std::find_if(bindings.begin(), bindings.end(),
+                                        [set](const auto& descriptorBinding) { return descriptorBinding.set == set; });
+        const auto last = std::find_if(first, bindings.end(),
+                                       [set](const auto& descriptorBinding) { return descriptorBinding.set != set; });
+
+        key.push_back(getSetLayoutId({first, last}));
+    }
+
+    if (pushConstantRange)
+    {
+        key.push_back(static_cast<uint32_t>(pushConstantRange->stageFlags));
+        key.push_back(pushConstantRange->offset);
+        key.push_back(pushConstantRange->size);
+    }
+
+    if (const auto it = m_layouts.find(key); it != m_layouts.end())
+        return it->second;
+
+    Layout layout{};
+    layout.setLayouts.reserve(reflection.getSetCount());
+
+    for (uint32_t set = 0; set < reflection.getSetCount(); ++set)
+        layout.setLayouts.push_back(m_setLayouts[key[set + 1]]);
+
+    vk::PipelineLayoutCreateInfo createInfo{};
+    createInfo.setLayoutCount = static_cast<uint32_t>(layout.setLayouts.size());
+    createInfo.pSetLayouts = layout.setLayouts.data();
+
+    if (pushConstantRange)
+    {
+        createInfo.pushConstantRangeCount = 1;
+        createInfo.pPushConstantRanges = &*pushConstantRange;
+    }
+
+    handleVulkanError(m_device.createPipelineLayout(&createInfo, nullptr, &layout.pipelineLayout));
+
+    return m_layouts.emplace(std::move(key), std::move(layout)).first->second;
+}
+
+size_t vulk::PipelineLayoutCache::getSetLayoutCount() const
+{
+    const std::scoped_lock lock{m_mutex};
+    return m_setLayouts.size();
+}
+
+size_t vulk::PipelineLayoutCache::getPipelineLayoutCount() const
+{
+    const std::scoped_lock lock{m_mutex};
+    return m_layouts.size();
+}
+
+uint32_t vulk::PipelineLayoutCache::getSetLayoutId(std::span<const ShaderReflection::DescriptorBinding> bindings)
+{
+    Key key{};
+    key.reserve(bindings.size() * 4);
+
+    for (const auto& descriptorBinding : bindings)
+    {
+        key.push_back(descriptorBinding.binding);
+        key.push_back(static_cast<uint32_t>(descriptorBinding.type));
+        key.push_back(descriptorBinding.count);
+        key.push_back(static_cast<uint32_t>(descriptorBinding.stages));
+    }
+
+    if (const auto it = m_setLayoutIds.find(key); it != m_setLayoutIds.end())
+        return it->second;
+
+    std::vector<vk::DescriptorSetLayoutBinding> layoutBindings{};
+    layoutBindings.reserve(bindings.size());
+
+    for (const auto& descriptorBinding : bindings)
+    {
+        vk::DescriptorSetLayoutBinding& layoutBinding = layoutBindings.emplace_back();
+        layoutBinding.binding = descriptorBinding.binding;
+        layoutBinding.descriptorType = descriptorBinding.type;
+        layoutBinding.descriptorCount = descriptorBinding.count;
+        layoutBinding.stageFlags = descriptorBinding.stages;
+    }
+
+    vk::DescriptorSetLayoutCreateInfo createInfo{};
+    createInfo.bindingCount = static_cast<uint32_t>(layoutBindings.size());
+    createInfo.pBindings = layoutBindings.data();
+
+    vk::DescriptorSetLayout setLayout{};
+    handleVulkanError(m_device.createDescriptorSetLayout(&createInfo, nullptr, &setLayout));
+
+    const auto id = static_cast<uint32_t>(m_setLayouts.size());
+    m_setLayouts.push_back(setLayout);
+    m_setLayoutIds.emplace(std::move(key), id);
+
+    return id;
+}
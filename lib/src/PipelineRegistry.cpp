@@ -0,0 +1,353 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/PipelineRegistry.hpp"
+
+#include <array>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+
+#include "Vulk/Exceptions.hpp"
+#include "Vulk/ScopedProfiler.hpp"
+#include "Vulk/Shader.hpp"
+
+namespace {
+vk::PipelineColorBlendAttachmentState makeBlendAttachment(vulk::PipelineDesc::BlendMode blendMode) noexcept
+{
+    vk::PipelineColorBlendAttachmentState attachment{};
+    attachment.colorWriteMask = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+                                vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
+
+    switch (blendMode)
+    {
+    case vulk::PipelineDesc::BlendMode::eOpaque:
+        attachment.blendEnable = false;
+        break;
+    case vulk::PipelineDesc::BlendMode::eAlpha:
+        attachment.blendEnable = true;
+        attachment.srcColorBlendFactor = vk::BlendFactor::eSrcAlpha;
+        attachment.dstColorBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha;
+        attachment.colorBlendOp = vk::BlendOp::eAdd;
+        attachment.srcAlphaBlendFactor = vk::BlendFactor::eOne;
+        attachment.dstAlphaBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha;
+        attachment.alphaBlendOp = vk::BlendOp::eAdd;
+        break;
+    case vulk::PipelineDesc::BlendMode::eAdditive:
+        // Order independent: the draws don't need to be sorted
+        attachment.blendEnable = true;
+        attachment.srcColorBlendFactor = vk::BlendFactor::eSrcAlpha;
+        attachment.dstColorBlendFactor = vk::BlendFactor::eOne;
+        attachment.colorBlendOp = vk::BlendOp::eAdd;
+        attachment.srcAlphaBlendFactor = vk::BlendFactor::eZero;
+        attachment.dstAlphaBlendFactor = vk::BlendFactor::eOne;
+        attachment.alphaBlendOp = vk::BlendOp::eAdd;
+        break;
+    }
+
+    return attachment;
+}
+
+// Follow the swapchain extent without rebuilding the pipelines
+constexpr std::array ViewportStates{vk::DynamicState::eViewport, vk::DynamicState::eScissor};
+
+constexpr std::array ExtendedDynamicStates{vk::DynamicState::eViewport,
+                                           vk::DynamicState::eScissor,
+                                           vk::DynamicState::eCullModeEXT,
+                                           vk::DynamicState::eFrontFaceEXT,
+                                           vk::DynamicState::ePrimitiveTopologyEXT,
+                                           vk::DynamicState::eDepthTestEnableEXT,
+                                           vk::DynamicState::eDepthWriteEnableEXT,
+                                           vk::DynamicState::eDepthCompareOpEXT};
+}  // namespace
+
+vulk::PipelineRegistry::PipelineRegistry(const vk::Device& device, PipelineLayoutCache& layoutCache,
+                                         ShaderLibrary& shaderLibrary, ThreadPool& workers,
+                                         const vk::DispatchLoaderDynamic* extendedDynamicState)
+    : m_device{device},
+      m_layoutCache{layoutCache},
+      m_shaderLibrary{shaderLibrary},
+      m_workers{workers},
+      m_extendedDynamicState{extendedDynamicState},
+      m_pipelines{0, DescHash{extendedDynamicState != nullptr}, DescEqual{extendedDynamicState != nullptr}},
+      m_building{0, DescHash{extendedDynamicState != nullptr}, DescEqual{extendedDynamicState != nullptr}},
+      m_failed{0, DescHash{extendedDynamicState != nullptr}, DescEqual{extendedDynamicState != nullptr}}
+{
+}
+
+vulk::PipelineRegistry::~PipelineRegistry()
+{
+    clear();
+}
+
+const vulk::PipelineRegistry::Pipeline& vulk::PipelineRegistry::getPipeline(const PipelineDesc& desc)
+{
+    VULK_SCOPED_PROFILER_CATEGORY("PipelineRegistry::getPipeline()", eShaders);
+
+    {
+        std::unique_lock lock{m_mutex};
+
+        // Finishing a build in flight can only be faster than starting over
+        m_buildFinished.wait(lock, [&] { return !m_building.contains(desc); });
+
+        if (const auto it = m_pipelines.find(desc); it != m_pipelines.end())
+        {
+            ++m_statistics.hits;
+            return it->second;
+        }
+    }
+
+    Pipeline pipeline = buildPipeline(desc);
+
+    const std::scoped_lock lock{m_mutex};
+    const auto [it, inserted] = m_pipelines.try_emplace(desc, std::move(pipeline));
+
+    // Another thread built the same pipeline in the meantime
+    if (!inserted)
+    {
+        ++m_statistics.hits;
+        m_device.destroy(pipeline.pipeline);
+        return it->second;
+    }
+
+    ++m_statistics.misses;
+    return it->second;
+}
+
+const vulk::PipelineRegistry::Pipeline* vulk::PipelineRegistry::requestPipeline(const PipelineDesc& desc)
+{
+    VULK_SCOPED_PROFILER_CATEGORY("PipelineRegistry::requestPipeline()", eFrame);
+
+    const std::scoped_lock lock{m_mutex};
+
+    if (const auto it = m_pipelines.find(desc); it != m_pipelines.end())
+    {
+        ++m_statistics.hits;
+        return &it->second;
+    }
+
+    if (m_failed.contains(desc))
+        return nullptr;
+
+    ++m_statistics.pending;
+
+    if (m_building.insert(desc).second)
+        m_workers.submit([this, desc] { buildInBackground(desc); });
+
+    return nullptr;
+}
+
+vulk::PipelineRegistry::Pipeline vulk::PipelineRegistry::buildPipeline(const PipelineDesc& desc) const
+{
+    VULK_SCOPED_PROFILER_CATEGORY("PipelineRegistry::buildPipeline()", eShaders);
+
+    // Rebuilds only read the files and create the modules the first time
+    Shader vert{m_shaderLibrary.getModule(desc.vertexShader), Shader::Type::eVertex};
+    Shader frag{m_shaderLibrary.getModule(desc.fragmentShader), Shader::Type::eFragment};
+    vert.specialize(desc.vertexConstants);
+    frag.specialize(desc.fragmentConstants);
+
+    const std::array shaderStages{vert.getShaderStageCreateInfo(), frag.getShaderStageCreateInfo()};
+
+    Pipeline pipeline{};
+    pipeline.reflection = vert.getReflection();
+    pipeline.reflection.merge(frag.getReflection());
+    pipeline.layout = desc.layout ? PipelineLayoutCache::Layout{desc.layout, {}} :
+                                    m_layoutCache.getLayout(pipeline.reflection);
+
+    // Attributes are packed in location order, the vertex buffer has to follow the same layout
+    const auto vertexInput = pipeline.reflection.getVertexInputLayout();
+    if (vertexInput.binding.stride != desc.vertexStride)
+    {
+        throw ShaderReflectionException{desc.vertexShader + " inputs take " +
+                                        std::to_string(vertexInput.binding.stride) + " bytes, the vertex stride is " +
+                                        std::to_string(desc.vertexStride)};
+    }
+
+    vk::PipelineVertexInputStateCreateInfo vertexInputInfo{};
+    if (desc.vertexStride != 0)
+    {
+        vertexInputInfo.vertexBindingDescriptionCount = 1;
+        vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexInput.attributes.size());
+        vertexInputInfo.pVertexBindingDescriptions = &vertexInput.binding;
+        vertexInputInfo.pVertexAttributeDescriptions = vertexInput.attributes.data();
+    }
+
+    vk::PipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.topology = desc.topology;
+    inputAssembly.primitiveRestartEnable = false;
+
+    vk::PipelineViewportStateCreateInfo viewportState{};
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    vk::PipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.depthClampEnable = false;
+    rasterizer.rasterizerDiscardEnable = false;
+    rasterizer.polygonMode = desc.polygonMode;
+    rasterizer.lineWidth = 1;
+    rasterizer.cullMode = desc.cullMode;
+    rasterizer.frontFace = desc.frontFace;
+    rasterizer.depthBiasEnable = false;
+
+    vk::PipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sampleShadingEnable = false;
+    multisampling.rasterizationSamples = vk::SampleCountFlagBits::e1;
+
+    vk::PipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.depthTestEnable = desc.depthTest;
+    depthStencil.depthWriteEnable = desc.depthWrite;
+    depthStencil.depthCompareOp = desc.depthCompareOp;
+
+    const vk::PipelineColorBlendAttachmentState colorBlendAttachment = makeBlendAttachment(desc.blendMode);
+
+    vk::PipelineColorBlendStateCreateInfo colorBlending{};
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &colorBlendAttachment;
+
+    const std::span<const vk::DynamicState> dynamicStates =
+      m_extendedDynamicState ? std::span<const vk::DynamicState>{ExtendedDynamicStates} : ViewportStates;
+
+    vk::PipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+    dynamicState.pDynamicStates = dynamicStates.data();
+
+    vk::GraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
+    pipelineInfo.pStages = shaderStages.data();
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState =
+      m_extendedDynamicState || desc.depthTest || desc.depthWrite ? &depthStencil : nullptr;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = pipeline.layout.pipelineLayout;
+    pipelineInfo.renderPass = desc.renderPass;
+    pipelineInfo.subpass = desc.subpass;
+    pipelineInfo.basePipelineHandle = nullptr;
+    pipelineInfo.basePipelineIndex = -1;
+
+    handleVulkanError(m_device.createGraphicsPipelines(nullptr, 1, &pipelineInfo, nullptr, &pipeline.pipeline));
+
+    return pipeline;
+}
+
+vk::Pipeline vulk::PipelineRegistry::replacePipeline(const PipelineDesc& desc, Pipeline pipeline)
+{
+    const std::scoped_lock lock{m_mutex};
+
+    Pipeline& registered = m_pipelines[desc];
+    std::swap(registered, pipeline);
+
+    return pipeline.pipeline;
+}
+
+void vulk::PipelineRegistry::recordDynamicState(const vk::CommandBuffer& commandBuffer, const PipelineDesc& desc) const
+{
+    if (!m_extendedDynamicState)
+        return;
+
+    const vk::DispatchLoaderDynamic& dispatcher = *m_extendedDynamicState;
+
+    commandBuffer.setCullModeEXT(desc.cullMode, dispatcher);
+    commandBuffer.setFrontFaceEXT(desc.frontFace, dispatcher);
+    commandBuffer.setPrimitiveTopologyEXT(desc.topology, dispatcher);
+    commandBuffer.setDepthTestEnableEXT(desc.depthTest, dispatcher);
+    commandBuffer.setDepthWriteEnableEXT(desc.depthWrite, dispatcher);
+    commandBuffer.setDepthCompareOpEXT(desc.depthCompareOp, dispatcher);
+}
+
+void vulk::PipelineRegistry::waitForBuilds()
+{
+    std::unique_lock lock{m_mutex};
+    m_buildFinished.wait(lock, [this] { return m_building.empty(); });
+}
+
+void vulk::PipelineRegistry::clear()
+{
+    std::unique_lock lock{m_mutex};
+    m_buildFinished.wait(lock, [this] { return m_building.empty(); });
+
+    for (const auto& [desc, pipeline] : m_pipelines)
+        m_device.destroy(pipeline.pipeline);
+
+    m_pipelines.clear();
+
+    // The shaders may have been fixed since
+    m_failed.clear();
+}
+
+size_t vulk::PipelineRegistry::getPipelineCount() const
+{
+    const std::scoped_lock lock{m_mutex};
+    return m_pipelines.size();
+}
+
+vulk::PipelineRegistry::Statistics vulk::PipelineRegistry::getStatistics() const
+{
+    const std::scoped_lock lock{m_mutex};
+    return m_statistics;
+}
+
+void vulk::PipelineRegistry::buildInBackground(const PipelineDesc& desc)
+{
+    VULK_SCOPED_PROFILER_CATEGORY("PipelineRegistry::buildInBackground()", eShaders);
+
+    std::optional<Pipeline> pipeline{};
+
+    try
+    {
+        pipeline = buildPipeline(desc);
+    } catch (const std::exception& e)
+    {
+        std::cerr << "Unable to build the pipeline of " << desc.vertexShader << " and " << desc.fragmentShader << ": "
+                  << e.what() << '\n';
+    } catch (...)
+    {
+        // Still a failure: the waiters on the build must be notified below
+        std::cerr << "Unable to build the pipeline of " << desc.vertexShader << " and " << desc.fragmentShader
+                  << ": exception of unknown type\n";
+    }
+
+    {
+        const std::scoped_lock lock{m_mutex};
+
+        if (pipeline)
+        {
+            ++m_statistics.misses;
+
+            // Built by replacePipeline() in the meantime
+            if (!m_pipelines.try_emplace(desc, std::move(*pipeline)).second)
+                m_device.destroy(pipeline->pipeline);
+        } else
+        {
+            ++m_statistics.failures;
+            m_failed.insert(desc);
+        }
+
+        m_building.erase(desc);
+    }
+
+    m_buildFinished.notify_all();
+}
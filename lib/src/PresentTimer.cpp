@@ -0,0 +1,138 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/PresentTimer.hpp"
+
+#include <chrono>
+#include <cstddef>
+
+#include "Vulk/Exceptions.hpp"
+
+namespace {
+// Bounds how long stop() waits for the waiter thread, in nanoseconds
+constexpr uint64_t s_presentWaitTimeout{10'000'000};
+}  // namespace
+
+vulk::PresentTimer::PresentTimer(const vk::Device& device, const vk::DispatchLoaderDynamic* presentWait)
+    : m_device{device}, m_presentWait{presentWait}
+{
+    m_timings.reserve(SpscRingBuffer<PresentTiming, 64>::capacity());
+    m_pendingPresents.reserve(s_maxPendingPresents);
+}
+
+vulk::PresentTimer::~PresentTimer()
+{
+    stop();
+}
+
+void vulk::PresentTimer::start(const vk::SwapchainKHR& swapchain)
+{
+    stop();
+
+    if (!m_presentWait)
+        return;
+
+    m_swapchain = swapchain;
+    m_running = true;
+    m_thread = std::thread{&PresentTimer::waitForPresents, this};
+}
+
+void vulk::PresentTimer::stop() noexcept
+{
+    m_running = false;
+
+    if (m_thread.joinable())
+        m_thread.join();
+
+    m_swapchain = nullptr;
+}
+
+void vulk::PresentTimer::onPresented(uint64_t presentId, const vk::Fence& fence)
+{
+    if (m_presentWait)
+    {
+        m_lastPresentId.store(presentId, std::memory_order_release);
+        return;
+    }
+
+    // The oldest frame is timed against the next fence when it was somehow never waited on
+    if (m_pendingPresents.size() == s_maxPendingPresents)
+        m_pendingPresents.erase(m_pendingPresents.begin());
+
+    m_pendingPresents.push_back({presentId, fence});
+}
+
+std::span<const vulk::PresentTiming> vulk::PresentTimer::update()
+{
+    m_timings.clear();
+
+    if (m_presentWait)
+    {
+        m_presented.consume([this](const PresentTiming& timing) { m_timings.push_back(timing); });
+        return m_timings;
+    }
+
+    const TimePoint now = Clock::now();
+
+    // Fences signal in submission order: stop at the first one still pending
+    size_t signaled = 0;
+    for (const PendingPresent& present : m_pendingPresents)
+    {
+        const vk::Result status = m_device.getFenceStatus(present.fence);
+
+        if (status == vk::Result::eNotReady)
+            break;
+
+        handleVulkanError(status);
+        m_timings.push_back({present.presentId, now});
+        ++signaled;
+    }
+
+    m_pendingPresents.erase(m_pendingPresents.begin(), m_pendingPresents.begin() + static_cast<ptrdiff_t>(signaled));
+    return m_timings;
+}
+
+void vulk::PresentTimer::waitForPresents()
+{
+    uint64_t lastTimed = m_lastPresentId.load(std::memory_order_acquire);
+
+    while (m_running)
+    {
+        const uint64_t presentId = m_lastPresentId.load(std::memory_order_acquire);
+
+        if (presentId == lastTimed)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            continue;
+        }
+
+        // The raw command reports an out of date swapchain instead of throwing
+        const auto result = static_cast<vk::Result>(m_presentWait->vkWaitForPresentKHR(
+          static_cast<VkDevice>(m_device), static_cast<VkSwapchainKHR>(m_swapchain), presentId, s_presentWaitTimeout));
+
+        if (result == vk::Result::eTimeout)
+            continue;
+
+        // Otherwise the frame will never be displayed, there is nothing to time
+        if (result == vk::Result::eSuccess || result == vk::Result::eSuboptimalKHR)
+            static_cast<void>(m_presented.tryPush({presentId, Clock::now()}));
+
+        lastTimed = presentId;
+    }
+}
@@ -0,0 +1,87 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/RenderCounters.hpp"
+
+#include <atomic>
+
+#include "Vulk/ThreadAccumulators.hpp"
+
+namespace {
+struct Accumulator
+{
+    std::array<std::atomic<uint64_t>, vulk::RenderCounters::s_count> values{};
+};
+
+using Accumulators = vulk::ThreadAccumulators<Accumulator>;
+
+constexpr std::array<const char*, vulk::RenderCounters::s_count> Names{"draw calls",
+                                                                       "instances",
+                                                                       "triangles",
+                                                                       "pipeline binds",
+                                                                       "descriptor set binds",
+                                                                       "buffer uploads",
+                                                                       "uploaded bytes",
+                                                                       "allocations",
+                                                                       "allocated bytes",
+                                                                       "queue submits"};
+}  // namespace
+
+vulk::RenderCounters& vulk::RenderCounters::operator+=(const RenderCounters& other) noexcept
+{
+    for (size_t i = 0; i < s_count; ++i)
+        m_values[i] += other.m_values[i];
+
+    return *this;
+}
+
+const char* vulk::RenderCounters::getName(RenderCounter counter) noexcept
+{
+    const auto index = static_cast<size_t>(counter);
+    return index < s_count ? Names[index] : "unknown";
+}
+
+void vulk::counters::add(RenderCounter counter, uint64_t value) noexcept
+{
+    // Only the owning thread writes, the atomic is for fold() to read it
+    Accumulators::getLocal().values[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+}
+
+vulk::RenderCounters vulk::counters::fold()
+{
+    RenderCounters counters{};
+
+    Accumulators::forEach([&counters](Accumulator& accumulator) {
+        for (size_t i = 0; i < RenderCounters::s_count; ++i)
+            counters[static_cast<RenderCounter>(i)] += accumulator.values[i].exchange(0, std::memory_order_relaxed);
+    });
+
+    return counters;
+}
+
+std::ostream& operator<<(std::ostream& os, const vulk::RenderCounters& counters)
+{
+    for (size_t i = 0; i < vulk::RenderCounters::s_count; ++i)
+    {
+        const auto counter = static_cast<vulk::RenderCounter>(i);
+        os << (i > 0 ? ", " : "") << vulk::RenderCounters::getName(counter) << ": " << counters[counter];
+    }
+
+    return os;
+}
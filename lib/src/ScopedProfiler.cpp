@@ -19,20 +19,282 @@
 
 #include "Vulk/ScopedProfiler.hpp"
 
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
 
-vulk::utils::ScopedProfiler::ScopedProfiler(const char* name) noexcept : m_start{Clock::now()}, m_name{name}
+namespace {
+using Microseconds = std::chrono::duration<double, std::micro>;
+
+constexpr std::chrono::milliseconds FlushPeriod{10};
+
+constexpr std::array<const char*, static_cast<size_t>(vulk::utils::ProfilerCategory::eCount)> CategoryNames{
+  "general", "frame", "loading", "shaders", "vulkan"};
+
+void writeEscaped(std::ostream& os, const char* text)
+{
+    for (; *text; ++text)
+    {
+        if (*text == '"' || *text == '\\')
+            os << '\\';
+        os << *text;
+    }
+}
+}  // namespace
+
+thread_local vulk::utils::Profiler::ThreadBufferOwner vulk::utils::Profiler::s_threadBuffer{};
+thread_local bool vulk::utils::Profiler::s_threadExited{false};
+
+vulk::utils::Profiler::ThreadBufferOwner::~ThreadBufferOwner()
+{
+    // Trivially destructible, still readable by the destructors which run after this one
+    s_threadExited = true;
+
+    if (buffer)
+        buffer->retired.store(true, std::memory_order_release);
+}
+
+vulk::utils::Profiler::Profiler()
+{
+    // Joins the flusher before the threads are torn down, and writes the end of the trace
+    std::atexit([] { getInstance().stopTrace(); });
+}
+
+vulk::utils::Profiler& vulk::utils::Profiler::getInstance()
+{
+    static Profiler* const instance = new Profiler{};
+    return *instance;
+}
+
+void vulk::utils::Profiler::setCategoryEnabled(ProfilerCategory category, bool enabled) noexcept
+{
+    if (enabled)
+        s_enabledCategories.fetch_or(getCategoryMask(category));
+    else
+        s_enabledCategories.fetch_and(~getCategoryMask(category));
+}
+
+const char* vulk::utils::Profiler::getCategoryName(ProfilerCategory category) noexcept
+{
+    const auto index = static_cast<size_t>(category);
+    return index < CategoryNames.size() ? CategoryNames[index] : "unknown";
+}
+
+void vulk::utils::Profiler::record(const ZoneDescriptor& zone, Ticks begin, Ticks end) noexcept
+{
+    push(Zone{&zone, begin, end});
+}
+
+void vulk::utils::Profiler::markFrame() noexcept
+{
+    const Ticks time = now();
+    push(Zone{nullptr, time, time});
+
+    if (!s_threadExited && s_threadBuffer.buffer)
+    {
+        const ThreadBuffer* expected = nullptr;
+        m_frameThreadBuffer.compare_exchange_strong(expected, s_threadBuffer.buffer);
+    }
+}
+
+void vulk::utils::Profiler::startTrace(const std::string& filePath)
+{
+    const std::scoped_lock traceLock{m_traceMutex};
+
+    closeTrace();
+
+    // The zones recorded until now are not part of the trace, they would only take room in the buffers
+    flush();
+
+    {
+        const std::scoped_lock lock{m_flushMutex};
+
+        m_output.open(filePath, std::ios::out | std::ios::trunc);
+        if (!m_output)
+        {
+            std::cerr << "Profiler: could not open " << filePath << ", tracing disabled\n";
+            return;
+        }
+
+        // The closing bracket is optional in the array format, the trace stays valid if the program never stops it
+        m_output << "[\n" << std::fixed << std::setprecision(3);
+        m_traceStart = now();
+        m_firstZone = true;
+        m_tracing.store(true);
+    }
+
+    m_stopFlusher = false;
+    m_flusher = std::thread{&Profiler::runFlusher, this};
+}
+
+void vulk::utils::Profiler::stopTrace()
+{
+    const std::scoped_lock traceLock{m_traceMutex};
+    closeTrace();
+}
+
+size_t vulk::utils::Profiler::getThreadCount() const
+{
+    const std::scoped_lock lock{m_buffersMutex};
+    return m_buffers.size();
+}
+
+std::vector<vulk::utils::FrameCallTree::Node> vulk::utils::Profiler::getFrameProfile() const
+{
+    const std::scoped_lock lock{m_flushMutex};
+    return m_frameCallTree.getNodes();
+}
+
+void vulk::utils::Profiler::setFrameWindow(size_t frameCount)
+{
+    const std::scoped_lock lock{m_flushMutex};
+    m_frameCallTree.setWindowSize(frameCount);
+}
+
+void vulk::utils::Profiler::flush()
+{
+    const std::scoped_lock lock{m_flushMutex, m_buffersMutex};
+
+    const ThreadBuffer* frameThreadBuffer = m_frameThreadBuffer.load();
+
+    for (auto it = m_buffers.begin(); it != m_buffers.end();)
+    {
+        ThreadBuffer& buffer = **it;
+        const bool isFrameThread = &buffer == frameThreadBuffer;
+
+        // Loaded first, the zones pushed before the thread exited are then all consumed below
+        const bool retired = buffer.retired.load(std::memory_order_acquire);
+
+        buffer.zones.consume([&](const Zone& zone) {
+            if (isTracing())
+                writeZone(zone, buffer.threadId);
+
+            if (!isFrameThread)
+                return;
+
+            if (zone.descriptor)
+            {
+                m_currentFrame.push_back({zone.descriptor->name, zone.begin, zone.end});
+            } else
+            {
+                m_frameCallTree.addFrame(m_currentFrame);
+                m_currentFrame.clear();
+            }
+        });
+
+        if (!retired)
+        {
+            ++it;
+            continue;
+        }
+
+        // The next thread to mark a frame becomes the frame thread
+        if (isFrameThread)
+        {
+            m_frameThreadBuffer.store(nullptr);
+            m_currentFrame.clear();
+        }
+
+        it = m_buffers.erase(it);
+    }
+
+    if (isTracing())
+        m_output.flush();
+}
+
+vulk::utils::Profiler::ThreadBuffer* vulk::utils::Profiler::getThreadBuffer()
+{
+    // The owner is destroyed, a new buffer would never be retired
+    if (s_threadExited)
+        return nullptr;
+
+    if (!s_threadBuffer.buffer)
+    {
+        const std::scoped_lock lock{m_buffersMutex};
+
+        auto& buffer = m_buffers.emplace_back(std::make_unique<ThreadBuffer>());
+        buffer->threadId = m_nextThreadId++;
+        s_threadBuffer.buffer = buffer.get();
+    }
+
+    return s_threadBuffer.buffer;
+}
+
+void vulk::utils::Profiler::push(const Zone& zone) noexcept
+{
+    try
+    {
+        ThreadBuffer* buffer = getThreadBuffer();
+
+        if (!buffer || !buffer->zones.tryPush(zone))
+            ++m_droppedZones;
+    } catch (...)
+    {
+        // Only registering a new thread can throw, out of memory
+        ++m_droppedZones;
+    }
+}
+
+void vulk::utils::Profiler::runFlusher()
+{
+    std::unique_lock lock{m_flusherMutex};
+
+    while (!m_stopFlusher)
+    {
+        m_flusherWakeUp.wait_for(lock, FlushPeriod, [this] { return m_stopFlusher; });
+
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+void vulk::utils::Profiler::closeTrace()
 {
+    if (!isTracing())
+        return;
+
+    {
+        const std::scoped_lock lock{m_flusherMutex};
+        m_stopFlusher = true;
+    }
+
+    m_flusherWakeUp.notify_one();
+    m_flusher.join();
+
+    flush();
+
+    const std::scoped_lock lock{m_flushMutex};
+
+    m_tracing.store(false);
+    m_output << "\n]\n";
+    m_output.close();
 }
 
-vulk::utils::ScopedProfiler::~ScopedProfiler()
+void vulk::utils::Profiler::writeZone(const Zone& zone, uint32_t threadId)
 {
-    const auto end = Clock::now();
-    const DurationSeconds durationSeconds = end - m_start;
-    const DurationMillis durationMillis = durationSeconds;
-    const auto oldFill = std::cerr.fill();
+    // Recorded before the trace started
+    if (zone.begin < m_traceStart)
+        return;
+
+    const double start = Microseconds{Clock::duration{zone.begin - m_traceStart}}.count();
+
+    m_output << (m_firstZone ? "" : ",\n");
+    m_firstZone = false;
+
+    if (!zone.descriptor)
+    {
+        m_output << R"({"name":"Frame","ph":"i","s":"t","pid":0,"tid":)" << threadId << R"(,"ts":)" << start << '}';
+        return;
+    }
+
+    const ZoneDescriptor& descriptor = *zone.descriptor;
 
-    std::cerr << std::left << std::setfill('.') << std::setw(70) << m_name << durationMillis.count() << "ms" << '\n'
-              << std::setfill(oldFill);
+    m_output << R"({"name":")";
+    writeEscaped(m_output, descriptor.name);
+    m_output << R"(","cat":")" << getCategoryName(descriptor.category) << R"(","ph":"X","pid":0,"tid":)" << threadId
+             << R"(,"ts":)" << start << R"(,"dur":)" << Microseconds{Clock::duration{zone.end - zone.begin}}.count()
+             << R"(,"args":{"file":")";
+    writeEscaped(m_output, descriptor.file);
+    m_output << R"(","line":)" << descriptor.line << "}}";
 }
@@ -19,29 +19,55 @@
 
 #include "Vulk/Shader.hpp"
 
-#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <string>
+#include <utility>
 
 #include "Vulk/Exceptions.hpp"
-#include "Vulk/ScopedProfiler.hpp"
-#include "Vulk/Utils.hpp"
 
-vulk::Shader::Shader(vk::Device& device, const char* filePath, vulk::Shader::Type type)
-    : m_device{device}, m_buffer{vulk::utils::fileToBinary(filePath)}, m_type{type}
+vulk::Shader::Shader(const vk::Device& device, const char* filePath, vulk::Shader::Type type)
+    : Shader{ShaderLibrary::loadModule(device, filePath), type}
 {
-    vk::ShaderModuleCreateInfo shaderModuleCreateInfo{};
-    shaderModuleCreateInfo.codeSize = m_buffer.size();
-    shaderModuleCreateInfo.pCode = reinterpret_cast<decltype(shaderModuleCreateInfo.pCode)>(m_buffer.data());
+}
 
-    handleVulkanError(device.createShaderModule(&shaderModuleCreateInfo, nullptr, &m_shaderModule));
-    assert(m_shaderModule);
+vulk::Shader::Shader(const vk::Device& device, std::span<const uint32_t> code, vulk::Shader::Type type)
+    : Shader{std::make_shared<const ShaderLibrary::Module>(device, code), type}
+{
+}
+
+vulk::Shader::Shader(std::shared_ptr<const ShaderLibrary::Module> module, vulk::Shader::Type type)
+    : m_module{std::move(module)}, m_type{type}
+{
+    assert(m_module->getReflection().getStages() == vk::ShaderStageFlags{m_type});
 
-    m_pipelineShaderStageCreateInfo.stage = type;
-    m_pipelineShaderStageCreateInfo.module = m_shaderModule;
+    m_pipelineShaderStageCreateInfo.stage = m_type;
+    m_pipelineShaderStageCreateInfo.module = m_module->getHandle();
     m_pipelineShaderStageCreateInfo.pName = "main";
 }
 
-vulk::Shader::~Shader()
+void vulk::Shader::specialize(const SpecializationConstants& constants)
 {
-    if (m_device && m_shaderModule)
-        m_device.destroy(m_shaderModule);
+    const auto& declared = getReflection().getSpecializationConstants();
+
+    for (const uint32_t id : constants.getIds())
+    {
+        const auto it = std::find_if(declared.begin(), declared.end(),
+                                     [id](const ShaderReflection::SpecializationConstant& constant) {
+                                         return constant.id == id;
+                                     });
+
+        if (it == declared.end() || it->size != sizeof(uint32_t))
+            throw ShaderReflectionException{"No 32 bit specialization constant " + std::to_string(id)};
+    }
+
+    m_specializationMapEntries = constants.getMapEntries();
+    m_specializationData.assign(constants.getData().begin(), constants.getData().end());
+
+    m_specializationInfo.mapEntryCount = static_cast<uint32_t>(m_specializationMapEntries.size());
+    m_specializationInfo.pMapEntries = m_specializationMapEntries.data();
+    m_specializationInfo.dataSize = m_specializationData.size() * sizeof(uint32_t);
+    m_specializationInfo.pData = m_specializationData.data();
+
+    m_pipelineShaderStageCreateInfo.pSpecializationInfo = constants.empty() ? nullptr : &m_specializationInfo;
 }
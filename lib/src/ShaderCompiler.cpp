@@ -0,0 +1,275 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/ShaderCompiler.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+#include "Vulk/Exceptions.hpp"
+#include "Vulk/ScopedProfiler.hpp"
+#include "Vulk/Utils.hpp"
+
+namespace {
+// Bump when the way binaries are produced changes in a way the key doesn't capture
+constexpr std::string_view CacheVersion = "vulk-spirv-cache-1";
+
+// SPIR-V header: magic number, version, generator, bound, schema
+constexpr uint32_t SpirvMagic = 0x07230203;
+constexpr size_t SpirvHeaderWordCount = 5;
+
+constexpr shaderc_optimization_level DefaultOptimizationLevel =
+#if VULK_DEBUG
+  shaderc_optimization_level_zero;
+#else
+  shaderc_optimization_level_performance;
+#endif
+
+std::string readFile(const std::filesystem::path& path)
+{
+    const std::vector<char> content{vulk::utils::fileToBinary(path.string().c_str())};
+    return {content.begin(), content.end()};
+}
+
+/**
+ * Resolves includes relative to the including file, then through the include directories.
+ */
+class FileIncluder : public shaderc::CompileOptions::IncluderInterface
+{
+public:
+    explicit FileIncluder(std::vector<std::string> includeDirectories)
+        : m_includeDirectories{std::move(includeDirectories)}
+    {
+    }
+
+    shaderc_include_result* GetInclude(const char* requestedSource, shaderc_include_type type,
+                                       const char* requestingSource, size_t /* includeDepth */) override
+    {
+        auto include = std::make_unique<Include>();
+
+        std::vector<std::filesystem::path> candidates{};
+
+        if (type == shaderc_include_type_relative)
+            candidates.push_back(std::filesystem::path{requestingSource}.parent_path() / requestedSource);
+
+        for (const auto& directory : m_includeDirectories)
+            candidates.push_back(std::filesystem::path{directory} / requestedSource);
+
+        for (const auto& candidate : candidates)
+        {
+            if (std::filesystem::is_regular_file(candidate))
+            {
+                include->name = candidate.string();
+                include->content = readFile(candidate);
+                break;
+            }
+        }
+
+        // An empty name signals the error, the content is the message
+        if (include->name.empty())
+            include->content = std::string{"Unable to find include file "} + requestedSource;
+
+        include->result.source_name = include->name.c_str();
+        include->result.source_name_length = include->name.size();
+        include->result.content = include->content.c_str();
+        include->result.content_length = include->content.size();
+        include->result.user_data = include.get();
+
+        return &include.release()->result;
+    }
+
+    void ReleaseInclude(shaderc_include_result* data) override { delete static_cast<Include*>(data->user_data); }
+
+private:
+    struct Include
+    {
+        std::string name{};
+        std::string content{};
+        shaderc_include_result result{};
+    };
+
+    std::vector<std::string> m_includeDirectories;
+};
+
+shaderc_shader_kind getShaderKind(vk::ShaderStageFlagBits stage)
+{
+    switch (stage)
+    {
+    case vk::ShaderStageFlagBits::eVertex: return shaderc_glsl_vertex_shader;
+    case vk::ShaderStageFlagBits::eFragment: return shaderc_glsl_fragment_shader;
+    case vk::ShaderStageFlagBits::eCompute: return shaderc_glsl_compute_shader;
+    default: throw vulk::ShaderCompilationException("Unsupported shader stage");
+    }
+}
+
+/**
+ * The shaderc package the library is built against, along with the SPIR-V version it targets.
+ */
+std::string getCompilerVersion()
+{
+    unsigned int version = 0;
+    unsigned int revision = 0;
+    shaderc_get_spv_version(&version, &revision);
+
+    return std::string{VULK_SHADERC_VERSION} + " spv " + std::to_string(version) + '.' + std::to_string(revision);
+}
+}  // namespace
+
+std::span<const uint32_t> vulk::SpirvCode::getWords() const noexcept
+{
+    if (const auto* file = std::get_if<MappedFile>(&m_storage))
+        return {reinterpret_cast<const uint32_t*>(file->getData()), file->getSize() / sizeof(uint32_t)};
+
+    return std::get<std::vector<uint32_t>>(m_storage);
+}
+
+vulk::ShaderCompiler::ShaderCompiler(std::string cacheDirectory)
+    : m_cacheDirectory{std::move(cacheDirectory)}, m_optimizationLevel{DefaultOptimizationLevel}
+{
+    if (!m_compiler.IsValid())
+        throw LibraryException("Unable to initialize shaderc");
+}
+
+void vulk::ShaderCompiler::addIncludeDirectory(std::string directory)
+{
+    m_includeDirectories.push_back(std::move(directory));
+}
+
+vulk::SpirvCode vulk::ShaderCompiler::compileFile(const char* filePath, vk::ShaderStageFlagBits stage,
+                                                  std::span<const Define> defines) const
+{
+    const MappedFile file{filePath};
+    return compile(file.getView(), filePath, stage, defines);
+}
+
+vulk::SpirvCode vulk::ShaderCompiler::compile(std::string_view source, const std::string& fileName,
+                                              vk::ShaderStageFlagBits stage, std::span<const Define> defines) const
+{
+    VULK_SCOPED_PROFILER_CATEGORY("ShaderCompiler::compile()", eShaders);
+
+    const shaderc_shader_kind kind = getShaderKind(stage);
+    const shaderc::CompileOptions options{makeOptions(defines)};
+
+    const shaderc::PreprocessedSourceCompilationResult preprocessed =
+      m_compiler.PreprocessGlsl(source.data(), source.size(), kind, fileName.c_str(), options);
+
+    if (preprocessed.GetCompilationStatus() != shaderc_compilation_status_success)
+        throw ShaderCompilationException(preprocessed.GetErrorMessage());
+
+    const std::string_view preprocessedSource{preprocessed.cbegin(),
+                                              static_cast<size_t>(preprocessed.cend() - preprocessed.cbegin())};
+
+    static const std::string s_compilerVersion{getCompilerVersion()};
+
+    uint64_t hash = utils::hashFnv1a(CacheVersion);
+    hash = utils::hashFnv1a(s_compilerVersion, hash);
+    hash = utils::hashFnv1a(std::to_string(static_cast<uint32_t>(stage)), hash);
+    hash = utils::hashFnv1a(std::to_string(static_cast<int>(m_optimizationLevel)), hash);
+    hash = utils::hashFnv1a(preprocessedSource, hash);
+
+    std::ostringstream cacheName{};
+    cacheName << std::hex << hash << ".spv";
+
+    const std::filesystem::path cachePath{std::filesystem::path{m_cacheDirectory} / cacheName.str()};
+
+    if (std::error_code error{}; std::filesystem::is_regular_file(cachePath, error))
+    {
+        try
+        {
+            MappedFile cached{cachePath.string().c_str()};
+            const size_t size = cached.getSize();
+
+            // Truncated or foreign files are rebuilt, and replaced below
+            if (size % sizeof(uint32_t) == 0 && size > SpirvHeaderWordCount * sizeof(uint32_t) &&
+                *reinterpret_cast<const uint32_t*>(cached.getData()) == SpirvMagic)
+                return SpirvCode{std::move(cached)};
+        } catch (const IOException& e)
+        {
+            std::cerr << "Unable to read the cached " << fileName << ": " << e.what() << '\n';
+        }
+    }
+
+    const shaderc::SpvCompilationResult result =
+      m_compiler.CompileGlslToSpv(preprocessedSource.data(), preprocessedSource.size(), kind, fileName.c_str(),
+                                  options);
+
+    if (result.GetCompilationStatus() != shaderc_compilation_status_success)
+        throw ShaderCompilationException(result.GetErrorMessage());
+
+    std::vector<uint32_t> words{result.cbegin(), result.cend()};
+
+    // Written aside then renamed, concurrent readers never see a partial file. Failing to cache is not an error.
+    try
+    {
+        static std::atomic<uint32_t> s_temporaryIndex{0};
+
+        std::filesystem::create_directories(m_cacheDirectory);
+
+        std::filesystem::path temporaryPath{cachePath};
+        temporaryPath += ".tmp" + std::to_string(s_temporaryIndex++);
+
+        std::ofstream output{temporaryPath, std::ios::binary | std::ios::trunc};
+        output.write(reinterpret_cast<const char*>(words.data()),
+                     static_cast<std::streamsize>(words.size() * sizeof(uint32_t)));
+        output.close();
+
+        if (output)
+            std::filesystem::rename(temporaryPath, cachePath);
+        else
+            std::filesystem::remove(temporaryPath);
+    } catch (const std::filesystem::filesystem_error& e)
+    {
+        std::cerr << "Unable to cache " << fileName << ": " << e.what() << '\n';
+    }
+
+    return SpirvCode{std::move(words)};
+}
+
+vk::ShaderStageFlagBits vulk::ShaderCompiler::getStageFromPath(std::string_view filePath)
+{
+    if (filePath.ends_with(".spv"))
+        filePath.remove_suffix(4);
+
+    if (filePath.ends_with(".vert"))
+        return vk::ShaderStageFlagBits::eVertex;
+    if (filePath.ends_with(".frag"))
+        return vk::ShaderStageFlagBits::eFragment;
+    if (filePath.ends_with(".comp"))
+        return vk::ShaderStageFlagBits::eCompute;
+
+    throw ShaderCompilationException(std::string{filePath} + ": unknown shader stage");
+}
+
+shaderc::CompileOptions vulk::ShaderCompiler::makeOptions(std::span<const Define> defines) const
+{
+    shaderc::CompileOptions options{};
+
+    options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_2);
+    options.SetOptimizationLevel(m_optimizationLevel);
+    options.SetIncluder(std::make_unique<FileIncluder>(m_includeDirectories));
+
+    for (const Define& define : defines)
+        options.AddMacroDefinition(define.name, define.value);
+
+    return options;
+}
@@ -0,0 +1,110 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/ShaderLibrary.hpp"
+
+#include <cassert>
+
+#include "Vulk/EmbeddedShaders.hpp"
+#include "Vulk/Exceptions.hpp"
+#include "Vulk/MappedFile.hpp"
+#include "Vulk/ScopedProfiler.hpp"
+
+vulk::ShaderLibrary::Module::Module(const vk::Device& device, std::span<const uint32_t> code)
+    : m_device{device}, m_reflection{code}
+{
+    vk::ShaderModuleCreateInfo shaderModuleCreateInfo{};
+    shaderModuleCreateInfo.codeSize = code.size_bytes();
+    shaderModuleCreateInfo.pCode = code.data();
+
+    handleVulkanError(m_device.createShaderModule(&shaderModuleCreateInfo, nullptr, &m_module));
+    assert(m_module);
+}
+
+vulk::ShaderLibrary::Module::~Module()
+{
+    if (m_device && m_module)
+        m_device.destroy(m_module);
+}
+
+vulk::ShaderLibrary::ShaderLibrary(const vk::Device& device) : m_device{device} {}
+
+std::shared_ptr<const vulk::ShaderLibrary::Module> vulk::ShaderLibrary::loadModule(const vk::Device& device,
+                                                                                  const char* filePath)
+{
+    VULK_SCOPED_PROFILER_CATEGORY("ShaderLibrary::loadModule()", eShaders);
+
+#if VULK_EMBED_SHADERS
+    // No I/O at all, the paths are only used as keys
+    if (const std::span<const uint32_t> code = embedded::findShader(filePath); !code.empty())
+        return std::make_shared<const Module>(device, code);
+#endif
+
+    // Mappings are page aligned, the code can be read in place
+    const MappedFile file{filePath};
+    return std::make_shared<const Module>(device, std::span{reinterpret_cast<const uint32_t*>(file.getData()),
+                                                            file.getSize() / sizeof(uint32_t)});
+}
+
+std::shared_ptr<const vulk::ShaderLibrary::Module> vulk::ShaderLibrary::getModule(const std::string& filePath)
+{
+    VULK_SCOPED_PROFILER_CATEGORY("ShaderLibrary::getModule()", eShaders);
+
+    {
+        const std::scoped_lock lock{m_mutex};
+
+        if (const auto it = m_modules.find(filePath); it != m_modules.end())
+        {
+            ++m_statistics.hits;
+            return it->second;
+        }
+    }
+
+    std::shared_ptr<const Module> module = loadModule(m_device, filePath.c_str());
+
+    const std::scoped_lock lock{m_mutex};
+    ++m_statistics.loads;
+
+    // Another thread may have loaded it in the meantime, the first one wins
+    return m_modules.try_emplace(filePath, std::move(module)).first->second;
+}
+
+void vulk::ShaderLibrary::evict(const std::string& filePath)
+{
+    const std::scoped_lock lock{m_mutex};
+    m_modules.erase(filePath);
+}
+
+void vulk::ShaderLibrary::clear()
+{
+    const std::scoped_lock lock{m_mutex};
+    m_modules.clear();
+}
+
+size_t vulk::ShaderLibrary::getModuleCount() const
+{
+    const std::scoped_lock lock{m_mutex};
+    return m_modules.size();
+}
+
+vulk::ShaderLibrary::Statistics vulk::ShaderLibrary::getStatistics() const
+{
+    const std::scoped_lock lock{m_mutex};
+    return m_statistics;
+}
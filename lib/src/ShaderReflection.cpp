@@ -0,0 +1,670 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/ShaderReflection.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <string>
+
+#include "Vulk/Exceptions.hpp"
+#include "Vulk/ScopedProfiler.hpp"
+
+namespace {
+constexpr uint32_t MagicNumber = 0x07230203;
+constexpr size_t HeaderWordCount = 5;
+
+// Subset of the SPIR-V specification needed to walk the global declarations
+enum class Op : uint32_t
+{
+    Nop = 0,
+    EntryPoint = 15,
+    TypeBool = 20,
+    TypeInt = 21,
+    TypeFloat = 22,
+    TypeVector = 23,
+    TypeMatrix = 24,
+    TypeImage = 25,
+    TypeSampler = 26,
+    TypeSampledImage = 27,
+    TypeArray = 28,
+    TypeRuntimeArray = 29,
+    TypeStruct = 30,
+    TypePointer = 32,
+    Constant = 43,
+    SpecConstantTrue = 48,
+    SpecConstantFalse = 49,
+    SpecConstant = 50,
+    Variable = 59,
+    Decorate = 71,
+    MemberDecorate = 72,
+    TypeAccelerationStructure = 5341,
+};
+
+enum class Decoration : uint32_t
+{
+    SpecId = 1,
+    Block = 2,
+    BufferBlock = 3,
+    RowMajor = 4,
+    ArrayStride = 6,
+    MatrixStride = 7,
+    BuiltIn = 11,
+    Location = 30,
+    Binding = 33,
+    DescriptorSet = 34,
+    Offset = 35,
+};
+
+enum class StorageClass : uint32_t
+{
+    UniformConstant = 0,
+    Input = 1,
+    Uniform = 2,
+    PushConstant = 9,
+    StorageBuffer = 12,
+};
+
+enum class ExecutionModel : uint32_t
+{
+    Vertex = 0,
+    TessellationControl = 1,
+    TessellationEvaluation = 2,
+    Geometry = 3,
+    Fragment = 4,
+    GLCompute = 5,
+};
+
+constexpr uint32_t ImageDimBuffer = 5;
+constexpr uint32_t ImageDimSubpassData = 6;
+
+struct Definition
+{
+    Op op{Op::Nop};
+    uint32_t resultType{0};
+    std::span<const uint32_t> operands{};  // Words following the result id
+};
+
+struct Decorations
+{
+    std::optional<uint32_t> set{};
+    std::optional<uint32_t> binding{};
+    std::optional<uint32_t> location{};
+    std::optional<uint32_t> specId{};
+    uint32_t arrayStride{0};
+    bool block{false};
+    bool bufferBlock{false};
+    bool builtIn{false};
+};
+
+struct MemberDecorations
+{
+    uint32_t offset{0};
+    uint32_t matrixStride{0};
+    bool rowMajor{false};
+};
+
+/**
+ * Id indexed tables of the module's types, constants, variables and decorations.
+ * The definitions point into the code, which must outlive the module.
+ */
+class Module
+{
+public:
+    explicit Module(std::span<const uint32_t> code)
+    {
+        if (code.size() < HeaderWordCount || code[0] != MagicNumber)
+            throw vulk::InvalidFormatException{"Not a SPIR-V module"};
+
+        const uint32_t bound = code[3];
+        m_definitions.resize(bound);
+        m_decorations.resize(bound);
+        m_memberDecorations.resize(bound);
+
+        for (size_t i = HeaderWordCount; i < code.size();)
+        {
+            const uint32_t wordCount = code[i] >> 16u;
+
+            if (wordCount == 0 || i + wordCount > code.size())
+                throw vulk::InvalidFormatException{"Truncated SPIR-V instruction"};
+
+            parseInstruction(static_cast<Op>(code[i] & 0xFFFFu), code.subspan(i + 1, wordCount - 1));
+            i += wordCount;
+        }
+    }
+
+    [[nodiscard]] const Definition& getDefinition(uint32_t id) const
+    {
+        if (id >= m_definitions.size() || m_definitions[id].op == Op::Nop)
+            throw vulk::InvalidFormatException{"Undefined SPIR-V id " + std::to_string(id)};
+
+        return m_definitions[id];
+    }
+
+    [[nodiscard]] const Decorations& getDecorations(uint32_t id) const noexcept { return m_decorations[id]; }
+    [[nodiscard]] const std::vector<uint32_t>& getVariables() const noexcept { return m_variables; }
+    [[nodiscard]] const std::vector<uint32_t>& getSpecConstants() const noexcept { return m_specConstants; }
+    [[nodiscard]] const std::vector<ExecutionModel>& getExecutionModels() const noexcept { return m_executionModels; }
+
+    [[nodiscard]] uint32_t getConstant(uint32_t id) const
+    {
+        const Definition& constant = getDefinition(id);
+
+        // Specialized lengths are reflected with their default value
+        if ((constant.op != Op::Constant && constant.op != Op::SpecConstant) || constant.operands.empty())
+            throw vulk::ShaderReflectionException{"Array lengths must be constants"};
+
+        return constant.operands[0];
+    }
+
+    /** Pointee of a variable's pointer type. */
+    [[nodiscard]] uint32_t getPointeeType(const Definition& variable) const
+    {
+        const Definition& pointer = getDefinition(variable.resultType);
+        return pointer.operands[1];
+    }
+
+    /** Byte size of a type as laid out in a buffer, following the explicit layout decorations. */
+    [[nodiscard]] uint32_t getSize(uint32_t typeId, const MemberDecorations* member = nullptr) const
+    {
+        const Definition& type = getDefinition(typeId);
+
+        switch (type.op)
+        {
+        case Op::TypeBool: return 4;
+        case Op::TypeInt:
+        case Op::TypeFloat: return type.operands[0] / 8;
+        case Op::TypeVector: return getSize(type.operands[0]) * type.operands[1];
+        case Op::TypeMatrix:
+        {
+            const uint32_t columnCount = type.operands[1];
+
+            if (!member || member->matrixStride == 0)
+                return getSize(type.operands[0]) * columnCount;
+
+            const uint32_t rowCount = getDefinition(type.operands[0]).operands[1];
+            return (member->rowMajor ? rowCount : columnCount) * member->matrixStride;
+        }
+        case Op::TypeArray:
+        {
+            const uint32_t stride = m_decorations[typeId].arrayStride;
+            const uint32_t length = getConstant(type.operands[1]);
+            return length * (stride != 0 ? stride : getSize(type.operands[0], member));
+        }
+        case Op::TypeRuntimeArray: return 0;
+        case Op::TypeStruct:
+        {
+            uint32_t size = 0;
+            const auto& members = m_memberDecorations[typeId];
+
+            for (size_t i = 0; i < type.operands.size(); ++i)
+            {
+                const MemberDecorations* decorations = i < members.size() ? &members[i] : nullptr;
+                const uint32_t offset = decorations ? decorations->offset : size;
+                size = std::max(size, offset + getSize(type.operands[i], decorations));
+            }
+
+            return size;
+        }
+        default: throw vulk::ShaderReflectionException{"Type has no size in a buffer"};
+        }
+    }
+
+    /** Offset of the first member of a struct. */
+    [[nodiscard]] uint32_t getFirstMemberOffset(uint32_t structId) const noexcept
+    {
+        const auto& members = m_memberDecorations[structId];
+
+        uint32_t offset = members.empty() ? 0 : std::numeric_limits<uint32_t>::max();
+        for (const auto& member : members)
+            offset = std::min(offset, member.offset);
+
+        return offset;
+    }
+
+private:
+    void parseInstruction(Op op, std::span<const uint32_t> words)
+    {
+        const auto defineType = [&]() {
+            if (!words.empty())
+                define(words[0], Definition{op, 0, words.subspan(1)});
+        };
+
+        switch (op)
+        {
+        case Op::EntryPoint:
+            if (!words.empty())
+                m_executionModels.push_back(static_cast<ExecutionModel>(words[0]));
+            break;
+        case Op::TypeBool:
+        case Op::TypeInt:
+        case Op::TypeFloat:
+        case Op::TypeVector:
+        case Op::TypeMatrix:
+        case Op::TypeImage:
+        case Op::TypeSampler:
+        case Op::TypeSampledImage:
+        case Op::TypeArray:
+        case Op::TypeRuntimeArray:
+        case Op::TypeStruct:
+        case Op::TypePointer:
+        case Op::TypeAccelerationStructure:
+            defineType();
+            break;
+        case Op::Constant:
+        case Op::SpecConstantTrue:
+        case Op::SpecConstantFalse:
+        case Op::SpecConstant:
+        case Op::Variable:
+            if (words.size() >= 2)
+                define(words[1], Definition{op, words[0], words.subspan(2)});
+            if (op == Op::Variable && words.size() >= 3)
+                m_variables.push_back(words[1]);
+            if (op != Op::Constant && op != Op::Variable && words.size() >= 2)
+                m_specConstants.push_back(words[1]);
+            break;
+        case Op::Decorate:
+            if (words.size() >= 2)
+                decorate(words[0], static_cast<Decoration>(words[1]), words.subspan(2));
+            break;
+        case Op::MemberDecorate:
+            if (words.size() >= 3)
+                decorateMember(words[0], words[1], static_cast<Decoration>(words[2]), words.subspan(3));
+            break;
+        default: break;
+        }
+    }
+
+    void define(uint32_t id, const Definition& definition)
+    {
+        if (id >= m_definitions.size())
+            throw vulk::InvalidFormatException{"SPIR-V id out of bounds"};
+
+        m_definitions[id] = definition;
+    }
+
+    void decorate(uint32_t id, Decoration decoration, std::span<const uint32_t> literals)
+    {
+        if (id >= m_decorations.size())
+            throw vulk::InvalidFormatException{"SPIR-V id out of bounds"};
+
+        Decorations& decorations = m_decorations[id];
+        const uint32_t literal = literals.empty() ? 0 : literals[0];
+
+        switch (decoration)
+        {
+        case Decoration::Block:
+            decorations.block = true;
+            break;
+        case Decoration::BufferBlock:
+            decorations.bufferBlock = true;
+            break;
+        case Decoration::ArrayStride:
+            decorations.arrayStride = literal;
+            break;
+        case Decoration::BuiltIn:
+            decorations.builtIn = true;
+            break;
+        case Decoration::Location:
+            decorations.location = literal;
+            break;
+        case Decoration::SpecId:
+            decorations.specId = literal;
+            break;
+        case Decoration::Binding:
+            decorations.binding = literal;
+            break;
+        case Decoration::DescriptorSet:
+            decorations.set = literal;
+            break;
+        default: break;
+        }
+    }
+
+    void decorateMember(uint32_t id, uint32_t member, Decoration decoration, std::span<const uint32_t> literals)
+    {
+        if (id >= m_memberDecorations.size())
+            throw vulk::InvalidFormatException{"SPIR-V id out of bounds"};
+
+        auto& members = m_memberDecorations[id];
+        if (member >= members.size())
+            members.resize(member + 1);
+
+        const uint32_t literal = literals.empty() ? 0 : literals[0];
+
+        switch (decoration)
+        {
+        case Decoration::Offset:
+            members[member].offset = literal;
+            break;
+        case Decoration::MatrixStride:
+            members[member].matrixStride = literal;
+            break;
+        case Decoration::RowMajor:
+            members[member].rowMajor = true;
+            break;
+        default: break;
+        }
+    }
+
+    std::vector<Definition> m_definitions{};
+    std::vector<Decorations> m_decorations{};
+    std::vector<std::vector<MemberDecorations>> m_memberDecorations{};
+    std::vector<uint32_t> m_variables{};
+    std::vector<uint32_t> m_specConstants{};
+    std::vector<ExecutionModel> m_executionModels{};
+};
+
+vk::ShaderStageFlagBits toShaderStage(ExecutionModel executionModel)
+{
+    switch (executionModel)
+    {
+    case ExecutionModel::Vertex: return vk::ShaderStageFlagBits::eVertex;
+    case ExecutionModel::TessellationControl: return vk::ShaderStageFlagBits::eTessellationControl;
+    case ExecutionModel::TessellationEvaluation: return vk::ShaderStageFlagBits::eTessellationEvaluation;
+    case ExecutionModel::Geometry: return vk::ShaderStageFlagBits::eGeometry;
+    case ExecutionModel::Fragment: return vk::ShaderStageFlagBits::eFragment;
+    case ExecutionModel::GLCompute: return vk::ShaderStageFlagBits::eCompute;
+    default:
+        throw vulk::ShaderReflectionException{"Unsupported execution model " +
+                                              std::to_string(static_cast<uint32_t>(executionModel))};
+    }
+}
+
+vk::DescriptorType getDescriptorType(const Module& module, StorageClass storageClass, uint32_t typeId)
+{
+    const Definition& type = module.getDefinition(typeId);
+
+    switch (storageClass)
+    {
+    case StorageClass::Uniform:
+        // Before SPIR-V 1.3, storage buffers are uniform blocks decorated as buffer blocks
+        return module.getDecorations(typeId).bufferBlock ? vk::DescriptorType::eStorageBuffer :
+                                                           vk::DescriptorType::eUniformBuffer;
+    case StorageClass::StorageBuffer: return vk::DescriptorType::eStorageBuffer;
+    case StorageClass::UniformConstant: break;
+    default: throw vulk::ShaderReflectionException{"Unsupported descriptor storage class"};
+    }
+
+    switch (type.op)
+    {
+    case Op::TypeSampler: return vk::DescriptorType::eSampler;
+    case Op::TypeSampledImage: return vk::DescriptorType::eCombinedImageSampler;
+    case Op::TypeAccelerationStructure: return vk::DescriptorType::eAccelerationStructureKHR;
+    case Op::TypeImage:
+    {
+        // Sampled type, dim, depth, arrayed, multisampled, sampled
+        const uint32_t dim = type.operands[1];
+        const bool sampled = type.operands[5] == 1;
+
+        if (dim == ImageDimBuffer)
+            return sampled ? vk::DescriptorType::eUniformTexelBuffer : vk::DescriptorType::eStorageTexelBuffer;
+        if (dim == ImageDimSubpassData)
+            return vk::DescriptorType::eInputAttachment;
+
+        return sampled ? vk::DescriptorType::eSampledImage : vk::DescriptorType::eStorageImage;
+    }
+    default: throw vulk::ShaderReflectionException{"Unsupported uniform constant type"};
+    }
+}
+
+vk::Format getVertexFormat(const Module& module, uint32_t componentTypeId, uint32_t componentCount)
+{
+    static constexpr std::array Float32{vk::Format::eR32Sfloat, vk::Format::eR32G32Sfloat,
+                                        vk::Format::eR32G32B32Sfloat, vk::Format::eR32G32B32A32Sfloat};
+    static constexpr std::array Sint32{vk::Format::eR32Sint, vk::Format::eR32G32Sint, vk::Format::eR32G32B32Sint,
+                                       vk::Format::eR32G32B32A32Sint};
+    static constexpr std::array Uint32{vk::Format::eR32Uint, vk::Format::eR32G32Uint, vk::Format::eR32G32B32Uint,
+                                       vk::Format::eR32G32B32A32Uint};
+    static constexpr std::array Float64{vk::Format::eR64Sfloat, vk::Format::eR64G64Sfloat,
+                                        vk::Format::eR64G64B64Sfloat, vk::Format::eR64G64B64A64Sfloat};
+
+    const Definition& component = module.getDefinition(componentTypeId);
+    const uint32_t width = component.operands.empty() ? 0 : component.operands[0];
+
+    if (componentCount == 0 || componentCount > 4)
+        throw vulk::ShaderReflectionException{"Invalid vertex input component count"};
+
+    const size_t index = componentCount - 1;
+
+    if (component.op == Op::TypeFloat && width == 32)
+        return Float32[index];
+    if (component.op == Op::TypeFloat && width == 64)
+        return Float64[index];
+    if (component.op == Op::TypeInt && width == 32)
+        return component.operands[1] == 1 ? Sint32[index] : Uint32[index];
+
+    throw vulk::ShaderReflectionException{"Unsupported vertex input type"};
+}
+
+/**
+ * Appends the inputs of a variable starting at `location`, returns the number of locations consumed.
+ */
+uint32_t addVertexInputs(const Module& module, uint32_t typeId, uint32_t location,
+                         std::vector<vulk::ShaderReflection::VertexInput>& inputs)
+{
+    const Definition& type = module.getDefinition(typeId);
+
+    switch (type.op)
+    {
+    case Op::TypeArray:
+    case Op::TypeMatrix:
+    {
+        const uint32_t count = type.op == Op::TypeArray ? module.getConstant(type.operands[1]) : type.operands[1];
+
+        uint32_t locationCount = 0;
+        for (uint32_t i = 0; i < count; ++i)
+            locationCount += addVertexInputs(module, type.operands[0], location + locationCount, inputs);
+
+        return locationCount;
+    }
+    case Op::TypeVector:
+    case Op::TypeInt:
+    case Op::TypeFloat:
+    {
+        const bool isVector = type.op == Op::TypeVector;
+        const uint32_t componentTypeId = isVector ? type.operands[0] : typeId;
+        const uint32_t componentCount = isVector ? type.operands[1] : 1;
+
+        const uint32_t size = module.getSize(typeId);
+        inputs.push_back({location, getVertexFormat(module, componentTypeId, componentCount), size});
+
+        // 64 bit three and four component vectors take two locations
+        return size > 16 ? 2 : 1;
+    }
+    default: throw vulk::ShaderReflectionException{"Unsupported vertex input type"};
+    }
+}
+}  // namespace
+
+vulk::ShaderReflection::ShaderReflection(std::span<const uint32_t> code)
+{
+    VULK_SCOPED_PROFILER_CATEGORY("ShaderReflection::ShaderReflection()", eShaders);
+
+    const Module module{code};
+
+    bool isVertexShader = false;
+    for (const ExecutionModel executionModel : module.getExecutionModels())
+    {
+        m_stages |= toShaderStage(executionModel);
+        isVertexShader |= executionModel == ExecutionModel::Vertex;
+    }
+
+    for (const uint32_t variableId : module.getVariables())
+    {
+        const Definition& variable = module.getDefinition(variableId);
+        const Decorations& decorations = module.getDecorations(variableId);
+        const auto storageClass = static_cast<StorageClass>(variable.operands[0]);
+
+        uint32_t typeId = module.getPointeeType(variable);
+
+        if (storageClass == StorageClass::PushConstant)
+        {
+            const uint32_t offset = module.getFirstMemberOffset(typeId);
+            m_pushConstantRange = vk::PushConstantRange{m_stages, offset, module.getSize(typeId) - offset};
+        } else if (storageClass == StorageClass::Input)
+        {
+            if (isVertexShader && decorations.location && !decorations.builtIn)
+                addVertexInputs(module, typeId, *decorations.location, m_vertexInputs);
+        } else if (decorations.binding)
+        {
+            DescriptorBinding descriptorBinding{};
+            descriptorBinding.set = decorations.set.value_or(0);
+            descriptorBinding.binding = *decorations.binding;
+            descriptorBinding.stages = m_stages;
+
+            // Arrays of descriptors
+            for (const Definition* type = &module.getDefinition(typeId);
+                 type->op == Op::TypeArray || type->op == Op::TypeRuntimeArray;
+                 type = &module.getDefinition(typeId))
+            {
+                if (type->op == Op::TypeRuntimeArray)
+                    throw ShaderReflectionException{"Unbounded descriptor arrays are not supported"};
+
+                descriptorBinding.count *= module.getConstant(type->operands[1]);
+                typeId = type->operands[0];
+            }
+
+            descriptorBinding.type = getDescriptorType(module, storageClass, typeId);
+            addDescriptorBinding(descriptorBinding);
+        }
+    }
+
+    std::sort(m_vertexInputs.begin(), m_vertexInputs.end(),
+              [](const VertexInput& lhs, const VertexInput& rhs) { return lhs.location < rhs.location; });
+
+    // Spec constants without an id are derived from others with OpSpecConstantOp, they can't be set
+    for (const uint32_t constantId : module.getSpecConstants())
+    {
+        const Decorations& decorations = module.getDecorations(constantId);
+
+        if (decorations.specId)
+        {
+            const uint32_t size = module.getSize(module.getDefinition(constantId).resultType);
+            m_specializationConstants.push_back(SpecializationConstant{*decorations.specId, size});
+        }
+    }
+
+    std::sort(m_specializationConstants.begin(), m_specializationConstants.end(),
+              [](const SpecializationConstant& lhs, const SpecializationConstant& rhs) { return lhs.id < rhs.id; });
+}
+
+void vulk::ShaderReflection::merge(const ShaderReflection& other)
+{
+    m_stages |= other.m_stages;
+
+    for (const auto& descriptorBinding : other.m_descriptorBindings)
+        addDescriptorBinding(descriptorBinding);
+
+    if (other.m_pushConstantRange)
+    {
+        if (m_pushConstantRange)
+        {
+            const uint32_t begin = std::min(m_pushConstantRange->offset, other.m_pushConstantRange->offset);
+            const uint32_t end = std::max(m_pushConstantRange->offset + m_pushConstantRange->size,
+                                          other.m_pushConstantRange->offset + other.m_pushConstantRange->size);
+
+            m_pushConstantRange->stageFlags |= other.m_pushConstantRange->stageFlags;
+            m_pushConstantRange->offset = begin;
+            m_pushConstantRange->size = end - begin;
+        } else
+        {
+            m_pushConstantRange = other.m_pushConstantRange;
+        }
+    }
+
+    for (const auto& input : other.m_vertexInputs)
+    {
+        const auto it = std::lower_bound(
+          m_vertexInputs.begin(), m_vertexInputs.end(), input.location,
+          [](const VertexInput& lhs, uint32_t location) { return lhs.location < location; });
+
+        if (it == m_vertexInputs.end() || it->location != input.location)
+            m_vertexInputs.insert(it, input);
+    }
+}
+
+uint32_t vulk::ShaderReflection::getSetCount() const noexcept
+{
+    return m_descriptorBindings.empty() ? 0 : m_descriptorBindings.back().set + 1;
+}
+
+std::vector<vk::DescriptorPoolSize> vulk::ShaderReflection::getPoolSizes(uint32_t set, uint32_t setCount) const
+{
+    std::vector<vk::DescriptorPoolSize> poolSizes{};
+
+    for (const auto& descriptorBinding : m_descriptorBindings)
+    {
+        if (descriptorBinding.set != set)
+            continue;
+
+        const auto it = std::find_if(poolSizes.begin(), poolSizes.end(), [&](const vk::DescriptorPoolSize& poolSize) {
+            return poolSize.type == descriptorBinding.type;
+        });
+
+        if (it != poolSizes.end())
+            it->descriptorCount += descriptorBinding.count * setCount;
+        else
+            poolSizes.push_back(vk::DescriptorPoolSize{descriptorBinding.type, descriptorBinding.count * setCount});
+    }
+
+    return poolSizes;
+}
+
+vulk::ShaderReflection::VertexInputLayout vulk::ShaderReflection::getVertexInputLayout(uint32_t binding) const
+{
+    VertexInputLayout layout{};
+    layout.binding.binding = binding;
+    layout.binding.inputRate = vk::VertexInputRate::eVertex;
+
+    layout.attributes.reserve(m_vertexInputs.size());
+    for (const auto& input : m_vertexInputs)
+    {
+        layout.attributes.push_back(vk::VertexInputAttributeDescription{input.location, binding, input.format,
+                                                                        layout.binding.stride});
+        layout.binding.stride += input.size;
+    }
+
+    return layout;
+}
+
+void vulk::ShaderReflection::addDescriptorBinding(const DescriptorBinding& descriptorBinding)
+{
+    const auto isBefore = [](const DescriptorBinding& lhs, const DescriptorBinding& rhs) {
+        return lhs.set < rhs.set || (lhs.set == rhs.set && lhs.binding < rhs.binding);
+    };
+
+    const auto it =
+      std::lower_bound(m_descriptorBindings.begin(), m_descriptorBindings.end(), descriptorBinding, isBefore);
+
+    if (it == m_descriptorBindings.end() || isBefore(descriptorBinding, *it))
+    {
+        m_descriptorBindings.insert(it, descriptorBinding);
+        return;
+    }
+
+    if (it->type != descriptorBinding.type || it->count != descriptorBinding.count)
+    {
+        throw ShaderReflectionException{"Stages disagree on set " + std::to_string(descriptorBinding.set) +
+                                        ", binding " + std::to_string(descriptorBinding.binding)};
+    }
+
+    it->stages |= descriptorBinding.stages;
+}
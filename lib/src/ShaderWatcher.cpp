@@ -0,0 +1,190 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/ShaderWatcher.hpp"
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Vulk/Exceptions.hpp"
+#include "Vulk/ScopedProfiler.hpp"
+
+namespace {
+bool isShaderSource(std::string_view name) noexcept
+{
+    return name.ends_with(".vert") || name.ends_with(".frag") || name.ends_with(".comp");
+}
+}  // namespace
+
+vulk::ShaderWatcher::ShaderWatcher(std::string sourceDirectory, std::string outputDirectory)
+    : m_sourceDirectory{std::move(sourceDirectory)}, m_outputDirectory{std::move(outputDirectory)}
+{
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (m_inotifyFd < 0)
+        throw IOException(std::string{"inotify_init1: "} + std::strerror(errno));
+
+    // Editors and build tools either rewrite files in place or replace them
+    constexpr uint32_t Events = IN_CLOSE_WRITE | IN_MOVED_TO;
+
+    m_sourceWatch = inotify_add_watch(m_inotifyFd, m_sourceDirectory.c_str(), Events);
+    m_outputWatch = inotify_add_watch(m_inotifyFd, m_outputDirectory.c_str(), Events);
+
+    if (m_sourceWatch < 0 || m_outputWatch < 0)
+    {
+        const int error = errno;
+        close(m_inotifyFd);
+        throw IOException("Unable to watch the shader directories: " + std::string{std::strerror(error)});
+    }
+
+    m_thread = std::thread{&ShaderWatcher::run, this};
+}
+
+vulk::ShaderWatcher::~ShaderWatcher()
+{
+    m_running = false;
+
+    if (m_thread.joinable())
+        m_thread.join();
+
+    close(m_inotifyFd);
+}
+
+void vulk::ShaderWatcher::addListener(const std::string& shaderName, Listener listener)
+{
+    const std::scoped_lock lock{m_listenersMutex};
+    m_listeners.emplace(shaderName, std::move(listener));
+}
+
+void vulk::ShaderWatcher::run()
+{
+    // Aligned as required for inotify_event
+    alignas(inotify_event) std::array<char, 4096> buffer{};
+
+    pollfd pollFd{};
+    pollFd.fd = m_inotifyFd;
+    pollFd.events = POLLIN;
+
+    // Nothing may escape the thread: e.g. a source deleted while being saved or a throwing listener is reported, and
+    // the next changes are still handled
+    const auto guard = [](const char* action, const std::string& name, const auto& function) {
+        try
+        {
+            function();
+        } catch (const std::exception& e)
+        {
+            std::cerr << "Unable to " << action << ' ' << name << ": " << e.what() << '\n';
+        } catch (...)
+        {
+            std::cerr << "Unable to " << action << ' ' << name << ": exception of unknown type\n";
+        }
+    };
+
+    while (m_running)
+    {
+        // Short timeout so the destructor doesn't wait long
+        if (poll(&pollFd, 1, 100) <= 0)
+            continue;
+
+        // A save often triggers several events, each file is handled once per batch
+        std::set<std::string> changedSources{};
+        std::set<std::string> changedOutputs{};
+
+        ssize_t length = 0;
+
+        while ((length = read(m_inotifyFd, buffer.data(), buffer.size())) > 0)
+        {
+            for (ssize_t offset = 0; offset < length;)
+            {
+                inotify_event event{};
+                std::memcpy(&event, buffer.data() + offset, sizeof(event));
+
+                // The name is padded with null bytes, and absent for events on the directory itself
+                const std::string_view name{event.len > 0 ? buffer.data() + offset + sizeof(event) : ""};
+
+                if (event.wd == m_sourceWatch && isShaderSource(name))
+                    changedSources.emplace(name);
+                else if (event.wd == m_outputWatch && name.ends_with(".spv"))
+                    changedOutputs.emplace(name);
+
+                offset += static_cast<ssize_t>(sizeof(event) + event.len);
+            }
+        }
+
+        // Compiling writes the outputs, listeners are notified when those events come in
+        for (const auto& source : changedSources)
+            guard("compile", source, [&] { compile(source); });
+
+        for (const auto& output : changedOutputs)
+            guard("reload", output, [&] { notify(output); });
+    }
+}
+
+void vulk::ShaderWatcher::compile(const std::string& sourceName) const
+{
+    VULK_SCOPED_PROFILER_CATEGORY("ShaderWatcher::compile()", eShaders);
+
+    const std::string sourcePath{m_sourceDirectory + '/' + sourceName};
+    const std::string outputPath{m_outputDirectory + '/' + sourceName + ".spv"};
+
+    try
+    {
+        const SpirvCode code{
+          m_compiler.compileFile(sourcePath.c_str(), ShaderCompiler::getStageFromPath(sourceName))};
+        const std::span<const uint32_t> words{code.getWords()};
+
+        // Replaced rather than rewritten, a listener never reads a partial file
+        const std::string temporaryPath{outputPath + ".tmp"};
+
+        std::ofstream output{temporaryPath, std::ios::binary | std::ios::trunc};
+        output.write(reinterpret_cast<const char*>(words.data()), static_cast<std::streamsize>(words.size_bytes()));
+        output.close();
+
+        if (!output || std::rename(temporaryPath.c_str(), outputPath.c_str()) != 0)
+            throw IOException(outputPath + ": unable to write");
+    } catch (const Exception& e)
+    {
+        // The previous SPIR-V is kept
+        std::cerr << "Failed to compile " << sourcePath << ": " << e.what() << '\n';
+    }
+}
+
+void vulk::ShaderWatcher::notify(const std::string& shaderName)
+{
+    VULK_SCOPED_PROFILER_CATEGORY("ShaderWatcher::notify()", eShaders);
+
+    const std::scoped_lock lock{m_listenersMutex};
+    const auto [first, last] = m_listeners.equal_range(shaderName);
+
+    for (auto it = first; it != last; ++it)
+        it->second(shaderName);
+}
@@ -0,0 +1,89 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/SpecializationConstants.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <string_view>
+
+#include "Vulk/Utils.hpp"
+
+vulk::SpecializationConstants& vulk::SpecializationConstants::set(uint32_t id, bool value)
+{
+    // VkBool32
+    return setBits(id, value ? 1u : 0u);
+}
+
+vulk::SpecializationConstants& vulk::SpecializationConstants::set(uint32_t id, int32_t value)
+{
+    return setBits(id, std::bit_cast<uint32_t>(value));
+}
+
+vulk::SpecializationConstants& vulk::SpecializationConstants::set(uint32_t id, uint32_t value)
+{
+    return setBits(id, value);
+}
+
+vulk::SpecializationConstants& vulk::SpecializationConstants::set(uint32_t id, float value)
+{
+    return setBits(id, std::bit_cast<uint32_t>(value));
+}
+
+std::vector<vk::SpecializationMapEntry> vulk::SpecializationConstants::getMapEntries() const
+{
+    std::vector<vk::SpecializationMapEntry> entries{};
+    entries.reserve(m_ids.size());
+
+    for (size_t i = 0; i < m_ids.size(); ++i)
+    {
+        entries.push_back(vk::SpecializationMapEntry{m_ids[i], static_cast<uint32_t>(i * sizeof(uint32_t)),
+                                                     sizeof(uint32_t)});
+    }
+
+    return entries;
+}
+
+uint64_t vulk::SpecializationConstants::hash(uint64_t seed) const noexcept
+{
+    // The count keeps the ids and values of different sizes apart
+    const uint64_t count = m_ids.size();
+
+    seed = utils::hashFnv1a({reinterpret_cast<const char*>(&count), sizeof(count)}, seed);
+    seed = utils::hashFnv1a({reinterpret_cast<const char*>(m_ids.data()), m_ids.size() * sizeof(uint32_t)}, seed);
+    return utils::hashFnv1a({reinterpret_cast<const char*>(m_values.data()), m_values.size() * sizeof(uint32_t)},
+                            seed);
+}
+
+vulk::SpecializationConstants& vulk::SpecializationConstants::setBits(uint32_t id, uint32_t bits)
+{
+    const auto it = std::lower_bound(m_ids.begin(), m_ids.end(), id);
+    const auto index = it - m_ids.begin();
+
+    if (it != m_ids.end() && *it == id)
+    {
+        m_values[static_cast<size_t>(index)] = bits;
+    } else
+    {
+        m_ids.insert(it, id);
+        m_values.insert(m_values.begin() + index, bits);
+    }
+
+    return *this;
+}
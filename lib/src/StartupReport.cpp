@@ -0,0 +1,117 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/StartupReport.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace {
+using Milliseconds = std::chrono::duration<double, std::milli>;
+}  // namespace
+
+vulk::StartupReport::ScopedPhase::ScopedPhase(StartupReport& report, std::string name)
+    : m_report{report}, m_name{std::move(name)}, m_start{Clock::now()}
+{
+}
+
+vulk::StartupReport::ScopedPhase::~ScopedPhase()
+{
+    m_report.addPhase(std::move(m_name), m_start, Clock::now());
+}
+
+vulk::StartupReport::StartupReport() : m_start{Clock::now()}, m_ownerThread{std::this_thread::get_id()} {}
+
+void vulk::StartupReport::addPhase(std::string name, TimePoint start, TimePoint end)
+{
+    Phase phase{};
+    phase.name = std::move(name);
+    phase.start = std::chrono::duration_cast<Duration>(start - m_start);
+    phase.duration = std::chrono::duration_cast<Duration>(end - start);
+    phase.onWorkerThread = std::this_thread::get_id() != m_ownerThread;
+
+    const std::scoped_lock lock{m_mutex};
+    m_phases.push_back(std::move(phase));
+}
+
+void vulk::StartupReport::finish()
+{
+    const std::scoped_lock lock{m_mutex};
+
+    if (!m_finished)
+    {
+        m_end = Clock::now();
+        m_finished = true;
+    }
+}
+
+std::vector<vulk::StartupReport::Phase> vulk::StartupReport::getPhases() const
+{
+    std::vector<Phase> phases{};
+
+    {
+        const std::scoped_lock lock{m_mutex};
+        phases = m_phases;
+    }
+
+    std::stable_sort(phases.begin(), phases.end(),
+                     [](const Phase& lhs, const Phase& rhs) { return lhs.start < rhs.start; });
+    return phases;
+}
+
+vulk::Duration vulk::StartupReport::getTotal() const
+{
+    const std::scoped_lock lock{m_mutex};
+    return std::chrono::duration_cast<Duration>((m_finished ? m_end : Clock::now()) - m_start);
+}
+
+vulk::Duration vulk::StartupReport::getSequentialTotal() const
+{
+    const std::scoped_lock lock{m_mutex};
+
+    Duration total{};
+    for (const auto& phase : m_phases)
+        total += phase.duration;
+
+    return total;
+}
+
+std::ostream& operator<<(std::ostream& os, const vulk::StartupReport& report)
+{
+    const auto flags = os.flags();
+    const auto precision = os.precision();
+
+    os << std::fixed << std::setprecision(2) << "Startup: " << Milliseconds{report.getTotal()}.count() << " ms ("
+       << Milliseconds{report.getSequentialTotal()}.count() << " ms of work)\n";
+
+    for (const auto& phase : report.getPhases())
+    {
+        os << std::setw(10) << Milliseconds{phase.start}.count() << " ms +" << std::setw(9)
+           << Milliseconds{phase.duration}.count() << " ms  " << phase.name;
+
+        if (phase.onWorkerThread)
+            os << " (worker)";
+
+        os << '\n';
+    }
+
+    os.flags(flags);
+    os.precision(precision);
+    return os;
+}
@@ -0,0 +1,382 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/TelemetryServer.hpp"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <type_traits>
+
+#include "Vulk/AllocationTracker.hpp"
+#include "Vulk/Exceptions.hpp"
+#include "Vulk/FrameManager.hpp"
+#include "Vulk/ScopedProfiler.hpp"
+
+namespace {
+constexpr int PollPeriodMs = 10;
+constexpr uint32_t MaxRequestSize = 1024;
+
+// Published past the pending limit once at most, by a sample of every stream but the zones one
+constexpr size_t PendingCapacity = vulk::TelemetryServer::s_maxPendingBytes +
+                                   3 * sizeof(vulk::TelemetryServer::MessageHeader) +
+                                   sizeof(vulk::TelemetryServer::FrameSample) +
+                                   sizeof(vulk::TelemetryServer::CountersSample) +
+                                   sizeof(vulk::TelemetryServer::MemorySample);
+
+constexpr uint32_t toMask(vulk::TelemetryServer::Stream stream) noexcept
+{
+    return static_cast<uint32_t>(stream);
+}
+
+#if VULK_WITH_SCOPED_PROFILER
+float toMilliseconds(vulk::utils::FrameCallTree::Milliseconds duration) noexcept
+{
+    return static_cast<float>(duration.count());
+}
+#endif
+}  // namespace
+
+vulk::TelemetryServer::TelemetryServer(std::string socketPath) : m_socketPath{std::move(socketPath)}
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    if (m_socketPath.size() >= sizeof(address.sun_path))
+        throw IOException{m_socketPath + ": socket path too long"};
+
+    std::memcpy(address.sun_path, m_socketPath.c_str(), m_socketPath.size() + 1);
+
+    m_listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_listenFd < 0)
+        throw IOException{std::string{"socket: "} + std::strerror(errno)};
+
+    unlink(m_socketPath.c_str());
+
+    if (bind(m_listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(m_listenFd, 4) != 0)
+    {
+        const int error = errno;
+        close(m_listenFd);
+        throw IOException{"Unable to listen on " + m_socketPath + ": " + std::strerror(error)};
+    }
+
+    m_thread = std::thread{&TelemetryServer::run, this};
+}
+
+vulk::TelemetryServer::~TelemetryServer()
+{
+    m_running = false;
+
+    if (m_thread.joinable())
+        m_thread.join();
+
+    disconnect();
+    close(m_listenFd);
+    unlink(m_socketPath.c_str());
+}
+
+void vulk::TelemetryServer::publish(const FrameManager& frameManager)
+{
+    const uint64_t frame = m_frame++;
+    const uint32_t streams = m_streams.load(std::memory_order_relaxed);
+
+    if (streams == 0 || frame % m_period.load(std::memory_order_relaxed) != 0)
+        return;
+
+    VULK_SCOPED_PROFILER_CATEGORY("TelemetryServer::publish()", eFrame);
+
+#if VULK_WITH_SCOPED_PROFILER
+    // Locks the profiler, not to be done under m_pendingMutex
+    std::vector<utils::FrameCallTree::Node> zones{};
+    if (streams & toMask(Stream::eZones))
+    {
+        utils::Profiler& profiler = utils::Profiler::getInstance();
+
+        // Only drained in the background while tracing
+        if (!profiler.isTracing())
+            profiler.flush();
+
+        zones = profiler.getFrameProfile();
+    }
+#endif
+
+    const std::scoped_lock lock{m_pendingMutex};
+
+    if (m_pending.size() >= s_maxPendingBytes)
+    {
+        ++m_droppedSamples;
+        return;
+    }
+
+    if (streams & toMask(Stream::eFrame))
+    {
+        const FrameStatistics::Summary summary = frameManager.getStatistics().getSummary();
+
+        FrameSample sample{};
+        sample.frame = frame;
+        sample.framerate = frameManager.getFPS();
+        sample.overBudget = static_cast<uint32_t>(summary.overBudget);
+        sample.frameCount = static_cast<uint32_t>(summary.frameCount);
+        sample.deltaTime = frameManager.getDeltaTime();
+        sample.mean = summary.mean.count();
+        sample.p50 = summary.p50.count();
+        sample.p95 = summary.p95.count();
+        sample.p99 = summary.p99.count();
+        sample.max = summary.max.count();
+        sample.jitter = summary.jitter.count();
+
+        appendMessage(MessageType::eFrame, sample);
+    }
+
+    if (streams & toMask(Stream::eCounters))
+    {
+        const RenderCounters& counters = frameManager.getRenderCounters();
+
+        CountersSample sample{};
+        sample.frame = frame;
+
+        for (size_t i = 0; i < RenderCounters::s_count; ++i)
+            sample.values[i] = counters[static_cast<RenderCounter>(i)];
+
+        appendMessage(MessageType::eCounters, sample);
+    }
+
+    if (streams & toMask(Stream::eMemory))
+    {
+        const AllocationTracker::Counts counts = AllocationTracker::getInstance().getLastFrameCounts();
+
+        MemorySample sample{};
+        sample.frame = frame;
+        sample.allocations = counts.allocations;
+        sample.deallocations = counts.deallocations;
+        sample.bytes = counts.bytes;
+
+        appendMessage(MessageType::eMemory, sample);
+    }
+
+#if VULK_WITH_SCOPED_PROFILER
+    if (streams & toMask(Stream::eZones))
+    {
+        size_t namesSize = 0;
+        for (const auto& zone : zones)
+            namesSize += std::strlen(zone.name);
+
+        ZonesSample sample{};
+        sample.frame = frame;
+        sample.count = static_cast<uint32_t>(zones.size());
+
+        appendMessage(MessageType::eZones, sample, zones.size() * sizeof(ZoneSample) + namesSize);
+
+        for (const auto& zone : zones)
+        {
+            const bool isRoot = zone.parent == utils::FrameCallTree::Node::s_noParent;
+
+            ZoneSample zoneSample{};
+            zoneSample.parent = isRoot ? ZoneSample::s_noParent : static_cast<uint32_t>(zone.parent);
+            zoneSample.depth = zone.depth;
+            zoneSample.calls = static_cast<float>(zone.calls);
+            zoneSample.total = toMilliseconds(zone.total);
+            zoneSample.self = toMilliseconds(zone.self);
+            zoneSample.nameLength = static_cast<uint32_t>(std::strlen(zone.name));
+
+            append(&zoneSample, sizeof(zoneSample));
+            append(zone.name, zoneSample.nameLength);
+        }
+    }
+#endif
+}
+
+uint32_t vulk::TelemetryServer::getAvailableStreams() noexcept
+{
+    uint32_t streams = toMask(Stream::eFrame) | toMask(Stream::eCounters);
+
+    if constexpr (AllocationTracker::s_enabled)
+        streams |= toMask(Stream::eMemory);
+
+#if VULK_WITH_SCOPED_PROFILER
+    streams |= toMask(Stream::eZones);
+#endif
+
+    return streams;
+}
+
+void vulk::TelemetryServer::run()
+{
+    while (m_running)
+    {
+        pollfd pollFd{};
+        pollFd.fd = m_clientFd >= 0 ? m_clientFd : m_listenFd;
+        pollFd.events = POLLIN;
+
+        if (m_clientFd >= 0 && m_sentSize < m_sending.size())
+            pollFd.events |= POLLOUT;
+
+        // Short timeout, samples are sent at that pace and the destructor doesn't wait long
+        if (poll(&pollFd, 1, PollPeriodMs) > 0)
+        {
+            if (m_clientFd < 0)
+                acceptClient();
+            else if ((pollFd.revents & (POLLIN | POLLHUP | POLLERR)) && !receive())
+                disconnect();
+        }
+
+        if (m_clientFd < 0)
+            continue;
+
+        // Swapped once everything was sent, both buffers keep their capacity
+        if (m_sentSize == m_sending.size())
+        {
+            m_sending.clear();
+            m_sentSize = 0;
+
+            const std::scoped_lock lock{m_pendingMutex};
+            m_sending.swap(m_pending);
+        }
+
+        if (!sendPending())
+            disconnect();
+    }
+}
+
+void vulk::TelemetryServer::acceptClient()
+{
+    // Non-blocking, a client that stops reading must not keep the thread from stopping
+    m_clientFd = accept4(m_listenFd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+    if (m_clientFd < 0)
+        return;
+
+    Hello hello{};
+    hello.processId = static_cast<uint32_t>(getpid());
+    hello.availableStreams = getAvailableStreams();
+
+    // Reserved up front so that publishing doesn't allocate, even when the client falls behind
+    m_sending.reserve(PendingCapacity);
+
+    const std::scoped_lock lock{m_pendingMutex};
+    m_pending.clear();
+    m_pending.reserve(PendingCapacity);
+    appendMessage(MessageType::eHello, hello);
+
+    m_connected = true;
+}
+
+void vulk::TelemetryServer::disconnect() noexcept
+{
+    if (m_clientFd < 0)
+        return;
+
+    m_streams = 0;
+    m_connected = false;
+
+    close(m_clientFd);
+    m_clientFd = -1;
+    m_received.clear();
+    m_sending.clear();
+    m_sentSize = 0;
+
+    const std::scoped_lock lock{m_pendingMutex};
+    m_pending.clear();
+}
+
+bool vulk::TelemetryServer::receive()
+{
+    std::array<char, 256> buffer{};
+    const ssize_t length = recv(m_clientFd, buffer.data(), buffer.size(), 0);
+
+    if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        return true;
+    if (length <= 0)
+        return false;
+
+    m_received.insert(m_received.end(), buffer.begin(), buffer.begin() + length);
+
+    size_t offset = 0;
+
+    while (m_received.size() - offset >= sizeof(MessageHeader))
+    {
+        MessageHeader header{};
+        std::memcpy(&header, m_received.data() + offset, sizeof(header));
+
+        if (header.size > MaxRequestSize)
+            return false;
+        if (m_received.size() - offset - sizeof(header) < header.size)
+            break;
+
+        // Unknown messages are skipped, for older servers to ignore what newer clients send
+        if (header.type == MessageType::eSubscribe && header.size >= sizeof(Subscription))
+        {
+            Subscription subscription{};
+            std::memcpy(&subscription, m_received.data() + offset + sizeof(header), sizeof(subscription));
+
+            m_period = std::max(subscription.period, 1u);
+            m_streams = subscription.streams & getAvailableStreams();
+        }
+
+        offset += sizeof(header) + header.size;
+    }
+
+    m_received.erase(m_received.begin(), m_received.begin() + static_cast<ptrdiff_t>(offset));
+    return true;
+}
+
+bool vulk::TelemetryServer::sendPending() noexcept
+{
+    while (m_sentSize < m_sending.size())
+    {
+        // No SIGPIPE when the client is gone, only an error
+        const ssize_t sent = send(m_clientFd, m_sending.data() + m_sentSize, m_sending.size() - m_sentSize,
+                                  MSG_NOSIGNAL);
+
+        if (sent < 0 && errno == EINTR)
+            continue;
+
+        // The rest is sent once the client reads, new samples are dropped meanwhile if it takes too long
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return true;
+        if (sent <= 0)
+            return false;
+
+        m_sentSize += static_cast<size_t>(sent);
+    }
+
+    return true;
+}
+
+template<typename Payload>
+void vulk::TelemetryServer::appendMessage(MessageType type, const Payload& payload, size_t extraSize)
+{
+    static_assert(std::is_trivially_copyable_v<Payload>);
+
+    const MessageHeader header{type, static_cast<uint32_t>(sizeof(payload) + extraSize)};
+
+    append(&header, sizeof(header));
+    append(&payload, sizeof(payload));
+}
+
+void vulk::TelemetryServer::append(const void* data, size_t size)
+{
+    const auto* bytes = static_cast<const char*>(data);
+    m_pending.insert(m_pending.end(), bytes, bytes + size);
+}
@@ -0,0 +1,128 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/ThreadPool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <utility>
+
+vulk::ThreadPool::ThreadPool(size_t threadCount)
+{
+    assert(threadCount > 0);
+
+    m_threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i)
+        m_threads.emplace_back(&ThreadPool::run, this);
+}
+
+vulk::ThreadPool::~ThreadPool()
+{
+    {
+        const std::scoped_lock lock{m_mutex};
+        m_stopping = true;
+    }
+
+    m_jobAvailable.notify_all();
+
+    for (auto& thread : m_threads)
+        thread.join();
+}
+
+void vulk::ThreadPool::submit(Job job)
+{
+    {
+        const std::scoped_lock lock{m_mutex};
+        m_jobs.push_back(std::move(job));
+    }
+
+    m_jobAvailable.notify_one();
+}
+
+std::future<void> vulk::ThreadPool::async(Job job)
+{
+    // Jobs have to be copyable, promises aren't
+    auto promise = std::make_shared<std::promise<void>>();
+    std::future<void> future = promise->get_future();
+
+    submit([promise, job = std::move(job)] {
+        try
+        {
+            job();
+            promise->set_value();
+        } catch (...)
+        {
+            promise->set_exception(std::current_exception());
+        }
+    });
+
+    return future;
+}
+
+void vulk::ThreadPool::waitIdle()
+{
+    std::unique_lock lock{m_mutex};
+    m_idle.wait(lock, [this] { return m_jobs.empty() && m_runningJobs == 0; });
+}
+
+size_t vulk::ThreadPool::getDefaultThreadCount() noexcept
+{
+    // hardware_concurrency() may return 0 when it can't tell
+    const size_t hardwareThreads = std::thread::hardware_concurrency();
+    return std::max<size_t>(hardwareThreads, 2) - 1;
+}
+
+void vulk::ThreadPool::run()
+{
+    std::unique_lock lock{m_mutex};
+
+    while (true)
+    {
+        m_jobAvailable.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+
+        if (m_jobs.empty())
+            return;  // Stopping, and everything queued ran
+
+        Job job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        ++m_runningJobs;
+
+        lock.unlock();
+
+        try
+        {
+            job();
+        } catch (const std::exception& e)
+        {
+            std::cerr << "Uncaught exception in a worker thread: " << e.what() << '\n';
+        } catch (...)
+        {
+            std::cerr << "Uncaught exception of unknown type in a worker thread\n";
+        }
+
+        lock.lock();
+        --m_runningJobs;
+
+        if (m_jobs.empty() && m_runningJobs == 0)
+            m_idle.notify_all();
+    }
+}
@@ -0,0 +1,235 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/TransformHierarchy.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include "Vulk/ScopedProfiler.hpp"
+
+namespace {
+constexpr uint32_t InvalidIndex = ~0u;
+
+template<typename T>
+void insertAt(std::vector<T>& vector, uint32_t index, const T& value)
+{
+    vector.insert(vector.begin() + static_cast<std::ptrdiff_t>(index), value);
+}
+
+template<typename T>
+void eraseRange(std::vector<T>& vector, uint32_t first, uint32_t last)
+{
+    vector.erase(vector.begin() + static_cast<std::ptrdiff_t>(first),
+                 vector.begin() + static_cast<std::ptrdiff_t>(last));
+}
+}  // namespace
+
+vulk::TransformHierarchy::NodeHandle vulk::TransformHierarchy::createNode(NodeHandle parent,
+                                                                          const glm::mat4& localTransform)
+{
+    uint32_t parentIndex = InvalidIndex;
+    uint32_t index = getNodeCount();
+
+    if (parent != INVALID_NODE)
+    {
+        parentIndex = getIndex(parent);
+        index = m_subtreeEnds[parentIndex];
+
+        // The parent and its ancestors grow by one
+        for (uint32_t ancestor = parentIndex; ancestor != InvalidIndex; ancestor = m_parents[ancestor])
+            ++m_subtreeEnds[ancestor];
+    }
+
+    // Everything after the insertion point moves by one
+    for (uint32_t i = index; i < getNodeCount(); ++i)
+    {
+        ++m_subtreeEnds[i];
+        ++m_indices[m_handles[i]];
+
+        if (m_parents[i] != InvalidIndex && m_parents[i] >= index)
+            ++m_parents[i];
+    }
+
+    NodeHandle handle{};
+
+    if (m_freeHandles.empty())
+    {
+        handle = static_cast<NodeHandle>(m_indices.size());
+        m_indices.push_back(index);
+    } else
+    {
+        handle = m_freeHandles.back();
+        m_freeHandles.pop_back();
+        m_indices[handle] = index;
+    }
+
+    insertAt(m_localTransforms, index, localTransform);
+    insertAt(m_worldTransforms, index, localTransform);
+    insertAt(m_parents, index, parentIndex);
+    insertAt(m_subtreeEnds, index, index + 1);
+    insertAt(m_handles, index, handle);
+    insertAt(m_dirtyFlags, index, uint8_t{0});
+
+    markMovedFrom(index);
+    markDirty(index);
+
+    return handle;
+}
+
+void vulk::TransformHierarchy::destroyNode(NodeHandle node)
+{
+    const uint32_t first = getIndex(node);
+    const uint32_t last = m_subtreeEnds[first];
+    const uint32_t count = last - first;
+
+    for (uint32_t ancestor = m_parents[first]; ancestor != InvalidIndex; ancestor = m_parents[ancestor])
+        m_subtreeEnds[ancestor] -= count;
+
+    for (uint32_t i = first; i < last; ++i)
+    {
+        m_indices[m_handles[i]] = InvalidIndex;
+        m_freeHandles.push_back(m_handles[i]);
+    }
+
+    for (uint32_t i = last; i < getNodeCount(); ++i)
+    {
+        m_subtreeEnds[i] -= count;
+        m_indices[m_handles[i]] -= count;
+
+        if (m_parents[i] != InvalidIndex && m_parents[i] >= last)
+            m_parents[i] -= count;
+    }
+
+    eraseRange(m_localTransforms, first, last);
+    eraseRange(m_worldTransforms, first, last);
+    eraseRange(m_parents, first, last);
+    eraseRange(m_subtreeEnds, first, last);
+    eraseRange(m_handles, first, last);
+    eraseRange(m_dirtyFlags, first, last);
+
+    // Dirty nodes of the destroyed subtree are skipped by update()
+    markMovedFrom(first);
+}
+
+void vulk::TransformHierarchy::setLocalTransform(NodeHandle node, const glm::mat4& localTransform)
+{
+    const uint32_t index = getIndex(node);
+
+    m_localTransforms[index] = localTransform;
+    markDirty(index);
+}
+
+const glm::mat4& vulk::TransformHierarchy::getLocalTransform(NodeHandle node) const
+{
+    return m_localTransforms[getIndex(node)];
+}
+
+const glm::mat4& vulk::TransformHierarchy::getWorldTransform(NodeHandle node) const
+{
+    return m_worldTransforms[getIndex(node)];
+}
+
+uint32_t vulk::TransformHierarchy::getIndex(NodeHandle node) const
+{
+    assert(node < m_indices.size() && m_indices[node] != InvalidIndex);
+    return m_indices[node];
+}
+
+std::span<const vulk::TransformHierarchy::Range> vulk::TransformHierarchy::update()
+{
+    m_changedRanges.clear();
+
+    if (m_dirtyNodes.empty() && m_movedFrom == getNodeCount())
+        return m_changedRanges;
+
+    VULK_SCOPED_PROFILER_CATEGORY("TransformHierarchy::update()", eFrame);
+
+    // Subtree roots in order, so nested dirty nodes are skipped once their ancestor's subtree is done
+    m_dirtyIndices.clear();
+
+    for (const NodeHandle node : m_dirtyNodes)
+    {
+        if (node < m_indices.size() && m_indices[node] != InvalidIndex && m_dirtyFlags[m_indices[node]])
+        {
+            m_dirtyFlags[m_indices[node]] = 0;
+            m_dirtyIndices.push_back(m_indices[node]);
+        }
+    }
+
+    m_dirtyNodes.clear();
+    std::sort(m_dirtyIndices.begin(), m_dirtyIndices.end());
+
+    const auto addChangedRange = [this](uint32_t first, uint32_t last) {
+        if (!m_changedRanges.empty() && m_changedRanges.back().first + m_changedRanges.back().count >= first)
+        {
+            Range& previous = m_changedRanges.back();
+            previous.count = std::max(previous.first + previous.count, last) - previous.first;
+        } else
+        {
+            m_changedRanges.push_back(Range{first, last - first});
+        }
+    };
+
+    uint32_t processedEnd = 0;
+
+    for (const uint32_t root : m_dirtyIndices)
+    {
+        if (root < processedEnd)
+            continue;
+
+        processedEnd = m_subtreeEnds[root];
+
+        // Parents come first, the root's parent is outside the subtree and already up to date
+        for (uint32_t i = root; i < processedEnd; ++i)
+        {
+            const uint32_t parent = m_parents[i];
+            m_worldTransforms[i] = parent == InvalidIndex ? m_localTransforms[i]
+                                                          : m_worldTransforms[parent] * m_localTransforms[i];
+        }
+
+        addChangedRange(root, processedEnd);
+    }
+
+    if (m_movedFrom < getNodeCount())
+    {
+        while (!m_changedRanges.empty() && m_changedRanges.back().first >= m_movedFrom)
+            m_changedRanges.pop_back();
+
+        addChangedRange(m_movedFrom, getNodeCount());
+    }
+
+    m_movedFrom = getNodeCount();
+
+    return m_changedRanges;
+}
+
+void vulk::TransformHierarchy::markDirty(uint32_t index)
+{
+    if (!m_dirtyFlags[index])
+    {
+        m_dirtyFlags[index] = 1;
+        m_dirtyNodes.push_back(m_handles[index]);
+    }
+}
+
+void vulk::TransformHierarchy::markMovedFrom(uint32_t index) noexcept
+{
+    m_movedFrom = std::min(m_movedFrom, index);
+}
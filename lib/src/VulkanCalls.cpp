@@ -0,0 +1,173 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "Vulk/VulkanCalls.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+#include "Vulk/ScopedProfiler.hpp"
+#include "Vulk/ThreadAccumulators.hpp"
+
+namespace {
+struct Counter
+{
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> nanoseconds{0};
+};
+
+using Accumulator = std::array<Counter, vulk::VulkanCallStats::s_count>;
+using Accumulators = vulk::ThreadAccumulators<Accumulator>;
+
+using vulk::utils::ProfilerCategory;
+using vulk::utils::ZoneDescriptor;
+
+// Also the names of the entry points
+constexpr std::array<ZoneDescriptor, vulk::VulkanCallStats::s_count> Zones{
+  ZoneDescriptor{"vkAllocateMemory", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkFreeMemory", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkMapMemory", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkUnmapMemory", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkBindBufferMemory", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkCreateBuffer", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkDestroyBuffer", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkCreateImageView", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkCreateFramebuffer", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkCreateRenderPass", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkCreateShaderModule", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkCreatePipelineLayout", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkCreateDescriptorSetLayout", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkCreateGraphicsPipelines", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkCreateComputePipelines", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkDestroyPipeline", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkCreateDescriptorPool", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkAllocateDescriptorSets", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkUpdateDescriptorSets", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkAllocateCommandBuffers", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkFreeCommandBuffers", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkCreateSwapchainKHR", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkAcquireNextImageKHR", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkWaitForFences", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkResetFences", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkGetFenceStatus", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkGetQueryPoolResults", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkDeviceWaitIdle", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkQueueSubmit", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkQueuePresentKHR", ProfilerCategory::eVulkan},
+  ZoneDescriptor{"vkQueueWaitIdle", ProfilerCategory::eVulkan}};
+}  // namespace
+
+vulk::VulkanCallStats& vulk::VulkanCallStats::operator+=(const VulkanCallStats& other) noexcept
+{
+    for (size_t i = 0; i < s_count; ++i)
+    {
+        m_entries[i].count += other.m_entries[i].count;
+        m_entries[i].nanoseconds += other.m_entries[i].nanoseconds;
+    }
+
+    return *this;
+}
+
+vulk::VulkanCallStats::Entry vulk::VulkanCallStats::getTotal() const noexcept
+{
+    Entry total{};
+
+    for (const Entry& entry : m_entries)
+    {
+        total.count += entry.count;
+        total.nanoseconds += entry.nanoseconds;
+    }
+
+    return total;
+}
+
+const char* vulk::VulkanCallStats::getName(VulkanCall call) noexcept
+{
+    const auto index = static_cast<size_t>(call);
+    return index < s_count ? Zones[index].name : "unknown";
+}
+
+void vulk::accounting::add(VulkanCall call, uint64_t nanoseconds) noexcept
+{
+    // Only the owning thread writes, the atomics are for fold() to read them
+    Counter& counter = Accumulators::getLocal()[static_cast<size_t>(call)];
+    counter.count.fetch_add(1, std::memory_order_relaxed);
+    counter.nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+}
+
+vulk::VulkanCallStats vulk::accounting::fold()
+{
+    VulkanCallStats stats{};
+
+    Accumulators::forEach([&stats](Accumulator& accumulator) {
+        for (size_t i = 0; i < VulkanCallStats::s_count; ++i)
+        {
+            VulkanCallStats::Entry& entry = stats[static_cast<VulkanCall>(i)];
+            entry.count += accumulator[i].count.exchange(0, std::memory_order_relaxed);
+            entry.nanoseconds += accumulator[i].nanoseconds.exchange(0, std::memory_order_relaxed);
+        }
+    });
+
+    return stats;
+}
+
+vulk::VulkanCallScope::VulkanCallScope(VulkanCall call) noexcept : m_call{call}, m_begin{utils::Profiler::now()}
+{
+}
+
+vulk::VulkanCallScope::~VulkanCallScope()
+{
+    const int64_t end = utils::Profiler::now();
+    const utils::Profiler::Clock::duration elapsed{end - m_begin};
+
+    accounting::add(m_call,
+                    static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+
+#if VULK_WITH_SCOPED_PROFILER
+    if (utils::Profiler::isCategoryEnabled(ProfilerCategory::eVulkan))
+        utils::Profiler::getInstance().record(Zones[static_cast<size_t>(m_call)], m_begin, end);
+#endif
+}
+
+std::ostream& operator<<(std::ostream& os, const vulk::VulkanCallStats& stats)
+{
+    std::array<vulk::VulkanCall, vulk::VulkanCallStats::s_count> calls{};
+    for (size_t i = 0; i < calls.size(); ++i)
+        calls[i] = static_cast<vulk::VulkanCall>(i);
+
+    std::stable_sort(calls.begin(), calls.end(), [&stats](vulk::VulkanCall lhs, vulk::VulkanCall rhs) {
+        return stats[lhs].nanoseconds > stats[rhs].nanoseconds;
+    });
+
+    bool first = true;
+    for (const vulk::VulkanCall call : calls)
+    {
+        const vulk::VulkanCallStats::Entry& entry = stats[call];
+
+        if (entry.count == 0)
+            continue;
+
+        os << (first ? "" : ", ") << vulk::VulkanCallStats::getName(call) << ": " << entry.count << " in "
+           << static_cast<double>(entry.nanoseconds) / 1000.0 << " us";
+        first = false;
+    }
+
+    return os;
+}
@@ -23,9 +23,11 @@
 
 #include <stdexcept>
 
+#include "Vulk/AllocationTracker.hpp"
 #include "Vulk/Contexts/ContextGLFW.hpp"
 #include "Vulk/Contexts/ContextVulkan.hpp"
 #include "Vulk/Exceptions.hpp"
+#include "Vulk/ScopedProfiler.hpp"
 
 static void onKeyPressed(GLFWwindow* window, int key, int scancode, int action, int mods);
 static void onButtonPressed(GLFWwindow* window, int button, int action, int mods);
@@ -76,14 +78,38 @@ vulk::Window& vulk::Window::operator=(Window&& rhs) noexcept
 
 void vulk::Window::display()
 {
-    ContextVulkan::getInstance().draw();
+    {
+        const AllocationTracker::SteadyStateScope steadyState{};
 
-    m_frameManager.update();
+        ContextVulkan& context = ContextVulkan::getInstance();
+        context.draw();
+
+        // The input polled since the previous frame is consumed by this one
+        InputLatency& inputLatency = m_frameManager.getInputLatency();
+        inputLatency.onFrameSubmitted(context.getLastPresentId());
+
+        for (const PresentTiming& timing : context.getPresentTimings())
+            inputLatency.onFramePresented(timing);
+
+        m_frameManager.setWorkload(context.getLastFrameWorkload());
+        m_frameManager.update();
+    }
+
+    AllocationTracker::getInstance().markFrame();
+    VULK_PROFILER_FRAME();
 }
 
 void vulk::Window::pollEvents()
 {
     glfwPollEvents();
+
+    InputLatency& inputLatency = m_frameManager.getInputLatency();
+
+    if (const auto arrival = m_keyboard->takeFirstEventTime())
+        inputLatency.onInput(*arrival);
+
+    if (const auto arrival = m_mouse->takeFirstEventTime())
+        inputLatency.onInput(*arrival);
 }
 
 void vulk::Window::close() noexcept
@@ -102,14 +128,19 @@ void vulk::Window::setTitle(const char* newTitle) noexcept
         glfwSetWindowTitle(m_windowHandle, newTitle);
 }
 
+// GLFW doesn't timestamp events, they are as late as their dispatch by glfwPollEvents()
 static void onKeyPressed(GLFWwindow* window, int, int scancode, int action, int)
 {
+    const vulk::TimePoint arrival = vulk::Clock::now();
+
     auto keyboard = vulk::Keyboard::getKeyboard(window);
-    keyboard->onKeyPressed(scancode, action);
+    keyboard->onKeyPressed(scancode, action, arrival);
 }
 
 static void onButtonPressed(GLFWwindow* window, int button, int action, int)
 {
+    const vulk::TimePoint arrival = vulk::Clock::now();
+
     auto mouse = vulk::Mouse::getMouse(window);
-    mouse->onButtonPressed(button, action);
+    mouse->onButtonPressed(button, action, arrival);
 }
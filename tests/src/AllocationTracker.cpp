@@ -0,0 +1,159 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Vulk/AllocationTracker.hpp>
+#include <Vulk/FrameManager.hpp>
+#include <Vulk/TransformHierarchy.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <new>
+#include <thread>
+
+namespace {
+void allocateAndFree(size_t size)
+{
+    // Explicit calls, new expressions may be optimized away
+    void* pointer = ::operator new(size);
+    ::operator delete(pointer);
+}
+}  // namespace
+
+TEST(AllocationTrackerTests, CountsPerFrameAndThread)
+{
+    if (!vulk::AllocationTracker::s_enabled)
+        GTEST_SKIP() << "Built without VULK_TRACK_ALLOCATIONS";
+
+    auto& tracker = vulk::AllocationTracker::getInstance();
+    tracker.markFrame();
+
+    uint32_t threadId{0};
+    std::thread thread{[&tracker, &threadId] {
+        threadId = tracker.getCurrentThreadId();
+
+        for (int i = 0; i < 10; ++i)
+            allocateAndFree(100);
+    }};
+    thread.join();
+
+    const auto totalBefore = tracker.getTotalCounts();
+    tracker.markFrame();
+
+    const auto threadCounts = tracker.getLastFrameThreadCounts();
+    const auto it = std::find_if(threadCounts.begin(), threadCounts.end(),
+                                 [threadId](const auto& counts) { return counts.threadId == threadId; });
+
+    ASSERT_NE(it, threadCounts.end());
+    EXPECT_EQ(it->counts.allocations, 10u);
+    EXPECT_GE(it->counts.deallocations, 10u);  // The thread also frees its std::thread state
+    EXPECT_EQ(it->counts.bytes, 1000u);
+
+    EXPECT_GE(tracker.getLastFrameCounts().allocations, 10u);
+    EXPECT_EQ(tracker.getTotalCounts().allocations - totalBefore.allocations,
+              tracker.getLastFrameCounts().allocations);
+}
+
+TEST(AllocationTrackerTests, CapturesLargeAllocations)
+{
+    if (!vulk::AllocationTracker::s_enabled)
+        GTEST_SKIP() << "Built without VULK_TRACK_ALLOCATIONS";
+
+    auto& tracker = vulk::AllocationTracker::getInstance();
+    tracker.setOutlierSize(1u << 20);
+    tracker.clearOutliers();
+
+    allocateAndFree(1u << 21);
+
+    const auto outliers = tracker.getOutliers();
+    tracker.setOutlierSize(vulk::AllocationTracker::s_defaultOutlierSize);
+
+    ASSERT_EQ(outliers.size(), 1u);
+    EXPECT_EQ(outliers[0].size, 1u << 21);
+    EXPECT_FALSE(outliers[0].steadyStateViolation);
+}
+
+TEST(AllocationTrackerTests, SteadyStateCheck)
+{
+    if (!vulk::AllocationTracker::s_enabled)
+        GTEST_SKIP() << "Built without VULK_TRACK_ALLOCATIONS";
+
+    auto& tracker = vulk::AllocationTracker::getInstance();
+    tracker.clearOutliers();
+    tracker.enableSteadyStateCheck(1, false);
+
+    const uint64_t violations = tracker.getSteadyStateViolationCount();
+
+    {
+        const vulk::AllocationTracker::SteadyStateScope scope{};
+        allocateAndFree(16);  // Warming up
+    }
+
+    tracker.markFrame();
+    allocateAndFree(16);  // Outside of the scope
+    EXPECT_EQ(tracker.getSteadyStateViolationCount(), violations);
+
+    {
+        const vulk::AllocationTracker::SteadyStateScope scope{};
+        allocateAndFree(16);
+    }
+
+    tracker.disableSteadyStateCheck();
+
+    EXPECT_EQ(tracker.getSteadyStateViolationCount(), violations + 1);
+
+    const auto outliers = tracker.getOutliers();
+    ASSERT_EQ(outliers.size(), 1u);
+    EXPECT_TRUE(outliers[0].steadyStateViolation);
+    EXPECT_EQ(outliers[0].size, 16u);
+}
+
+TEST(AllocationTrackerTests, FrameLoopIsSteady)
+{
+    if (!vulk::AllocationTracker::s_enabled)
+        GTEST_SKIP() << "Built without VULK_TRACK_ALLOCATIONS";
+
+    // What Window::display() does on the CPU each frame, short of drawing
+    vulk::FrameManager frameManager{};
+    vulk::TransformHierarchy hierarchy{};
+    const auto root = hierarchy.createNode();
+    const auto child = hierarchy.createNode(root);
+
+    auto& tracker = vulk::AllocationTracker::getInstance();
+    tracker.clearOutliers();
+    tracker.enableSteadyStateCheck(10, false);
+
+    const uint64_t violations = tracker.getSteadyStateViolationCount();
+
+    for (int frame = 0; frame < 100; ++frame)
+    {
+        {
+            const vulk::AllocationTracker::SteadyStateScope scope{};
+
+            hierarchy.setLocalTransform(frame % 2 ? root : child, glm::mat4{static_cast<float>(frame)});
+            static_cast<void>(hierarchy.update());
+            frameManager.update();
+        }
+
+        tracker.markFrame();
+    }
+
+    tracker.disableSteadyStateCheck();
+
+    EXPECT_EQ(tracker.getSteadyStateViolationCount(), violations);
+}
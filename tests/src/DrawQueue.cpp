@@ -0,0 +1,142 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Vulk/DrawQueue.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+struct RecordedDraw
+{
+    uint32_t vertexCount{};
+    uint32_t instanceCount{};
+    uint32_t firstVertex{};
+    uint32_t firstInstance{};
+
+    bool operator==(const RecordedDraw&) const = default;
+};
+
+static std::vector<RecordedDraw> s_recordedDraws{};
+
+// Replaces the loader's entry point so record() runs without a device
+extern "C" VKAPI_ATTR void VKAPI_CALL vkCmdDraw(VkCommandBuffer, uint32_t vertexCount, uint32_t instanceCount,
+                                                uint32_t firstVertex, uint32_t firstInstance)
+{
+    s_recordedDraws.push_back({vertexCount, instanceCount, firstVertex, firstInstance});
+}
+
+TEST(DrawQueueTests, MakeKey)
+{
+    EXPECT_EQ(vulk::DrawQueue::makeKey(0, 0, 0, 0), 0u);
+    EXPECT_EQ(vulk::DrawQueue::makeKey(1, 0, 0, 0), 1ull << 56);
+    EXPECT_EQ(vulk::DrawQueue::makeKey(0, 1, 0, 0), 1ull << 44);
+    EXPECT_EQ(vulk::DrawQueue::makeKey(0, 0, 1, 0), 1ull << 24);
+    EXPECT_EQ(vulk::DrawQueue::makeKey(0, 0, 0, 1), 1u);
+    EXPECT_EQ(vulk::DrawQueue::makeKey(0xff, 0xfff, 0xfffff, 0xffffff), ~0ull);
+
+    // Fields don't overflow into each other
+    EXPECT_EQ(vulk::DrawQueue::makeKey(0, 0, 0, 1u << 24), 0u);
+    EXPECT_LT(vulk::DrawQueue::makeKey(0, 0xfff, 0xfffff, 0xffffff), vulk::DrawQueue::makeKey(1, 0, 0, 0));
+}
+
+TEST(DrawQueueTests, QuantizeDepth)
+{
+    EXPECT_EQ(vulk::DrawQueue::quantizeDepth(0.f), 0u);
+    EXPECT_EQ(vulk::DrawQueue::quantizeDepth(1.f), 0xffffffu);
+    EXPECT_EQ(vulk::DrawQueue::quantizeDepth(2.f), 0xffffffu);
+    EXPECT_EQ(vulk::DrawQueue::quantizeDepth(0.f, true), 0xffffffu);
+    EXPECT_LT(vulk::DrawQueue::quantizeDepth(0.25f), vulk::DrawQueue::quantizeDepth(0.5f));
+    EXPECT_GT(vulk::DrawQueue::quantizeDepth(0.25f, true), vulk::DrawQueue::quantizeDepth(0.5f, true));
+}
+
+TEST(DrawQueueTests, Sort)
+{
+    std::mt19937_64 random{42};
+    std::uniform_int_distribution<uint32_t> layers{0, 3};
+    std::uniform_int_distribution<uint32_t> ids{0, 15};
+    std::uniform_int_distribution<uint32_t> depths{0, 0xffffff};
+
+    vulk::DrawQueue queue{};
+    std::vector<uint64_t> keys{};
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        keys.push_back(vulk::DrawQueue::makeKey(layers(random), ids(random), ids(random), depths(random)));
+        queue.submit(keys.back(), {});
+    }
+
+    queue.sort();
+
+    const auto entries = queue.getSortedEntries();
+
+    ASSERT_EQ(entries.size(), keys.size());
+    EXPECT_TRUE(std::is_sorted(entries.begin(), entries.end(),
+                               [](const auto& lhs, const auto& rhs) { return lhs.key < rhs.key; }));
+
+    for (const auto& entry : entries)
+        EXPECT_EQ(entry.key, keys[entry.drawIndex]);
+}
+
+TEST(DrawQueueTests, SortIsStable)
+{
+    vulk::DrawQueue queue{};
+
+    for (uint32_t i = 0; i < 100; ++i)
+        queue.submit(vulk::DrawQueue::makeKey(0, i % 2, 0, 0), {});
+
+    queue.sort();
+
+    const auto entries = queue.getSortedEntries();
+
+    for (size_t i = 1; i < entries.size(); ++i)
+    {
+        if (entries[i - 1].key == entries[i].key)
+        {
+            EXPECT_LT(entries[i - 1].drawIndex, entries[i].drawIndex);
+        }
+    }
+
+    queue.clear();
+    EXPECT_TRUE(queue.getSortedEntries().empty());
+}
+
+TEST(DrawQueueTests, RecordNonIndexedDraw)
+{
+    vulk::DrawQueue::Draw draw{};
+    draw.indexCount = 6;
+    draw.instanceCount = 2;
+    draw.firstIndex = 3;
+    draw.vertexOffset = 5;
+    draw.firstInstance = 1;
+
+    vulk::DrawQueue queue{};
+    queue.submit(0, draw);
+
+    s_recordedDraws.clear();
+    queue.record(vk::CommandBuffer{});
+
+    // Without an index buffer, the index count and first index are the vertex ones
+    ASSERT_EQ(s_recordedDraws.size(), 1u);
+    EXPECT_EQ(s_recordedDraws[0], (RecordedDraw{6, 2, 3, 1}));
+    EXPECT_EQ(queue.getStatistics().draws, 1u);
+    EXPECT_EQ(queue.getStatistics().triangles, 4u);
+    EXPECT_EQ(queue.getStatistics().indexBufferBinds, 0u);
+}
@@ -0,0 +1,106 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Vulk/FrameCallTree.hpp>
+#include <gtest/gtest.h>
+
+#include <string_view>
+
+namespace {
+using Zone = vulk::utils::FrameCallTree::Zone;
+
+constexpr vulk::utils::FrameCallTree::Ticks Millisecond{1000000};  // Steady clock ticks are nanoseconds here
+
+Zone makeZone(const char* name, int64_t beginMs, int64_t endMs)
+{
+    return Zone{name, beginMs * Millisecond, endMs * Millisecond};
+}
+}  // namespace
+
+TEST(FrameCallTreeTests, NestsZonesByTime)
+{
+    if (vulk::utils::FrameCallTree::Milliseconds{std::chrono::steady_clock::duration{Millisecond}}.count() != 1.0)
+        GTEST_SKIP() << "The steady clock doesn't count nanoseconds";
+
+    vulk::utils::FrameCallTree tree{};
+
+    // Listed in the order they end, like the profiler records them
+    const Zone zones[] = {
+      makeZone("update", 0, 2),
+      makeZone("record", 3, 5),
+      makeZone("record", 6, 7),
+      makeZone("draw", 2, 9),
+      makeZone("present", 9, 10),
+    };
+    tree.addFrame(zones);
+
+    const auto nodes = tree.getNodes();
+    ASSERT_EQ(nodes.size(), 4u);
+
+    // Siblings by decreasing total time
+    EXPECT_EQ(std::string_view{nodes[0].name}, "draw");
+    EXPECT_EQ(nodes[0].parent, vulk::utils::FrameCallTree::Node::s_noParent);
+    EXPECT_DOUBLE_EQ(nodes[0].total.count(), 7.0);
+    EXPECT_DOUBLE_EQ(nodes[0].self.count(), 4.0);
+
+    EXPECT_EQ(std::string_view{nodes[1].name}, "record");
+    EXPECT_EQ(nodes[1].parent, 0u);
+    EXPECT_EQ(nodes[1].depth, 1u);
+    EXPECT_DOUBLE_EQ(nodes[1].calls, 2.0);
+    EXPECT_DOUBLE_EQ(nodes[1].total.count(), 3.0);
+
+    EXPECT_EQ(std::string_view{nodes[2].name}, "update");
+    EXPECT_EQ(nodes[2].depth, 0u);
+    EXPECT_EQ(std::string_view{nodes[3].name}, "present");
+}
+
+TEST(FrameCallTreeTests, AveragesOverTheWindow)
+{
+    if (vulk::utils::FrameCallTree::Milliseconds{std::chrono::steady_clock::duration{Millisecond}}.count() != 1.0)
+        GTEST_SKIP() << "The steady clock doesn't count nanoseconds";
+
+    vulk::utils::FrameCallTree tree{2};
+
+    const Zone first[] = {makeZone("draw", 0, 4), makeZone("load", 4, 5)};
+    const Zone second[] = {makeZone("draw", 10, 12)};
+    const Zone third[] = {makeZone("draw", 20, 26)};
+
+    tree.addFrame(first);
+    tree.addFrame(second);
+
+    auto nodes = tree.getNodes();
+    ASSERT_EQ(nodes.size(), 2u);
+    EXPECT_DOUBLE_EQ(nodes[0].total.count(), 3.0);
+    EXPECT_DOUBLE_EQ(nodes[1].calls, 0.5);
+
+    // The first frame leaves the window, and "load" with it
+    tree.addFrame(third);
+
+    nodes = tree.getNodes();
+    ASSERT_EQ(nodes.size(), 1u);
+    EXPECT_EQ(tree.getFrameCount(), 2u);
+    EXPECT_DOUBLE_EQ(nodes[0].total.count(), 4.0);
+    EXPECT_DOUBLE_EQ(nodes[0].calls, 1.0);
+
+    tree.setWindowSize(1);
+    EXPECT_DOUBLE_EQ(tree.getNodes()[0].total.count(), 6.0);
+
+    tree.clear();
+    EXPECT_TRUE(tree.getNodes().empty());
+}
@@ -0,0 +1,97 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Vulk/Exceptions.hpp>
+#include <Vulk/FrameRecorder.hpp>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+TEST(FrameRecorderTests, RecordsAndConvertsToCsv)
+{
+    const auto directory = std::filesystem::temp_directory_path();
+    const std::string recordPath = (directory / "vulk-frame-recorder-test.bin").string();
+    const std::string csvPath = (directory / "vulk-frame-recorder-test.csv").string();
+
+    const vulk::TimePoint start = vulk::Clock::now();
+
+    {
+        vulk::FrameRecorder recorder{recordPath};
+
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            vulk::FrameWorkload workload{};
+            workload.cpuTime = vulk::Duration{0.002f};
+            workload.gpuTime = vulk::Duration{0.004f};
+
+            vulk::RenderCounters counters{};
+            counters[vulk::RenderCounter::eDrawCalls] = i;
+            counters[vulk::RenderCounter::eUploadedBytes] = 64u * i;
+
+            recorder.append(start + std::chrono::milliseconds{16 * (i + 1)}, vulk::Duration{0.016f}, workload,
+                            counters);
+        }
+
+        EXPECT_EQ(recorder.getRecordCount(), 100u);
+    }
+
+    const auto records = vulk::FrameRecorder::read(recordPath);
+    ASSERT_EQ(records.size(), 100u);
+
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(records[i].frame, i);
+        EXPECT_EQ(records[i].drawCount, i);
+        EXPECT_EQ(records[i].uploadedBytes, 64u * i);
+        EXPECT_FLOAT_EQ(records[i].gpuTime, 0.004f);
+    }
+
+    EXPECT_LT(records[0].timestamp, records[1].timestamp);
+
+    vulk::FrameRecorder::convertToCsv(recordPath, csvPath);
+
+    std::ifstream csv{csvPath};
+    std::string line{};
+    size_t lineCount = 0;
+
+    ASSERT_TRUE(std::getline(csv, line));
+    EXPECT_EQ(line.rfind("frame,timestamp_ns,", 0), 0u);
+
+    while (std::getline(csv, line))
+        ++lineCount;
+    EXPECT_EQ(lineCount, 100u);
+
+    csv.close();
+    std::filesystem::remove(recordPath);
+    std::filesystem::remove(csvPath);
+}
+
+TEST(FrameRecorderTests, RejectsOtherFiles)
+{
+    const std::string filePath = (std::filesystem::temp_directory_path() / "vulk-frame-recorder-invalid.bin").string();
+
+    std::ofstream{filePath} << "definitely not a frame recording";
+
+    EXPECT_THROW(static_cast<void>(vulk::FrameRecorder::read(filePath)), vulk::InvalidFormatException);
+    EXPECT_THROW(static_cast<void>(vulk::FrameRecorder::read(filePath + ".missing")), vulk::FileNotFoundException);
+
+    std::filesystem::remove(filePath);
+}
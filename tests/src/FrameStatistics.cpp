@@ -0,0 +1,104 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Vulk/FrameStatistics.hpp>
+#include <gtest/gtest.h>
+
+namespace {
+constexpr vulk::Duration milliseconds(float value)
+{
+    return vulk::Duration{value / 1000.0f};
+}
+
+float toMilliseconds(vulk::Duration duration)
+{
+    return duration.count() * 1000.0f;
+}
+}  // namespace
+
+TEST(FrameStatisticsTests, Percentiles)
+{
+    vulk::FrameStatistics statistics{100};
+
+    // 90 steady frames and 10 stutters
+    for (int i = 0; i < 90; ++i)
+        statistics.addFrame(milliseconds(16.0f));
+    for (int i = 0; i < 10; ++i)
+        statistics.addFrame(milliseconds(50.0f));
+
+    EXPECT_EQ(statistics.getFrameCount(), 100u);
+
+    // Bucket upper bounds, within 4.5% of the exact value
+    EXPECT_GE(toMilliseconds(statistics.getPercentile(0.5f)), 16.0f);
+    EXPECT_LE(toMilliseconds(statistics.getPercentile(0.5f)), 16.0f * 1.045f);
+    EXPECT_GE(toMilliseconds(statistics.getPercentile(0.95f)), 50.0f * 0.999f);
+
+    // Never above the max
+    EXPECT_FLOAT_EQ(toMilliseconds(statistics.getPercentile(0.99f)), 50.0f);
+    EXPECT_FLOAT_EQ(toMilliseconds(statistics.getMax()), 50.0f);
+    EXPECT_NEAR(toMilliseconds(statistics.getMean()), 19.4f, 1e-3f);
+
+    // Only the switch from 16 to 50 ms
+    EXPECT_NEAR(toMilliseconds(statistics.getJitter()), 34.0f / 99.0f, 1e-3f);
+    EXPECT_EQ(statistics.getOverBudgetCount(), 10u);
+}
+
+TEST(FrameStatisticsTests, RollingWindow)
+{
+    vulk::FrameStatistics statistics{4, milliseconds(20.0f)};
+
+    statistics.addFrame(milliseconds(40.0f));
+    statistics.addFrame(milliseconds(30.0f));
+    EXPECT_FLOAT_EQ(toMilliseconds(statistics.getMax()), 40.0f);
+    EXPECT_EQ(statistics.getOverBudgetCount(), 2u);
+
+    for (int i = 0; i < 3; ++i)
+        statistics.addFrame(milliseconds(10.0f));
+
+    // The 40 ms frame left the window
+    EXPECT_EQ(statistics.getFrameCount(), 4u);
+    EXPECT_FLOAT_EQ(toMilliseconds(statistics.getMax()), 30.0f);
+    EXPECT_NEAR(toMilliseconds(statistics.getMean()), 15.0f, 1e-3f);
+    EXPECT_NEAR(toMilliseconds(statistics.getJitter()), 20.0f / 3.0f, 1e-3f);
+    EXPECT_EQ(statistics.getOverBudgetCount(), 1u);
+    EXPECT_EQ(statistics.getTotalOverBudgetCount(), 2u);
+
+    size_t histogramCount = 0;
+    for (const uint32_t count : statistics.getHistogram())
+        histogramCount += count;
+    EXPECT_EQ(histogramCount, 4u);
+
+    statistics.setBudget(milliseconds(5.0f));
+    EXPECT_EQ(statistics.getOverBudgetCount(), 4u);
+
+    statistics.clear();
+    EXPECT_EQ(statistics.getFrameCount(), 0u);
+    EXPECT_EQ(statistics.getMax().count(), 0.0f);
+    EXPECT_EQ(statistics.getPercentile(0.5f).count(), 0.0f);
+}
+
+TEST(FrameStatisticsTests, Buckets)
+{
+    EXPECT_EQ(vulk::FrameStatistics::getBucket(vulk::Duration{}), 0u);
+    EXPECT_EQ(vulk::FrameStatistics::getBucket(vulk::Duration{100.0f}), vulk::FrameStatistics::s_bucketCount - 1);
+
+    // 1 ms is 4 octaves above the first bucket
+    EXPECT_EQ(vulk::FrameStatistics::getBucket(milliseconds(1.0f)), 4 * vulk::FrameStatistics::s_bucketsPerOctave);
+    EXPECT_FLOAT_EQ(toMilliseconds(vulk::FrameStatistics::getBucketLowerBound(64)), 1.0f);
+}
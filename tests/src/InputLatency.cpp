@@ -0,0 +1,105 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Vulk/InputLatency.hpp>
+#include <gtest/gtest.h>
+
+namespace {
+constexpr vulk::Duration milliseconds(float value)
+{
+    return vulk::Duration{value / 1000.0f};
+}
+
+vulk::TimePoint at(float value)
+{
+    return vulk::TimePoint{} + std::chrono::duration_cast<vulk::Clock::duration>(milliseconds(value));
+}
+}  // namespace
+
+TEST(InputLatencyTests, MeasuredFromEarliestInput)
+{
+    vulk::InputLatency latency{};
+
+    latency.onInput(at(2.0f));
+    latency.onInput(at(1.0f));
+    latency.onFrameSubmitted(1);
+    latency.onFramePresented({1, at(21.0f)});
+
+    EXPECT_NEAR(latency.getLastLatency().count(), milliseconds(20.0f).count(), 1e-5f);
+    EXPECT_EQ(latency.getStatistics().getFrameCount(), 1);
+}
+
+TEST(InputLatencyTests, FramesWithoutInputAreNotMeasured)
+{
+    vulk::InputLatency latency{};
+
+    latency.onFrameSubmitted(1);
+    latency.onFramePresented({1, at(10.0f)});
+
+    EXPECT_EQ(latency.getStatistics().getFrameCount(), 0);
+    EXPECT_EQ(latency.getLastLatency().count(), 0.0f);
+}
+
+TEST(InputLatencyTests, InputWaitsForSubmittedFrame)
+{
+    vulk::InputLatency latency{};
+
+    // Nothing submitted, e.g. while the swapchain is recreated
+    latency.onInput(at(0.0f));
+    latency.onFrameSubmitted(0);
+    latency.onFrameSubmitted(2);
+
+    // The frame before it doesn't carry the input
+    latency.onFramePresented({1, at(10.0f)});
+    EXPECT_EQ(latency.getStatistics().getFrameCount(), 0);
+
+    latency.onFramePresented({2, at(30.0f)});
+    EXPECT_NEAR(latency.getLastLatency().count(), milliseconds(30.0f).count(), 1e-5f);
+}
+
+TEST(InputLatencyTests, LaterPresentCoversEarlierFrames)
+{
+    vulk::InputLatency latency{};
+
+    latency.onInput(at(0.0f));
+    latency.onFrameSubmitted(1);
+    latency.onInput(at(10.0f));
+    latency.onFrameSubmitted(2);
+
+    latency.onFramePresented({2, at(40.0f)});
+
+    EXPECT_EQ(latency.getStatistics().getFrameCount(), 2);
+    EXPECT_NEAR(latency.getStatistics().getMax().count(), milliseconds(40.0f).count(), 1e-3f);
+    EXPECT_NEAR(latency.getLastLatency().count(), milliseconds(30.0f).count(), 1e-5f);
+}
+
+TEST(InputLatencyTests, UnpresentedFramesAreDropped)
+{
+    vulk::InputLatency latency{};
+
+    for (uint64_t presentId = 1; presentId <= 2 * vulk::InputLatency::s_maxPendingFrames; ++presentId)
+    {
+        latency.onInput(at(static_cast<float>(presentId)));
+        latency.onFrameSubmitted(presentId);
+    }
+
+    latency.onFramePresented({2 * vulk::InputLatency::s_maxPendingFrames, at(100.0f)});
+
+    EXPECT_EQ(latency.getStatistics().getFrameCount(), vulk::InputLatency::s_maxPendingFrames);
+}
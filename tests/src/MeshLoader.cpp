@@ -0,0 +1,267 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include <Vulk/Exceptions.hpp>
+#include <Vulk/MeshLoader.hpp>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+// A triangle: 3 float VEC3 positions, then 3 unsigned short indices padded to 4 bytes
+constexpr size_t PositionsSize = 3 * 3 * sizeof(float);
+constexpr size_t BinSize = PositionsSize + 8;
+
+/**
+ * Written to the temporary directory, removed when destroyed.
+ */
+class TemporaryFile
+{
+public:
+    TemporaryFile(const std::string& name, const std::string& content)
+        : m_path{(std::filesystem::temp_directory_path() / name).string()}
+    {
+        std::ofstream{m_path, std::ios::binary} << content;
+    }
+
+    ~TemporaryFile() { std::filesystem::remove(m_path); }
+
+    TemporaryFile(const TemporaryFile&) = delete;
+    TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+    [[nodiscard]] const char* getPath() const noexcept { return m_path.c_str(); }
+
+private:
+    std::string m_path;
+};
+
+void appendUint32(std::string& data, uint32_t value)
+{
+    data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+std::string makeGlb(std::string json, const std::string& bin)
+{
+    json.resize((json.size() + 3) / 4 * 4, ' ');
+
+    std::string file{};
+    appendUint32(file, 0x46546C67);  // "glTF"
+    appendUint32(file, 2);
+    appendUint32(file, static_cast<uint32_t>(12 + 8 + json.size() + 8 + bin.size()));
+    appendUint32(file, static_cast<uint32_t>(json.size()));
+    appendUint32(file, 0x4E4F534A);  // "JSON"
+    file += json;
+    appendUint32(file, static_cast<uint32_t>(bin.size()));
+    appendUint32(file, 0x004E4942);  // "BIN\0"
+    file += bin;
+
+    return file;
+}
+
+std::string makeTriangleBin()
+{
+    const float positions[] = {0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.f};
+    const uint16_t indices[] = {0, 1, 2, 0};
+
+    std::string bin(BinSize, '\0');
+    std::memcpy(bin.data(), positions, sizeof(positions));
+    std::memcpy(bin.data() + PositionsSize, indices, sizeof(indices));
+
+    return bin;
+}
+
+// The indexed triangle, then the same positions again without indices
+std::string makeTriangleJson(const std::string& positionView = R"({"buffer": 0, "byteLength": 36})",
+                             const std::string& positionCount = "3")
+{
+    return R"({"asset": {"version": "2.0"}, "buffers": [{"byteLength": 44}],
+        "bufferViews": [)" +
+           positionView + R"(, {"buffer": 0, "byteOffset": 36, "byteLength": 6}],
+        "accessors": [
+            {"bufferView": 0, "componentType": 5126, "count": )" +
+           positionCount + R"(, "type": "VEC3"},
+            {"bufferView": 1, "componentType": 5123, "count": 3, "type": "SCALAR"}],
+        "meshes": [{"primitives": [{"attributes": {"POSITION": 0}, "indices": 1}]},
+                   {"primitives": [{"attributes": {"POSITION": 0}}]}]})";
+}
+}  // namespace
+
+TEST(MeshLoaderTests, Obj)
+{
+    // A triangle and a quad, with texture coordinates and normals, and a vertex color
+    const TemporaryFile file{"vulk-mesh-loader.obj", "# comment\n"
+                                                     "v 0 0 0\n"
+                                                     "v 1 0 0 0.5 0.25 0\n"
+                                                     "v 1 1 0\n"
+                                                     "v 0 1 0\r\n"
+                                                     "vt 0 0\n"
+                                                     "vn 0 0 1\n"
+                                                     "f 1 2 3\n"
+                                                     "f 1/1/1 2/1/1 3//1 4//1\n"};
+
+    const vulk::MeshLoader loader{file.getPath()};
+    ASSERT_EQ(loader.getVertexCount(), 4u);
+    ASSERT_EQ(loader.getIndexCount(), 9u);
+    EXPECT_FALSE(loader.needsUint32Indices());
+
+    std::vector<Vertex> vertices(loader.getVertexCount());
+    std::vector<uint16_t> indices(loader.getIndexCount());
+    loader.write(vertices.data(), indices.data());
+
+    EXPECT_EQ(vertices[2].position, glm::vec2(1.f, 1.f));
+    EXPECT_EQ(vertices[0].color, glm::vec3(1.f));
+    EXPECT_EQ(vertices[1].color, glm::vec3(0.5f, 0.25f, 0.f));
+
+    // Faces of more than 3 vertices are split as fans
+    EXPECT_EQ(indices, (std::vector<uint16_t>{0, 1, 2, 0, 1, 2, 0, 2, 3}));
+}
+
+TEST(MeshLoaderTests, ObjRelativeIndices)
+{
+    // Negative references count back from the last vertex defined so far
+    const TemporaryFile file{"vulk-mesh-loader-relative.obj", "v 0 0 0\n"
+                                                              "v 1 0 0\n"
+                                                              "v 1 1 0\n"
+                                                              "f -3 -2 -1\n"
+                                                              "v 0 1 0\n"
+                                                              "f -4 -2 -1\n"};
+
+    const vulk::MeshLoader loader{file.getPath()};
+    ASSERT_EQ(loader.getVertexCount(), 4u);
+    ASSERT_EQ(loader.getIndexCount(), 6u);
+
+    std::vector<Vertex> vertices(loader.getVertexCount());
+    std::vector<uint32_t> indices(loader.getIndexCount());
+    loader.write(vertices.data(), indices.data());
+
+    EXPECT_EQ(indices, (std::vector<uint32_t>{0, 1, 2, 0, 2, 3}));
+}
+
+TEST(MeshLoaderTests, ObjInvalid)
+{
+    std::vector<Vertex> vertices(3);
+    std::vector<uint32_t> indices(3);
+
+    const TemporaryFile tooFewCorners{"vulk-mesh-loader-corners.obj", "v 0 0 0\nv 1 0 0\nf 1 2\n"};
+    EXPECT_THROW(vulk::MeshLoader{tooFewCorners.getPath()}, vulk::InvalidFormatException);
+
+    // Counted fine, only resolved when writing
+    for (const char* face : {"f 1 2 4\n", "f 0 1 2\n", "f -4 1 2\n"})
+    {
+        const std::string obj = std::string{"v 0 0 0\nv 1 0 0\nv 1 1 0\n"} + face;
+        const TemporaryFile missingVertex{"vulk-mesh-loader-missing.obj", obj};
+        const vulk::MeshLoader loader{missingVertex.getPath()};
+
+        EXPECT_THROW(loader.write(vertices.data(), indices.data()), vulk::InvalidFormatException) << face;
+    }
+
+    const TemporaryFile unknownFormat{"vulk-mesh-loader.ply", "v 0 0 0\n"};
+    EXPECT_THROW(vulk::MeshLoader{unknownFormat.getPath()}, vulk::InvalidFormatException);
+}
+
+TEST(MeshLoaderTests, Glb)
+{
+    const TemporaryFile file{"vulk-mesh-loader.glb", makeGlb(makeTriangleJson(), makeTriangleBin())};
+
+    const vulk::MeshLoader loader{file.getPath()};
+    ASSERT_EQ(loader.getVertexCount(), 6u);
+    ASSERT_EQ(loader.getIndexCount(), 6u);
+
+    std::vector<Vertex> vertices(loader.getVertexCount());
+    std::vector<uint16_t> indices(loader.getIndexCount());
+    loader.write(vertices.data(), indices.data());
+
+    EXPECT_EQ(vertices[1].position, glm::vec2(1.f, 0.f));
+    EXPECT_EQ(vertices[5].position, glm::vec2(0.f, 1.f));
+    EXPECT_EQ(vertices[5].color, glm::vec3(1.f));
+
+    // The primitive without indices follows the first one
+    EXPECT_EQ(indices, (std::vector<uint16_t>{0, 1, 2, 3, 4, 5}));
+}
+
+TEST(MeshLoaderTests, GlbInvalidHeader)
+{
+    std::string wrongMagic = makeGlb(makeTriangleJson(), makeTriangleBin());
+    wrongMagic[0] = 'x';
+    const TemporaryFile wrongMagicFile{"vulk-mesh-loader-magic.glb", wrongMagic};
+    EXPECT_THROW(vulk::MeshLoader{wrongMagicFile.getPath()}, vulk::InvalidFormatException);
+
+    std::string wrongVersion = makeGlb(makeTriangleJson(), makeTriangleBin());
+    wrongVersion[4] = 1;
+    const TemporaryFile wrongVersionFile{"vulk-mesh-loader-version.glb", wrongVersion};
+    EXPECT_THROW(vulk::MeshLoader{wrongVersionFile.getPath()}, vulk::InvalidFormatException);
+}
+
+TEST(MeshLoaderTests, GlbTruncatedChunks)
+{
+    const std::string glb = makeGlb(makeTriangleJson(), makeTriangleBin());
+
+    // Cut in the binary chunk, in the JSON chunk, and in the JSON chunk header
+    for (const size_t size : {glb.size() - 1, glb.size() - BinSize - 12, size_t{18}})
+    {
+        const TemporaryFile file{"vulk-mesh-loader-truncated.glb", glb.substr(0, size)};
+        EXPECT_THROW(vulk::MeshLoader{file.getPath()}, vulk::InvalidFormatException) << size;
+    }
+
+    // The JSON alone, its chunk cut in the middle of a value
+    const std::string json = makeTriangleJson();
+    std::string truncatedJson = makeGlb(json, makeTriangleBin());
+    truncatedJson.replace(20 + json.size() / 2, 1, "\"");
+
+    const TemporaryFile file{"vulk-mesh-loader-json.glb", truncatedJson};
+    EXPECT_THROW(vulk::MeshLoader{file.getPath()}, vulk::InvalidFormatException);
+}
+
+TEST(MeshLoaderTests, GlbRangesPastTheBuffer)
+{
+    const std::vector<std::string> jsons{
+      // Buffer views past the binary chunk, wrapping around when added
+      makeTriangleJson(R"({"buffer": 0, "byteLength": 48})"),
+      makeTriangleJson(R"({"buffer": 0, "byteOffset": 40, "byteLength": 36})"),
+      makeTriangleJson(R"({"buffer": 0, "byteOffset": 18446744073709551615, "byteLength": 36})"),
+      // Accessors past their buffer view
+      makeTriangleJson(R"({"buffer": 0, "byteLength": 36})", "4"),
+      makeTriangleJson(R"({"buffer": 0, "byteLength": 36, "byteStride": 16})"),
+      makeTriangleJson(R"({"buffer": 0, "byteLength": 36})", "4294967295"),
+      // Another buffer than the binary chunk
+      makeTriangleJson(R"({"buffer": 1, "byteLength": 36})"),
+    };
+
+    for (const auto& json : jsons)
+    {
+        const TemporaryFile file{"vulk-mesh-loader-range.glb", makeGlb(json, makeTriangleBin())};
+        EXPECT_THROW(vulk::MeshLoader{file.getPath()}, vulk::InvalidFormatException) << json;
+    }
+
+    // Indices referencing missing vertices are only read when writing
+    std::string bin = makeTriangleBin();
+    bin[PositionsSize] = 3;
+
+    const TemporaryFile file{"vulk-mesh-loader-index.glb", makeGlb(makeTriangleJson(), bin)};
+    const vulk::MeshLoader loader{file.getPath()};
+
+    std::vector<Vertex> vertices(loader.getVertexCount());
+    std::vector<uint32_t> indices(loader.getIndexCount());
+    EXPECT_THROW(loader.write(vertices.data(), indices.data()), vulk::InvalidFormatException);
+}
@@ -0,0 +1,245 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Vulk/MeshOptimizer.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <tuple>
+#include <vector>
+
+static constexpr uint32_t GridSize = 64;
+
+static bool operator==(const Vertex& lhs, const Vertex& rhs)
+{
+    return lhs.position.x == rhs.position.x && lhs.position.y == rhs.position.y;
+}
+
+static std::vector<Vertex> makeGridVertices()
+{
+    std::vector<Vertex> vertices{};
+
+    for (uint32_t y = 0; y <= GridSize; ++y)
+    {
+        for (uint32_t x = 0; x <= GridSize; ++x)
+            vertices.push_back(Vertex{{static_cast<float>(x), static_cast<float>(y)}, {}});
+    }
+
+    return vertices;
+}
+
+// Triangles in random order, the worst case for every cache
+static std::vector<uint32_t> makeShuffledGridIndices()
+{
+    std::vector<std::array<uint32_t, 3>> triangles{};
+
+    for (uint32_t y = 0; y < GridSize; ++y)
+    {
+        for (uint32_t x = 0; x < GridSize; ++x)
+        {
+            const uint32_t v = y * (GridSize + 1) + x;
+
+            triangles.push_back({v, v + 1, v + GridSize + 1});
+            triangles.push_back({v + 1, v + GridSize + 2, v + GridSize + 1});
+        }
+    }
+
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937{42});
+
+    std::vector<uint32_t> indices{};
+
+    for (const auto& triangle : triangles)
+        indices.insert(indices.end(), triangle.begin(), triangle.end());
+
+    return indices;
+}
+
+// Triangles as rotation-independent tuples, to check that passes only reorder them
+static std::vector<std::array<Vertex, 3>> sortedTriangles(const std::vector<Vertex>& vertices,
+                                                           const std::vector<uint32_t>& indices)
+{
+    auto less = [](const Vertex& lhs, const Vertex& rhs) {
+        return std::tie(lhs.position.x, lhs.position.y) < std::tie(rhs.position.x, rhs.position.y);
+    };
+
+    std::vector<std::array<Vertex, 3>> triangles{};
+
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        std::array<Vertex, 3> triangle{vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]]};
+        std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end(), less), triangle.end());
+        triangles.push_back(triangle);
+    }
+
+    std::sort(triangles.begin(), triangles.end(), [&](const auto& lhs, const auto& rhs) {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), less);
+    });
+
+    return triangles;
+}
+
+TEST(MeshOptimizerTests, VertexCache)
+{
+    const auto vertices = makeGridVertices();
+    auto indices = makeShuffledGridIndices();
+    const auto vertexCount = static_cast<uint32_t>(vertices.size());
+
+    const auto before = vulk::mesh::analyzeVertexCache<uint32_t>(indices, vertexCount);
+    const auto expected = sortedTriangles(vertices, indices);
+
+    vulk::mesh::optimizeVertexCache<uint32_t>(indices, vertexCount);
+
+    const auto after = vulk::mesh::analyzeVertexCache<uint32_t>(indices, vertexCount);
+
+    EXPECT_GT(before.acmr, 2.f);
+    EXPECT_LT(after.acmr, 0.8f);
+    EXPECT_LT(after.atvr, before.atvr);
+    EXPECT_EQ(sortedTriangles(vertices, indices), expected);
+}
+
+TEST(MeshOptimizerTests, Overdraw)
+{
+    // A small cube seen from inside drawn before a big one seen from outside, both around the origin.
+    // Faces don't share vertices so each one is a cluster of its own.
+    std::vector<glm::vec3> positions{};
+    std::vector<uint32_t> indices{};
+
+    const auto addCube = [&](float size, bool inward) {
+        const auto corner = [size](uint32_t bits) {
+            return glm::vec3{bits & 1 ? size : -size, bits & 2 ? size : -size, bits & 4 ? size : -size};
+        };
+
+        // Counter-clockwise seen from outside
+        constexpr std::array<std::array<uint32_t, 4>, 6> Faces{
+          {{1, 3, 7, 5}, {0, 4, 6, 2}, {2, 6, 7, 3}, {0, 1, 5, 4}, {4, 5, 7, 6}, {0, 2, 3, 1}}};
+
+        for (const auto& face : Faces)
+        {
+            const auto first = static_cast<uint32_t>(positions.size());
+
+            for (const uint32_t bits : face)
+                positions.push_back(corner(bits));
+
+            if (inward)
+                indices.insert(indices.end(), {first, first + 2, first + 1, first, first + 3, first + 2});
+            else
+                indices.insert(indices.end(), {first, first + 1, first + 2, first, first + 2, first + 3});
+        }
+    };
+
+    addCube(0.5f, true);
+    const auto innerVertexCount = static_cast<uint32_t>(positions.size());
+    addCube(1.f, false);
+
+    const auto vertexCount = static_cast<uint32_t>(positions.size());
+    const auto innerIndexCount = static_cast<ptrdiff_t>(indices.size() / 2);
+
+    vulk::mesh::optimizeVertexCache<uint32_t>(indices, vertexCount);
+
+    const auto triangles = [&] {
+        std::vector<std::array<uint32_t, 3>> result{};
+
+        for (size_t i = 0; i < indices.size(); i += 3)
+            result.push_back({indices[i], indices[i + 1], indices[i + 2]});
+
+        std::sort(result.begin(), result.end());
+        return result;
+    };
+
+    const auto isOuter = [innerVertexCount](uint32_t index) { return index >= innerVertexCount; };
+    const auto outerFirst = [&] {
+        return std::all_of(indices.begin(), indices.begin() + innerIndexCount, isOuter) &&
+               std::none_of(indices.begin() + innerIndexCount, indices.end(), isOuter);
+    };
+
+    const auto optimized = vulk::mesh::analyzeVertexCache<uint32_t>(indices, vertexCount);
+    const auto expected = triangles();
+    ASSERT_FALSE(outerFirst());
+
+    vulk::mesh::optimizeOverdraw<uint32_t>(indices, positions, 1.05f);
+
+    // The outer cube hides the inner one, it goes first
+    EXPECT_TRUE(outerFirst());
+    EXPECT_LE(vulk::mesh::analyzeVertexCache<uint32_t>(indices, vertexCount).acmr, optimized.acmr * 1.1f);
+    EXPECT_EQ(triangles(), expected);
+}
+
+TEST(MeshOptimizerTests, OverdrawFlatMesh)
+{
+    const auto vertices = makeGridVertices();
+    auto indices = makeShuffledGridIndices();
+    const auto vertexCount = static_cast<uint32_t>(vertices.size());
+
+    std::vector<glm::vec3> positions{};
+
+    for (const Vertex& vertex : vertices)
+        positions.emplace_back(vertex.position, 0.f);
+
+    vulk::mesh::optimizeVertexCache<uint32_t>(indices, vertexCount);
+
+    const auto expected = indices;
+
+    // Every cluster faces the same way, nothing to reorder
+    vulk::mesh::optimizeOverdraw<uint32_t>(indices, positions, 1.05f);
+
+    EXPECT_EQ(indices, expected);
+}
+
+TEST(MeshOptimizerTests, VertexFetch)
+{
+    auto vertices = makeGridVertices();
+    auto indices = makeShuffledGridIndices();
+
+    // Unreferenced vertices are dropped
+    vertices.push_back(Vertex{{-1.f, -1.f}, {}});
+
+    const auto expected = sortedTriangles(vertices, indices);
+    const uint32_t vertexCount = vulk::mesh::optimizeVertexFetch<uint32_t>(vertices, indices);
+
+    vertices.resize(vertexCount);
+
+    EXPECT_EQ(vertexCount, (GridSize + 1) * (GridSize + 1));
+    EXPECT_EQ(sortedTriangles(vertices, indices), expected);
+
+    // Each vertex is first referenced right after the previous one
+    uint32_t next = 0;
+
+    for (const uint32_t index : indices)
+    {
+        EXPECT_LE(index, next);
+
+        if (index == next)
+            ++next;
+    }
+}
+
+TEST(MeshOptimizerTests, NarrowIndices)
+{
+    EXPECT_TRUE(vulk::mesh::fitsUint16Indices(65536));
+    EXPECT_FALSE(vulk::mesh::fitsUint16Indices(65537));
+
+    std::vector<uint32_t> indices{0, 1, 2, 65535, 42, 7};
+    const uint16_t* narrowed = vulk::mesh::narrowIndices(indices.data(), indices.size());
+
+    const std::vector<uint16_t> expected{0, 1, 2, 65535, 42, 7};
+
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), narrowed));
+}
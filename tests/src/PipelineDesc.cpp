@@ -0,0 +1,120 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Vulk/PipelineDesc.hpp>
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <vector>
+
+TEST(PipelineDescTests, EqualDescriptionsHashEqually)
+{
+    vulk::PipelineDesc lhs{};
+    lhs.vertexShader = "shader.vert.spv";
+    lhs.fragmentShader = "shader.frag.spv";
+    lhs.vertexStride = 20;
+
+    vulk::PipelineDesc rhs = lhs;
+
+    EXPECT_EQ(lhs, rhs);
+    EXPECT_EQ(lhs.hash(), rhs.hash());
+    EXPECT_EQ(vulk::PipelineDesc{}.hash(), vulk::PipelineDesc{}.hash());
+}
+
+TEST(PipelineDescTests, EveryMemberChangesTheHash)
+{
+    vulk::PipelineDesc base{};
+    base.vertexShader = "shader.vert.spv";
+    base.fragmentShader = "shader.frag.spv";
+
+    const std::vector<std::function<void(vulk::PipelineDesc&)>> changes{
+      [](auto& desc) { desc.vertexShader = "other.vert.spv"; },
+      [](auto& desc) { desc.fragmentShader = "other.frag.spv"; },
+      [](auto& desc) { desc.vertexConstants.set(0, true); },
+      [](auto& desc) { desc.fragmentConstants.set(0, 4u); },
+      [](auto& desc) { desc.vertexStride = 20; },
+      [](auto& desc) { desc.topology = vk::PrimitiveTopology::eLineList; },
+      [](auto& desc) { desc.polygonMode = vk::PolygonMode::eLine; },
+      [](auto& desc) { desc.cullMode = vk::CullModeFlagBits::eNone; },
+      [](auto& desc) { desc.frontFace = vk::FrontFace::eClockwise; },
+      [](auto& desc) { desc.blendMode = vulk::PipelineDesc::BlendMode::eAdditive; },
+      [](auto& desc) { desc.depthTest = true; },
+      [](auto& desc) { desc.depthWrite = true; },
+      [](auto& desc) { desc.depthCompareOp = vk::CompareOp::eLessOrEqual; },
+      [](auto& desc) { desc.subpass = 1; },
+    };
+
+    for (const auto& change : changes)
+    {
+        vulk::PipelineDesc changed = base;
+        change(changed);
+
+        EXPECT_NE(changed, base);
+        EXPECT_NE(changed.hash(), base.hash());
+    }
+}
+
+TEST(PipelineDescTests, DynamicStateIsIgnoredOnRequest)
+{
+    vulk::PipelineDesc base{};
+    base.vertexShader = "shader.vert.spv";
+    base.fragmentShader = "shader.frag.spv";
+
+    const std::vector<std::function<void(vulk::PipelineDesc&)>> dynamicChanges{
+      [](auto& desc) { desc.topology = vk::PrimitiveTopology::eTriangleStrip; },
+      [](auto& desc) { desc.cullMode = vk::CullModeFlagBits::eNone; },
+      [](auto& desc) { desc.frontFace = vk::FrontFace::eClockwise; },
+      [](auto& desc) { desc.depthTest = true; },
+      [](auto& desc) { desc.depthWrite = true; },
+      [](auto& desc) { desc.depthCompareOp = vk::CompareOp::eLessOrEqual; },
+    };
+
+    for (const auto& change : dynamicChanges)
+    {
+        vulk::PipelineDesc changed = base;
+        change(changed);
+
+        EXPECT_TRUE(changed.isSamePipeline(base, true));
+        EXPECT_EQ(changed.hash(true), base.hash(true));
+        EXPECT_FALSE(changed.isSamePipeline(base, false));
+    }
+
+    // Topologies can only be switched within their class
+    vulk::PipelineDesc lines = base;
+    lines.topology = vk::PrimitiveTopology::eLineStrip;
+    EXPECT_FALSE(lines.isSamePipeline(base, true));
+    EXPECT_NE(lines.hash(true), base.hash(true));
+
+    vulk::PipelineDesc blended = base;
+    blended.blendMode = vulk::PipelineDesc::BlendMode::eAlpha;
+    EXPECT_FALSE(blended.isSamePipeline(base, true));
+}
+
+TEST(PipelineDescTests, ShaderPathsDontBleedIntoEachOther)
+{
+    vulk::PipelineDesc lhs{};
+    lhs.vertexShader = "ab";
+    lhs.fragmentShader = "c";
+
+    vulk::PipelineDesc rhs{};
+    rhs.vertexShader = "a";
+    rhs.fragmentShader = "bc";
+
+    EXPECT_NE(lhs.hash(), rhs.hash());
+}
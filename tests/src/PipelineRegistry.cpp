@@ -0,0 +1,57 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include <Vulk/Exceptions.hpp>
+#include <Vulk/PipelineRegistry.hpp>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+
+TEST(PipelineRegistryTests, FailedBuildsFinish)
+{
+    // Builds fail before using the device: the shaders don't exist
+    const vk::Device device{};
+    vulk::PipelineLayoutCache layoutCache{device};
+    vulk::ShaderLibrary shaderLibrary{device};
+    vulk::ThreadPool workers{2};
+    vulk::PipelineRegistry registry{device, layoutCache, shaderLibrary, workers};
+
+    vulk::PipelineDesc desc{};
+    desc.vertexShader = "missing.vert.spv";
+    desc.fragmentShader = "missing.frag.spv";
+
+    EXPECT_EQ(registry.requestPipeline(desc), nullptr);
+
+    // Would wait forever for a build still marked in flight
+    auto waiting = std::async(std::launch::async, [&registry] { registry.waitForBuilds(); });
+    ASSERT_EQ(waiting.wait_for(std::chrono::seconds{10}), std::future_status::ready);
+
+    EXPECT_EQ(registry.getStatistics().failures, 1u);
+    EXPECT_EQ(registry.getPipelineCount(), 0u);
+
+    // Reported once, not queued again
+    EXPECT_EQ(registry.requestPipeline(desc), nullptr);
+    registry.waitForBuilds();
+    EXPECT_EQ(registry.getStatistics().failures, 1u);
+
+    // Blocking requests build again, and throw
+    EXPECT_THROW(static_cast<void>(registry.getPipeline(desc)), vulk::FileNotFoundException);
+}
@@ -0,0 +1,78 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Vulk/RenderCounters.hpp>
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+TEST(RenderCountersTests, FoldSumsEveryThread)
+{
+    static_cast<void>(vulk::counters::fold());
+
+    std::vector<std::thread> threads{};
+
+    for (uint64_t i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([i] {
+            for (int j = 0; j < 1000; ++j)
+                vulk::counters::add(vulk::RenderCounter::eDrawCalls);
+
+            vulk::counters::add(vulk::RenderCounter::eUploadedBytes, 64 * (i + 1));
+        });
+    }
+
+    vulk::counters::add(vulk::RenderCounter::eQueueSubmits);
+
+    for (auto& thread : threads)
+        thread.join();
+
+    const vulk::RenderCounters counters = vulk::counters::fold();
+
+    EXPECT_EQ(counters[vulk::RenderCounter::eDrawCalls], 4000u);
+    EXPECT_EQ(counters[vulk::RenderCounter::eUploadedBytes], 640u);
+    EXPECT_EQ(counters[vulk::RenderCounter::eQueueSubmits], 1u);
+    EXPECT_EQ(counters[vulk::RenderCounter::eTriangles], 0u);
+
+    // Folding resets the accumulators
+    EXPECT_EQ(vulk::counters::fold(), vulk::RenderCounters{});
+}
+
+TEST(RenderCountersTests, AddAndPrint)
+{
+    vulk::RenderCounters counters{};
+    counters[vulk::RenderCounter::eDrawCalls] = 3;
+
+    vulk::RenderCounters other{};
+    other[vulk::RenderCounter::eDrawCalls] = 2;
+    other[vulk::RenderCounter::eAllocations] = 1;
+
+    counters += other;
+
+    EXPECT_EQ(counters[vulk::RenderCounter::eDrawCalls], 5u);
+    EXPECT_EQ(counters[vulk::RenderCounter::eAllocations], 1u);
+
+    std::ostringstream os{};
+    os << counters;
+
+    EXPECT_NE(os.str().find("draw calls: 5"), std::string::npos);
+    EXPECT_NE(os.str().find("queue submits: 0"), std::string::npos);
+}
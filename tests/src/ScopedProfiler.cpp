@@ -0,0 +1,191 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Vulk/ScopedProfiler.hpp>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+#include <thread>
+
+namespace {
+size_t countOccurrences(const std::string& text, const std::string& pattern)
+{
+    size_t count = 0;
+
+    for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+        ++count;
+
+    return count;
+}
+
+constexpr vulk::utils::ZoneDescriptor Outer{"outer"};
+constexpr vulk::utils::ZoneDescriptor Inner{"inner \"quoted\"", vulk::utils::ProfilerCategory::eLoading, 0xff0000};
+constexpr vulk::utils::ZoneDescriptor Ignored{"ignored"};
+constexpr vulk::utils::ZoneDescriptor Draw{"draw", vulk::utils::ProfilerCategory::eFrame};
+constexpr vulk::utils::ZoneDescriptor Record{"record", vulk::utils::ProfilerCategory::eFrame};
+constexpr vulk::utils::ZoneDescriptor Other{"other thread"};
+}  // namespace
+
+TEST(ProfilerTests, ZoneDescriptors)
+{
+    EXPECT_NE(std::string_view{Outer.file}.find("ScopedProfiler.cpp"), std::string_view::npos);
+    EXPECT_GT(Outer.line, 0u);
+    EXPECT_EQ(Inner.line, Outer.line + 1);
+    EXPECT_EQ(Outer.category, vulk::utils::ProfilerCategory::eGeneral);
+    EXPECT_EQ(Outer.color, vulk::utils::ZoneDescriptor::s_categoryColors[0]);
+    EXPECT_EQ(Inner.color, 0xff0000u);
+}
+
+TEST(ProfilerTests, WritesChromeTrace)
+{
+    const auto filePath = std::filesystem::temp_directory_path() / "vulk-profiler-test.json";
+
+    auto& profiler = vulk::utils::Profiler::getInstance();
+    profiler.startTrace(filePath.string());
+    ASSERT_TRUE(profiler.isTracing());
+
+    {
+        const vulk::utils::ScopedProfiler outer{Outer};
+
+        std::thread worker{[] { const vulk::utils::ScopedProfiler inner{Inner}; }};
+        worker.join();
+    }
+
+    profiler.stopTrace();
+    EXPECT_FALSE(profiler.isTracing());
+
+    // Not recorded, no trace is running
+    {
+        const vulk::utils::ScopedProfiler ignored{Ignored};
+    }
+
+    std::ifstream file{filePath};
+    std::stringstream stream{};
+    stream << file.rdbuf();
+    const std::string trace = stream.str();
+
+    EXPECT_EQ(trace.front(), '[');
+    EXPECT_EQ(countOccurrences(trace, R"("ph":"X")"), 2u);
+    EXPECT_EQ(countOccurrences(trace, R"("name":"outer")"), 1u);
+    EXPECT_EQ(countOccurrences(trace, R"("name":"inner \"quoted\"","cat":"loading")"), 1u);
+    EXPECT_EQ(countOccurrences(trace, "ScopedProfiler.cpp"), 2u);
+    EXPECT_EQ(countOccurrences(trace, "ignored"), 0u);
+    EXPECT_NE(trace.find(']'), std::string::npos);
+
+    std::filesystem::remove(filePath);
+}
+
+TEST(ProfilerTests, AggregatesFramesOfTheFrameThread)
+{
+    auto& profiler = vulk::utils::Profiler::getInstance();
+
+    // Runs on its own thread, which becomes the frame thread
+    std::thread frameThread{[&profiler] {
+        profiler.setFrameWindow(4);
+
+        for (int frame = 0; frame < 8; ++frame)
+        {
+            {
+                const vulk::utils::ScopedProfiler draw{Draw};
+                const vulk::utils::ScopedProfiler record{Record};
+            }
+
+            profiler.markFrame();
+        }
+    }};
+    frameThread.join();
+
+    // Not part of the frames
+    {
+        const vulk::utils::ScopedProfiler other{Other};
+    }
+
+    profiler.flush();
+
+    const auto nodes = profiler.getFrameProfile();
+    ASSERT_EQ(nodes.size(), 2u);
+    EXPECT_EQ(std::string{nodes[0].name}, "draw");
+    EXPECT_DOUBLE_EQ(nodes[0].calls, 1.0);
+    EXPECT_EQ(std::string{nodes[1].name}, "record");
+    EXPECT_EQ(nodes[1].parent, 0u);
+    EXPECT_GE(nodes[0].total, nodes[1].total);
+}
+
+TEST(ProfilerTests, DisabledCategoriesAreNotRecorded)
+{
+    const auto filePath = std::filesystem::temp_directory_path() / "vulk-profiler-categories-test.json";
+
+    auto& profiler = vulk::utils::Profiler::getInstance();
+    profiler.startTrace(filePath.string());
+
+    vulk::utils::Profiler::setCategoryEnabled(vulk::utils::ProfilerCategory::eLoading, false);
+    EXPECT_FALSE(vulk::utils::Profiler::isCategoryEnabled(vulk::utils::ProfilerCategory::eLoading));
+    EXPECT_TRUE(vulk::utils::Profiler::isCategoryEnabled(vulk::utils::ProfilerCategory::eFrame));
+
+    {
+        const vulk::utils::ScopedProfiler inner{Inner};
+        const vulk::utils::ScopedProfiler draw{Draw};
+    }
+
+    vulk::utils::Profiler::setCategoryEnabled(vulk::utils::ProfilerCategory::eLoading, true);
+    profiler.stopTrace();
+
+    std::ifstream file{filePath};
+    std::stringstream stream{};
+    stream << file.rdbuf();
+    const std::string trace = stream.str();
+
+    EXPECT_EQ(countOccurrences(trace, R"("name":"draw")"), 1u);
+    EXPECT_EQ(countOccurrences(trace, "inner"), 0u);
+
+    std::filesystem::remove(filePath);
+}
+
+TEST(ProfilerTests, NoTraceUntilStarted)
+{
+    auto& profiler = vulk::utils::Profiler::getInstance();
+
+    {
+        const vulk::utils::ScopedProfiler outer{Outer};
+    }
+
+    EXPECT_FALSE(profiler.isTracing());
+}
+
+TEST(ProfilerTests, FreesTheBuffersOfExitedThreads)
+{
+    auto& profiler = vulk::utils::Profiler::getInstance();
+
+    profiler.flush();
+    const size_t threadCount = profiler.getThreadCount();
+
+    for (int i = 0; i < 16; ++i)
+    {
+        std::thread worker{[] { const vulk::utils::ScopedProfiler other{Other}; }};
+        worker.join();
+    }
+
+    EXPECT_EQ(profiler.getThreadCount(), threadCount + 16);
+
+    profiler.flush();
+    EXPECT_EQ(profiler.getThreadCount(), threadCount);
+}
@@ -0,0 +1,147 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include <Vulk/ShaderCompiler.hpp>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr std::string_view Source = R"(#version 450
+#include "value.glsl"
+
+layout(location = 0) out float outValue;
+
+void main()
+{
+    outValue = VALUE + INCLUDED_VALUE;
+    gl_Position = vec4(0.0);
+}
+)";
+
+class ShaderCompilerTests : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        std::filesystem::remove_all(m_directory);
+        std::filesystem::create_directories(m_directory / "include");
+        writeInclude("1.0");
+
+        m_compiler.addIncludeDirectory((m_directory / "include").string());
+    }
+
+    void TearDown() override { std::filesystem::remove_all(m_directory); }
+
+    void writeInclude(const std::string& value) const
+    {
+        std::ofstream{m_directory / "include" / "value.glsl"} << "#define INCLUDED_VALUE " << value << '\n';
+    }
+
+    [[nodiscard]] vulk::SpirvCode compile(const std::string& value = "1.0") const
+    {
+        const std::vector<vulk::ShaderCompiler::Define> defines{{"VALUE", value}};
+        return m_compiler.compile(Source, "shader.vert", vk::ShaderStageFlagBits::eVertex, defines);
+    }
+
+    [[nodiscard]] std::vector<std::filesystem::path> getCacheFiles() const
+    {
+        std::vector<std::filesystem::path> files{};
+
+        for (const auto& entry : std::filesystem::directory_iterator{m_directory / "cache"})
+            files.push_back(entry.path());
+
+        return files;
+    }
+
+    const std::filesystem::path m_directory{std::filesystem::temp_directory_path() / "vulk-shader-compiler-test"};
+    vulk::ShaderCompiler m_compiler{(m_directory / "cache").string()};
+};
+
+std::vector<uint32_t> toVector(const vulk::SpirvCode& code)
+{
+    return {code.getWords().begin(), code.getWords().end()};
+}
+}  // namespace
+
+TEST_F(ShaderCompilerTests, CachesCompilations)
+{
+    const vulk::SpirvCode compiled = compile();
+    EXPECT_FALSE(compiled.isCached());
+    ASSERT_EQ(getCacheFiles().size(), 1u);
+
+    const vulk::SpirvCode cached = compile();
+    EXPECT_TRUE(cached.isCached());
+    EXPECT_EQ(toVector(cached), toVector(compiled));
+}
+
+TEST_F(ShaderCompilerTests, DefinesChangeTheKey)
+{
+    static_cast<void>(compile("1.0"));
+
+    EXPECT_FALSE(compile("2.0").isCached());
+    EXPECT_TRUE(compile("1.0").isCached());
+    EXPECT_TRUE(compile("2.0").isCached());
+    EXPECT_EQ(getCacheFiles().size(), 2u);
+}
+
+TEST_F(ShaderCompilerTests, IncludedFilesChangeTheKey)
+{
+    static_cast<void>(compile());
+
+    writeInclude("2.0");
+    EXPECT_FALSE(compile().isCached());
+    EXPECT_TRUE(compile().isCached());
+}
+
+TEST_F(ShaderCompilerTests, OptimizationLevelChangesTheKey)
+{
+    m_compiler.setOptimizationLevel(shaderc_optimization_level_zero);
+    static_cast<void>(compile());
+
+    m_compiler.setOptimizationLevel(shaderc_optimization_level_performance);
+    EXPECT_FALSE(compile().isCached());
+    EXPECT_TRUE(compile().isCached());
+}
+
+TEST_F(ShaderCompilerTests, RebuildsInvalidCacheFiles)
+{
+    const std::vector<uint32_t> expected = toVector(compile());
+    const std::filesystem::path cacheFile = getCacheFiles().at(0);
+
+    // Truncated in the middle of a word, before the end of the header, and replaced by something else
+    const std::vector<std::string> invalidContents{std::string(7, '\0'), std::string(16, '\0'),
+                                                   std::string(64, 'x'), std::string{}};
+
+    for (const auto& content : invalidContents)
+    {
+        std::ofstream{cacheFile, std::ios::binary | std::ios::trunc} << content;
+
+        const vulk::SpirvCode rebuilt = compile();
+        EXPECT_FALSE(rebuilt.isCached());
+        EXPECT_EQ(toVector(rebuilt), expected);
+
+        // Replaced by the rebuilt one
+        EXPECT_TRUE(compile().isCached());
+    }
+}
@@ -0,0 +1,377 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Vulk/Exceptions.hpp>
+#include <Vulk/ShaderReflection.hpp>
+#include <gtest/gtest.h>
+
+#include <initializer_list>
+#include <vector>
+
+namespace {
+// Opcodes, decorations and storage classes from the SPIR-V specification
+enum : uint32_t
+{
+    OpEntryPoint = 15,
+    OpTypeBool = 20,
+    OpTypeInt = 21,
+    OpTypeFloat = 22,
+    OpTypeVector = 23,
+    OpTypeMatrix = 24,
+    OpTypeImage = 25,
+    OpTypeSampledImage = 27,
+    OpTypeArray = 28,
+    OpTypeRuntimeArray = 29,
+    OpTypeStruct = 30,
+    OpTypePointer = 32,
+    OpConstant = 43,
+    OpSpecConstantTrue = 48,
+    OpSpecConstant = 50,
+    OpVariable = 59,
+    OpDecorate = 71,
+    OpMemberDecorate = 72,
+};
+
+enum : uint32_t
+{
+    SpecId = 1,
+    Block = 2,
+    BufferBlock = 3,
+    ArrayStride = 6,
+    MatrixStride = 7,
+    BuiltIn = 11,
+    Location = 30,
+    Binding = 33,
+    DescriptorSet = 34,
+    Offset = 35,
+};
+
+enum : uint32_t
+{
+    UniformConstant = 0,
+    Input = 1,
+    Uniform = 2,
+    PushConstant = 9,
+};
+
+constexpr uint32_t ExecutionModelVertex = 0;
+constexpr uint32_t ExecutionModelFragment = 4;
+
+class SpirvBuilder
+{
+public:
+    explicit SpirvBuilder(uint32_t executionModel)
+    {
+        // "main", followed by its null terminator
+        op(OpEntryPoint, {executionModel, 100, 0x6e69616d, 0});
+    }
+
+    SpirvBuilder& op(uint32_t opcode, std::initializer_list<uint32_t> operands)
+    {
+        m_code.push_back(static_cast<uint32_t>(operands.size() + 1) << 16u | opcode);
+        m_code.insert(m_code.end(), operands);
+        return *this;
+    }
+
+    [[nodiscard]] const std::vector<uint32_t>& getCode() const noexcept { return m_code; }
+
+private:
+    std::vector<uint32_t> m_code{0x07230203, 0x00010000, 0, 128, 0};
+};
+
+void addCommonTypes(SpirvBuilder& builder)
+{
+    builder.op(OpTypeFloat, {1, 32})
+      .op(OpTypeVector, {2, 1, 2})
+      .op(OpTypeVector, {3, 1, 3})
+      .op(OpTypeVector, {5, 1, 4})
+      .op(OpTypeMatrix, {4, 5, 4})
+      .op(OpTypeInt, {17, 32, 1})
+      .op(OpTypeInt, {20, 32, 0});
+}
+
+/**
+ * layout(set = 0, binding = 0) uniform UBO { mat4 view; mat4 projection; };
+ * layout(set = 0, binding = 1) buffer Transforms { mat4 transforms[]; };
+ * layout(set = 1, binding = 2) uniform sampler2D textures[4];
+ * layout(push_constant) uniform Push { vec4 color; uint index; };
+ * layout(location = 0) in vec2 position;
+ * layout(location = 1) in vec3 color;
+ * layout(location = 2) in mat4 instanceTransform;
+ */
+std::vector<uint32_t> makeVertexShader()
+{
+    SpirvBuilder builder{ExecutionModelVertex};
+    addCommonTypes(builder);
+
+    builder.op(OpDecorate, {6, Block})
+      .op(OpMemberDecorate, {6, 0, Offset, 0})
+      .op(OpMemberDecorate, {6, 0, MatrixStride, 16})
+      .op(OpMemberDecorate, {6, 1, Offset, 64})
+      .op(OpMemberDecorate, {6, 1, MatrixStride, 16})
+      .op(OpDecorate, {8, DescriptorSet, 0})
+      .op(OpDecorate, {8, Binding, 0})
+      .op(OpTypeStruct, {6, 4, 4})
+      .op(OpTypePointer, {7, Uniform, 6})
+      .op(OpVariable, {7, 8, Uniform});
+
+    builder.op(OpDecorate, {9, ArrayStride, 64})
+      .op(OpDecorate, {10, BufferBlock})
+      .op(OpMemberDecorate, {10, 0, Offset, 0})
+      .op(OpDecorate, {12, DescriptorSet, 0})
+      .op(OpDecorate, {12, Binding, 1})
+      .op(OpTypeRuntimeArray, {9, 4})
+      .op(OpTypeStruct, {10, 9})
+      .op(OpTypePointer, {11, Uniform, 10})
+      .op(OpVariable, {11, 12, Uniform});
+
+    builder.op(OpDecorate, {14, Location, 0})
+      .op(OpDecorate, {16, Location, 1})
+      .op(OpDecorate, {19, BuiltIn, 43})
+      .op(OpDecorate, {31, Location, 2})
+      .op(OpTypePointer, {13, Input, 2})
+      .op(OpVariable, {13, 14, Input})
+      .op(OpTypePointer, {15, Input, 3})
+      .op(OpVariable, {15, 16, Input})
+      .op(OpTypePointer, {18, Input, 17})
+      .op(OpVariable, {18, 19, Input})
+      .op(OpTypePointer, {30, Input, 4})
+      .op(OpVariable, {30, 31, Input});
+
+    builder.op(OpDecorate, {21, Block})
+      .op(OpMemberDecorate, {21, 0, Offset, 0})
+      .op(OpMemberDecorate, {21, 1, Offset, 16})
+      .op(OpTypeStruct, {21, 5, 20})
+      .op(OpTypePointer, {22, PushConstant, 21})
+      .op(OpVariable, {22, 23, PushConstant});
+
+    builder.op(OpDecorate, {29, DescriptorSet, 1})
+      .op(OpDecorate, {29, Binding, 2})
+      .op(OpTypeImage, {24, 1, 1, 0, 0, 0, 1, 0})
+      .op(OpTypeSampledImage, {25, 24})
+      .op(OpConstant, {20, 26, 4})
+      .op(OpTypeArray, {27, 25, 26})
+      .op(OpTypePointer, {28, UniformConstant, 27})
+      .op(OpVariable, {28, 29, UniformConstant});
+
+    return builder.getCode();
+}
+
+/**
+ * layout(set = 0, binding = 0) uniform UBO { mat4 view; mat4 projection; };
+ * layout(set = 0, binding = 1) uniform Conflicting { vec4 value; };  // With `conflicting`
+ * layout(push_constant) uniform Push { layout(offset = 16) float intensity; };
+ * layout(location = 0) in vec3 color;
+ */
+std::vector<uint32_t> makeFragmentShader(bool conflicting = false)
+{
+    SpirvBuilder builder{ExecutionModelFragment};
+    addCommonTypes(builder);
+
+    builder.op(OpDecorate, {6, Block})
+      .op(OpMemberDecorate, {6, 0, Offset, 0})
+      .op(OpMemberDecorate, {6, 1, Offset, 64})
+      .op(OpDecorate, {8, DescriptorSet, 0})
+      .op(OpDecorate, {8, Binding, 0})
+      .op(OpTypeStruct, {6, 4, 4})
+      .op(OpTypePointer, {7, Uniform, 6})
+      .op(OpVariable, {7, 8, Uniform});
+
+    builder.op(OpDecorate, {21, Block})
+      .op(OpMemberDecorate, {21, 0, Offset, 16})
+      .op(OpTypeStruct, {21, 1})
+      .op(OpTypePointer, {22, PushConstant, 21})
+      .op(OpVariable, {22, 23, PushConstant});
+
+    // Stage inputs of other stages aren't vertex inputs
+    builder.op(OpDecorate, {16, Location, 0}).op(OpTypePointer, {15, Input, 3}).op(OpVariable, {15, 16, Input});
+
+    if (conflicting)
+    {
+        builder.op(OpDecorate, {10, Block})
+          .op(OpMemberDecorate, {10, 0, Offset, 0})
+          .op(OpDecorate, {12, DescriptorSet, 0})
+          .op(OpDecorate, {12, Binding, 1})
+          .op(OpTypeStruct, {10, 5})
+          .op(OpTypePointer, {11, Uniform, 10})
+          .op(OpVariable, {11, 12, Uniform});
+    }
+
+    return builder.getCode();
+}
+}  // namespace
+
+TEST(ShaderReflectionTests, DescriptorBindings)
+{
+    const std::vector<uint32_t> code = makeVertexShader();
+    const vulk::ShaderReflection reflection{code};
+
+    EXPECT_EQ(reflection.getStages(), vk::ShaderStageFlags{vk::ShaderStageFlagBits::eVertex});
+    EXPECT_EQ(reflection.getSetCount(), 2u);
+
+    const auto& bindings = reflection.getDescriptorBindings();
+    ASSERT_EQ(bindings.size(), 3u);
+
+    EXPECT_EQ(bindings[0].set, 0u);
+    EXPECT_EQ(bindings[0].binding, 0u);
+    EXPECT_EQ(bindings[0].type, vk::DescriptorType::eUniformBuffer);
+    EXPECT_EQ(bindings[0].count, 1u);
+    EXPECT_EQ(bindings[0].stages, vk::ShaderStageFlags{vk::ShaderStageFlagBits::eVertex});
+
+    EXPECT_EQ(bindings[1].set, 0u);
+    EXPECT_EQ(bindings[1].binding, 1u);
+    EXPECT_EQ(bindings[1].type, vk::DescriptorType::eStorageBuffer);
+    EXPECT_EQ(bindings[1].count, 1u);
+
+    EXPECT_EQ(bindings[2].set, 1u);
+    EXPECT_EQ(bindings[2].binding, 2u);
+    EXPECT_EQ(bindings[2].type, vk::DescriptorType::eCombinedImageSampler);
+    EXPECT_EQ(bindings[2].count, 4u);
+
+    const auto poolSizes = reflection.getPoolSizes(1, 3);
+    ASSERT_EQ(poolSizes.size(), 1u);
+    EXPECT_EQ(poolSizes[0].type, vk::DescriptorType::eCombinedImageSampler);
+    EXPECT_EQ(poolSizes[0].descriptorCount, 12u);
+}
+
+TEST(ShaderReflectionTests, PushConstants)
+{
+    const std::vector<uint32_t> code = makeVertexShader();
+    const vulk::ShaderReflection reflection{code};
+
+    ASSERT_TRUE(reflection.getPushConstantRange().has_value());
+    EXPECT_EQ(reflection.getPushConstantRange()->offset, 0u);
+    EXPECT_EQ(reflection.getPushConstantRange()->size, 20u);
+    EXPECT_EQ(reflection.getPushConstantRange()->stageFlags, vk::ShaderStageFlags{vk::ShaderStageFlagBits::eVertex});
+
+    const std::vector<uint32_t> fragmentCode = makeFragmentShader();
+    const vulk::ShaderReflection fragment{fragmentCode};
+
+    ASSERT_TRUE(fragment.getPushConstantRange().has_value());
+    EXPECT_EQ(fragment.getPushConstantRange()->offset, 16u);
+    EXPECT_EQ(fragment.getPushConstantRange()->size, 4u);
+}
+
+TEST(ShaderReflectionTests, VertexInputs)
+{
+    const std::vector<uint32_t> code = makeVertexShader();
+    const vulk::ShaderReflection reflection{code};
+
+    // The matrix takes one location per column, the built-in isn't an input
+    const auto& inputs = reflection.getVertexInputs();
+    ASSERT_EQ(inputs.size(), 6u);
+    EXPECT_EQ(inputs[0].location, 0u);
+    EXPECT_EQ(inputs[0].format, vk::Format::eR32G32Sfloat);
+    EXPECT_EQ(inputs[1].location, 1u);
+    EXPECT_EQ(inputs[1].format, vk::Format::eR32G32B32Sfloat);
+
+    for (uint32_t i = 2; i < 6; ++i)
+    {
+        EXPECT_EQ(inputs[i].location, i);
+        EXPECT_EQ(inputs[i].format, vk::Format::eR32G32B32A32Sfloat);
+    }
+
+    const auto layout = reflection.getVertexInputLayout();
+    EXPECT_EQ(layout.binding.binding, 0u);
+    EXPECT_EQ(layout.binding.stride, 8u + 12u + 64u);
+    ASSERT_EQ(layout.attributes.size(), 6u);
+    EXPECT_EQ(layout.attributes[0].offset, 0u);
+    EXPECT_EQ(layout.attributes[1].offset, 8u);
+    EXPECT_EQ(layout.attributes[2].offset, 20u);
+    EXPECT_EQ(layout.attributes[5].offset, 68u);
+
+    const std::vector<uint32_t> fragmentCode = makeFragmentShader();
+    EXPECT_TRUE(vulk::ShaderReflection{fragmentCode}.getVertexInputs().empty());
+}
+
+TEST(ShaderReflectionTests, Merge)
+{
+    const std::vector<uint32_t> vertexCode = makeVertexShader();
+    const std::vector<uint32_t> fragmentCode = makeFragmentShader();
+
+    vulk::ShaderReflection reflection{vertexCode};
+    reflection.merge(vulk::ShaderReflection{fragmentCode});
+
+    const auto stages = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+    EXPECT_EQ(reflection.getStages(), stages);
+
+    const auto& bindings = reflection.getDescriptorBindings();
+    ASSERT_EQ(bindings.size(), 3u);
+    EXPECT_EQ(bindings[0].stages, stages);
+    EXPECT_EQ(bindings[1].stages, vk::ShaderStageFlags{vk::ShaderStageFlagBits::eVertex});
+
+    ASSERT_TRUE(reflection.getPushConstantRange().has_value());
+    EXPECT_EQ(reflection.getPushConstantRange()->offset, 0u);
+    EXPECT_EQ(reflection.getPushConstantRange()->size, 20u);
+    EXPECT_EQ(reflection.getPushConstantRange()->stageFlags, stages);
+
+    EXPECT_EQ(reflection.getVertexInputs().size(), 6u);
+}
+
+TEST(ShaderReflectionTests, SpecializationConstants)
+{
+    // layout(constant_id = 3) const bool SHADOWS = true;
+    // layout(constant_id = 1) const uint TEXTURE_COUNT = 4;
+    // layout(set = 0, binding = 0) uniform sampler2D textures[TEXTURE_COUNT];
+    SpirvBuilder builder{ExecutionModelFragment};
+    addCommonTypes(builder);
+
+    builder.op(OpTypeBool, {6})
+      .op(OpDecorate, {7, SpecId, 3})
+      .op(OpSpecConstantTrue, {6, 7})
+      .op(OpDecorate, {8, SpecId, 1})
+      .op(OpSpecConstant, {20, 8, 4});
+
+    builder.op(OpDecorate, {29, DescriptorSet, 0})
+      .op(OpDecorate, {29, Binding, 0})
+      .op(OpTypeImage, {24, 1, 1, 0, 0, 0, 1, 0})
+      .op(OpTypeSampledImage, {25, 24})
+      .op(OpTypeArray, {27, 25, 8})
+      .op(OpTypePointer, {28, UniformConstant, 27})
+      .op(OpVariable, {28, 29, UniformConstant});
+
+    const vulk::ShaderReflection reflection{builder.getCode()};
+
+    const auto& constants = reflection.getSpecializationConstants();
+    ASSERT_EQ(constants.size(), 2u);
+    EXPECT_EQ(constants[0].id, 1u);
+    EXPECT_EQ(constants[0].size, 4u);
+    EXPECT_EQ(constants[1].id, 3u);
+    EXPECT_EQ(constants[1].size, 4u);
+
+    // Specialized array lengths are reflected with their default value
+    ASSERT_EQ(reflection.getDescriptorBindings().size(), 1u);
+    EXPECT_EQ(reflection.getDescriptorBindings()[0].count, 4u);
+}
+
+TEST(ShaderReflectionTests, Errors)
+{
+    const std::vector<uint32_t> vertexCode = makeVertexShader();
+    const std::vector<uint32_t> conflictingCode = makeFragmentShader(true);
+
+    vulk::ShaderReflection reflection{vertexCode};
+    EXPECT_THROW(reflection.merge(vulk::ShaderReflection{conflictingCode}), vulk::ShaderReflectionException);
+
+    const std::vector<uint32_t> notSpirv{0xdeadbeef, 0, 0, 0, 0};
+    EXPECT_THROW(vulk::ShaderReflection{notSpirv}, vulk::InvalidFormatException);
+
+    std::vector<uint32_t> truncated = vertexCode;
+    truncated.pop_back();
+    EXPECT_THROW(vulk::ShaderReflection{truncated}, vulk::InvalidFormatException);
+}
@@ -0,0 +1,68 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include <gtest/gtest.h>
+
+#if VULK_ENABLE_SHADER_HOT_RELOAD
+
+    #include <Vulk/ShaderWatcher.hpp>
+
+    #include <atomic>
+    #include <chrono>
+    #include <filesystem>
+    #include <fstream>
+    #include <stdexcept>
+    #include <thread>
+
+TEST(ShaderWatcherTests, ThrowingListenersDontStopTheWatcher)
+{
+    const auto directory = std::filesystem::temp_directory_path() / "vulk-shader-watcher-test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory / "sources");
+    std::filesystem::create_directories(directory / "outputs");
+
+    std::atomic<int> notifications{0};
+
+    {
+        vulk::ShaderWatcher watcher{(directory / "sources").string(), (directory / "outputs").string()};
+
+        watcher.addListener("failing.vert.spv", [&notifications](const std::string&) {
+            ++notifications;
+            throw std::runtime_error{"expected by the test"};
+        });
+        watcher.addListener("working.vert.spv", [&notifications](const std::string&) { ++notifications; });
+
+        // The watcher thread would terminate the process on the first one
+        std::ofstream{directory / "outputs" / "failing.vert.spv"} << "not SPIR-V, listeners don't care";
+        std::this_thread::sleep_for(std::chrono::milliseconds{300});
+        std::ofstream{directory / "outputs" / "working.vert.spv"} << "not SPIR-V either";
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+
+        while (notifications < 2 && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+
+    EXPECT_EQ(notifications, 2);
+
+    std::filesystem::remove_all(directory);
+}
+
+#endif
@@ -0,0 +1,74 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Vulk/SpecializationConstants.hpp>
+#include <gtest/gtest.h>
+
+#include <bit>
+
+TEST(SpecializationConstantsTests, ValuesAreSortedById)
+{
+    vulk::SpecializationConstants constants{};
+    constants.set(3, 1.5f).set(0, true).set(1, -2);
+
+    ASSERT_EQ(constants.size(), 3u);
+    EXPECT_EQ(constants.getIds(), (std::vector<uint32_t>{0, 1, 3}));
+
+    const auto data = constants.getData();
+    EXPECT_EQ(data[0], 1u);
+    EXPECT_EQ(data[1], std::bit_cast<uint32_t>(-2));
+    EXPECT_EQ(data[2], std::bit_cast<uint32_t>(1.5f));
+
+    const auto entries = constants.getMapEntries();
+    ASSERT_EQ(entries.size(), 3u);
+    EXPECT_EQ(entries[2].constantID, 3u);
+    EXPECT_EQ(entries[2].offset, 8u);
+    EXPECT_EQ(entries[2].size, 4u);
+}
+
+TEST(SpecializationConstantsTests, SettingAgainReplacesTheValue)
+{
+    vulk::SpecializationConstants constants{};
+    constants.set(2, 4u).set(2, 8u);
+
+    ASSERT_EQ(constants.size(), 1u);
+    EXPECT_EQ(constants.getData()[0], 8u);
+}
+
+TEST(SpecializationConstantsTests, Hash)
+{
+    vulk::SpecializationConstants lhs{};
+    lhs.set(0, 4u);
+
+    vulk::SpecializationConstants rhs{};
+    rhs.set(0, 4u);
+
+    EXPECT_EQ(lhs, rhs);
+    EXPECT_EQ(lhs.hash(0), rhs.hash(0));
+
+    rhs.set(0, 8u);
+    EXPECT_NE(lhs, rhs);
+    EXPECT_NE(lhs.hash(0), rhs.hash(0));
+
+    // Same value under another id
+    vulk::SpecializationConstants other{};
+    other.set(1, 4u);
+    EXPECT_NE(lhs.hash(0), other.hash(0));
+    EXPECT_NE(vulk::SpecializationConstants{}.hash(0), lhs.hash(0));
+}
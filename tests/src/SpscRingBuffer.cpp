@@ -0,0 +1,81 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Vulk/SpscRingBuffer.hpp>
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+TEST(SpscRingBufferTests, DropsWhatDoesntFit)
+{
+    vulk::SpscRingBuffer<int, 4> buffer{};
+
+    for (int i = 0; i < 4; ++i)
+        EXPECT_TRUE(buffer.tryPush(i));
+
+    EXPECT_FALSE(buffer.tryPush(4));
+    EXPECT_EQ(buffer.size(), 4u);
+
+    std::vector<int> items{};
+    EXPECT_EQ(buffer.consume([&items](int item) { items.push_back(item); }), 4u);
+    EXPECT_EQ(items, (std::vector<int>{0, 1, 2, 3}));
+
+    // Wraps around
+    EXPECT_TRUE(buffer.tryPush(5));
+    EXPECT_TRUE(buffer.tryPush(6));
+
+    items.clear();
+    EXPECT_EQ(buffer.consume([&items](int item) { items.push_back(item); }), 2u);
+    EXPECT_EQ(items, (std::vector<int>{5, 6}));
+    EXPECT_EQ(buffer.size(), 0u);
+}
+
+TEST(SpscRingBufferTests, KeepsOrderAcrossThreads)
+{
+    constexpr int Count = 100000;
+
+    vulk::SpscRingBuffer<int, 64> buffer{};
+
+    std::thread producer{[&buffer] {
+        for (int i = 0; i < Count;)
+        {
+            if (buffer.tryPush(i))
+                ++i;
+            else
+                std::this_thread::yield();
+        }
+    }};
+
+    int expected = 0;
+    bool ordered = true;
+
+    while (expected < Count)
+    {
+        buffer.consume([&](int item) {
+            ordered = ordered && item == expected;
+            ++expected;
+        });
+    }
+
+    producer.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(buffer.size(), 0u);
+}
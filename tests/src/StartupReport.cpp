@@ -0,0 +1,71 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Vulk/StartupReport.hpp>
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+
+TEST(StartupReportTests, RecordsPhasesInStartOrder)
+{
+    vulk::StartupReport report{};
+    const vulk::TimePoint now = vulk::Clock::now();
+
+    report.addPhase("second", now + std::chrono::milliseconds{20}, now + std::chrono::milliseconds{30});
+    report.addPhase("first", now, now + std::chrono::milliseconds{10});
+
+    {
+        const auto phase = report.measure("third");
+    }
+
+    std::thread worker{[&report] { const auto phase = report.measure("worker"); }};
+    worker.join();
+
+    const auto phases = report.getPhases();
+    ASSERT_EQ(phases.size(), 4u);
+
+    EXPECT_EQ(phases[0].name, "first");
+    EXPECT_EQ(phases[3].name, "second");
+    EXPECT_NEAR(phases[3].duration.count(), 0.01f, 1e-6f);
+    EXPECT_FALSE(phases[0].onWorkerThread);
+
+    for (const auto& phase : phases)
+        EXPECT_EQ(phase.onWorkerThread, phase.name == "worker");
+
+    EXPECT_GE(report.getSequentialTotal().count(), 0.02f);
+}
+
+TEST(StartupReportTests, FinishStopsTheTotal)
+{
+    vulk::StartupReport report{};
+    report.finish();
+
+    const vulk::Duration total = report.getTotal();
+    std::this_thread::sleep_for(std::chrono::milliseconds{5});
+
+    EXPECT_EQ(report.getTotal(), total);
+
+    report.addPhase("late", vulk::Clock::now(), vulk::Clock::now());
+    EXPECT_EQ(report.getPhases().size(), 1u);
+
+    std::ostringstream stream{};
+    stream << report;
+    EXPECT_NE(stream.str().find("late"), std::string::npos);
+}
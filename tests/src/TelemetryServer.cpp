@@ -0,0 +1,233 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Vulk/AllocationTracker.hpp>
+#include <Vulk/FrameManager.hpp>
+#include <gtest/gtest.h>
+
+#if VULK_ENABLE_TELEMETRY_SERVER
+
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+
+    #include <array>
+    #include <atomic>
+    #include <chrono>
+    #include <cstring>
+    #include <filesystem>
+    #include <thread>
+
+namespace {
+using Server = vulk::TelemetryServer;
+
+template<typename T>
+bool receive(int fd, T& value)
+{
+    auto* bytes = reinterpret_cast<char*>(&value);
+
+    for (size_t offset = 0; offset < sizeof(T);)
+    {
+        const ssize_t length = recv(fd, bytes + offset, sizeof(T) - offset, 0);
+        if (length <= 0)
+            return false;
+
+        offset += static_cast<size_t>(length);
+    }
+
+    return true;
+}
+
+template<typename T>
+bool receiveMessage(int fd, Server::MessageType type, T& payload)
+{
+    Server::MessageHeader header{};
+    return receive(fd, header) && header.type == type && header.size == sizeof(T) && receive(fd, payload);
+}
+
+int connectClient(const std::string& socketPath)
+{
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+bool subscribe(int fd, uint32_t streams, uint32_t period)
+{
+    const Server::MessageHeader header{Server::MessageType::eSubscribe, sizeof(Server::Subscription)};
+    const Server::Subscription subscription{streams, period};
+
+    return send(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+           send(fd, &subscription, sizeof(subscription), 0) == static_cast<ssize_t>(sizeof(subscription));
+}
+}  // namespace
+
+TEST(TelemetryServerTests, StreamsSubscribedSamples)
+{
+    const std::string socketPath = (std::filesystem::temp_directory_path() / "vulk-telemetry-test.sock").string();
+
+    vulk::FrameManager frameManager{};
+    frameManager.startTelemetryServer(socketPath);
+
+    ASSERT_NE(frameManager.getTelemetryServer(), nullptr);
+
+    const int fd = connectClient(socketPath);
+    ASSERT_GE(fd, 0);
+
+    Server::Hello hello{};
+    ASSERT_TRUE(receiveMessage(fd, Server::MessageType::eHello, hello));
+    EXPECT_EQ(hello.version, Server::s_protocolVersion);
+    EXPECT_EQ(hello.processId, static_cast<uint32_t>(getpid()));
+    EXPECT_TRUE(hello.availableStreams & static_cast<uint32_t>(Server::Stream::eFrame));
+
+    // Nothing is sampled before subscribing
+    for (int i = 0; i < 10; ++i)
+        frameManager.update();
+
+    ASSERT_TRUE(subscribe(fd, static_cast<uint32_t>(Server::Stream::eFrame), 2));
+
+    // Published until the server thread reads the subscription
+    std::atomic<bool> received{false};
+    std::thread publisher{[&frameManager, &received] {
+        for (int i = 0; i < 1000 && !received; ++i)
+        {
+            frameManager.update();
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+    }};
+
+    Server::FrameSample first{};
+    Server::FrameSample second{};
+    EXPECT_TRUE(receiveMessage(fd, Server::MessageType::eFrame, first));
+    EXPECT_TRUE(receiveMessage(fd, Server::MessageType::eFrame, second));
+    received = true;
+
+    EXPECT_GE(first.frame, 10u);
+    EXPECT_EQ(second.frame, first.frame + 2);
+    EXPECT_GT(second.frameCount, 0u);
+
+    close(fd);
+    publisher.join();
+
+    frameManager.stopTelemetryServer();
+    EXPECT_FALSE(std::filesystem::exists(socketPath));
+}
+
+TEST(TelemetryServerTests, StopsWhileClientDoesntRead)
+{
+    const std::string socketPath = (std::filesystem::temp_directory_path() / "vulk-telemetry-stall.sock").string();
+
+    vulk::FrameManager frameManager{};
+    frameManager.startTelemetryServer(socketPath);
+
+    const int fd = connectClient(socketPath);
+    ASSERT_GE(fd, 0);
+    const uint32_t streams =
+      static_cast<uint32_t>(Server::Stream::eFrame) | static_cast<uint32_t>(Server::Stream::eCounters);
+    ASSERT_TRUE(subscribe(fd, streams, 1));
+
+    // Nothing is read: the socket fills up, then the pending samples, then samples are dropped
+    const Server& server = *frameManager.getTelemetryServer();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+
+    while (server.getDroppedSampleCount() == 0 && std::chrono::steady_clock::now() < deadline)
+        frameManager.update();
+
+    EXPECT_GT(server.getDroppedSampleCount(), 0u);
+
+    // Would hang if the server thread were stuck in send()
+    frameManager.stopTelemetryServer();
+    close(fd);
+}
+
+TEST(TelemetryServerTests, PublishingDoesntAllocate)
+{
+    if (!vulk::AllocationTracker::s_enabled)
+        GTEST_SKIP() << "Built without VULK_TRACK_ALLOCATIONS";
+
+    const std::string socketPath = (std::filesystem::temp_directory_path() / "vulk-telemetry-steady.sock").string();
+
+    vulk::FrameManager frameManager{};
+    frameManager.startTelemetryServer(socketPath);
+
+    const int fd = connectClient(socketPath);
+    ASSERT_GE(fd, 0);
+
+    const uint32_t streams = static_cast<uint32_t>(Server::Stream::eFrame) |
+                             static_cast<uint32_t>(Server::Stream::eCounters) |
+                             static_cast<uint32_t>(Server::Stream::eMemory);
+    ASSERT_TRUE(subscribe(fd, streams, 1));
+
+    // Until the server closes the connection
+    std::atomic<size_t> receivedSize{0};
+    std::thread reader{[fd, &receivedSize] {
+        std::array<char, 4096> buffer{};
+
+        for (ssize_t length = 0; (length = recv(fd, buffer.data(), buffer.size(), 0)) > 0;)
+            receivedSize += static_cast<size_t>(length);
+    }};
+
+    // Samples follow the hello once the server read the subscription
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+
+    while (receivedSize <= sizeof(Server::MessageHeader) + sizeof(Server::Hello) &&
+           std::chrono::steady_clock::now() < deadline)
+    {
+        frameManager.update();
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+
+    auto& tracker = vulk::AllocationTracker::getInstance();
+    tracker.enableSteadyStateCheck(10, false);
+
+    const uint64_t violations = tracker.getSteadyStateViolationCount();
+
+    for (int frame = 0; frame < 100; ++frame)
+    {
+        {
+            const vulk::AllocationTracker::SteadyStateScope scope{};
+            frameManager.update();
+        }
+
+        tracker.markFrame();
+    }
+
+    tracker.disableSteadyStateCheck();
+
+    EXPECT_GT(receivedSize, sizeof(Server::MessageHeader) + sizeof(Server::Hello));
+    EXPECT_EQ(tracker.getSteadyStateViolationCount(), violations);
+
+    frameManager.stopTelemetryServer();
+    reader.join();
+    close(fd);
+}
+
+#endif
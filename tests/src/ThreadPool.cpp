@@ -0,0 +1,102 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Vulk/ThreadPool.hpp>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+TEST(ThreadPoolTests, RunsEveryJob)
+{
+    std::atomic<int> sum{0};
+
+    {
+        vulk::ThreadPool pool{4};
+        EXPECT_EQ(pool.getThreadCount(), 4u);
+
+        for (int i = 1; i <= 1000; ++i)
+            pool.submit([&sum, i] { sum += i; });
+
+        pool.waitIdle();
+        EXPECT_EQ(sum, 500500);
+
+        for (int i = 0; i < 100; ++i)
+            pool.submit([&sum] { ++sum; });
+    }
+
+    // The destructor runs what is still queued
+    EXPECT_EQ(sum, 500600);
+}
+
+TEST(ThreadPoolTests, RunsOnWorkerThreads)
+{
+    std::mutex mutex{};
+    std::set<std::thread::id> threadIds{};
+
+    vulk::ThreadPool pool{2};
+
+    for (int i = 0; i < 100; ++i)
+    {
+        pool.submit([&] {
+            const std::scoped_lock lock{mutex};
+            threadIds.insert(std::this_thread::get_id());
+        });
+    }
+
+    pool.waitIdle();
+
+    EXPECT_FALSE(threadIds.empty());
+    EXPECT_LE(threadIds.size(), 2u);
+    EXPECT_FALSE(threadIds.contains(std::this_thread::get_id()));
+}
+
+TEST(ThreadPoolTests, ExceptionsDontStopWorkers)
+{
+    std::atomic<int> count{0};
+
+    vulk::ThreadPool pool{1};
+    pool.submit([] { throw std::runtime_error{"expected by the test"}; });
+    pool.submit([] { throw 42; });
+    pool.submit([&count] { ++count; });
+    pool.waitIdle();
+
+    EXPECT_EQ(count, 1);
+}
+
+TEST(ThreadPoolTests, AsyncForwardsExceptions)
+{
+    std::atomic<int> count{0};
+
+    vulk::ThreadPool pool{2};
+    std::future<void> succeeding = pool.async([&count] { ++count; });
+    std::future<void> failing = pool.async([] { throw std::runtime_error{"expected by the test"}; });
+
+    EXPECT_NO_THROW(succeeding.get());
+    EXPECT_THROW(failing.get(), std::runtime_error);
+    EXPECT_EQ(count, 1);
+}
+
+TEST(ThreadPoolTests, DefaultThreadCount)
+{
+    EXPECT_GE(vulk::ThreadPool::getDefaultThreadCount(), 1u);
+}
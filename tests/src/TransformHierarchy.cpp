@@ -0,0 +1,128 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Vulk/TransformHierarchy.hpp>
+#include <gtest/gtest.h>
+
+using NodeHandle = vulk::TransformHierarchy::NodeHandle;
+
+static glm::mat4 translation(float x, float y, float z)
+{
+    glm::mat4 matrix{1.f};
+    matrix[3] = glm::vec4{x, y, z, 1.f};
+    return matrix;
+}
+
+static float worldX(const vulk::TransformHierarchy& hierarchy, NodeHandle node)
+{
+    return hierarchy.getWorldTransform(node)[3].x;
+}
+
+TEST(TransformHierarchyTests, WorldTransforms)
+{
+    vulk::TransformHierarchy hierarchy{};
+
+    const NodeHandle root = hierarchy.createNode(vulk::TransformHierarchy::INVALID_NODE, translation(1.f, 0.f, 0.f));
+    const NodeHandle child = hierarchy.createNode(root, translation(2.f, 0.f, 0.f));
+    const NodeHandle grandChild = hierarchy.createNode(child, translation(4.f, 0.f, 0.f));
+
+    hierarchy.update();
+
+    EXPECT_FLOAT_EQ(worldX(hierarchy, root), 1.f);
+    EXPECT_FLOAT_EQ(worldX(hierarchy, child), 3.f);
+    EXPECT_FLOAT_EQ(worldX(hierarchy, grandChild), 7.f);
+
+    hierarchy.setLocalTransform(root, translation(10.f, 0.f, 0.f));
+    hierarchy.update();
+
+    EXPECT_FLOAT_EQ(worldX(hierarchy, grandChild), 16.f);
+}
+
+TEST(TransformHierarchyTests, ParentsBeforeChildren)
+{
+    vulk::TransformHierarchy hierarchy{};
+
+    const NodeHandle a = hierarchy.createNode();
+    const NodeHandle b = hierarchy.createNode();
+    const NodeHandle a1 = hierarchy.createNode(a);
+    const NodeHandle b1 = hierarchy.createNode(b);
+    const NodeHandle a2 = hierarchy.createNode(a);
+
+    // a's subtree stays contiguous when inserting in the middle
+    EXPECT_EQ(hierarchy.getIndex(a), 0u);
+    EXPECT_EQ(hierarchy.getIndex(a1), 1u);
+    EXPECT_EQ(hierarchy.getIndex(a2), 2u);
+    EXPECT_EQ(hierarchy.getIndex(b), 3u);
+    EXPECT_EQ(hierarchy.getIndex(b1), 4u);
+
+    hierarchy.destroyNode(a);
+
+    EXPECT_EQ(hierarchy.getNodeCount(), 2u);
+    EXPECT_EQ(hierarchy.getIndex(b), 0u);
+    EXPECT_EQ(hierarchy.getIndex(b1), 1u);
+
+    // Handles are reused
+    const NodeHandle b2 = hierarchy.createNode(b, translation(3.f, 0.f, 0.f));
+    EXPECT_LT(b2, 5u);
+    EXPECT_EQ(hierarchy.getIndex(b2), 2u);
+}
+
+TEST(TransformHierarchyTests, ChangedRanges)
+{
+    vulk::TransformHierarchy hierarchy{};
+
+    std::vector<NodeHandle> roots{};
+
+    for (int i = 0; i < 100; ++i)
+    {
+        roots.push_back(hierarchy.createNode());
+
+        for (int j = 0; j < 9; ++j)
+            hierarchy.createNode(roots.back());
+    }
+
+    auto ranges = hierarchy.update();
+    ASSERT_EQ(ranges.size(), 1u);
+    EXPECT_EQ(ranges[0].first, 0u);
+    EXPECT_EQ(ranges[0].count, 1000u);
+
+    // Static scene: nothing to do
+    EXPECT_TRUE(hierarchy.update().empty());
+
+    // Only the dirty subtree, nested dirty nodes are part of it
+    hierarchy.setLocalTransform(roots[10], translation(1.f, 0.f, 0.f));
+    hierarchy.setLocalTransform(hierarchy.createNode(roots[10]), translation(1.f, 0.f, 0.f));
+    hierarchy.update();
+    hierarchy.setLocalTransform(roots[10], translation(2.f, 0.f, 0.f));
+    hierarchy.setLocalTransform(roots[50], translation(2.f, 0.f, 0.f));
+
+    ranges = hierarchy.update();
+    ASSERT_EQ(ranges.size(), 2u);
+    EXPECT_EQ(ranges[0].first, 100u);
+    EXPECT_EQ(ranges[0].count, 11u);
+    EXPECT_EQ(ranges[1].first, 501u);
+    EXPECT_EQ(ranges[1].count, 10u);
+
+    // Appending only uploads the new node
+    hierarchy.createNode();
+    ranges = hierarchy.update();
+    ASSERT_EQ(ranges.size(), 1u);
+    EXPECT_EQ(ranges[0].first, 1001u);
+    EXPECT_EQ(ranges[0].count, 1u);
+}
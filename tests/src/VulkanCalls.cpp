@@ -0,0 +1,81 @@
+/*
+* Copyright (c) 2021-2021 [fill name later]
+*
+* This software is provided "as-is", without any express or implied warranty. In no event
+*     will the authors be held liable for any damages arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose, including commercial
+*     applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+* 2. Altered source versions must be plainly marked as such, and must not be misrepresented
+* as being the original software.
+*
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Vulk/VulkanCalls.hpp>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+TEST(VulkanCallsTests, ScopesAreFoldedPerEntryPoint)
+{
+    static_cast<void>(vulk::accounting::fold());
+
+    std::vector<std::thread> threads{};
+
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([] {
+            for (int j = 0; j < 100; ++j)
+                const vulk::VulkanCallScope scope{vulk::VulkanCall::eUpdateDescriptorSets};
+        });
+    }
+
+    {
+        const vulk::VulkanCallScope scope{vulk::VulkanCall::eQueueSubmit};
+        std::this_thread::sleep_for(std::chrono::milliseconds{2});
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    const vulk::VulkanCallStats stats = vulk::accounting::fold();
+
+    EXPECT_EQ(stats[vulk::VulkanCall::eUpdateDescriptorSets].count, 400u);
+    EXPECT_EQ(stats[vulk::VulkanCall::eQueueSubmit].count, 1u);
+    EXPECT_GE(stats[vulk::VulkanCall::eQueueSubmit].getTime().count(), 0.002f);
+    EXPECT_EQ(stats[vulk::VulkanCall::eCreateBuffer].count, 0u);
+    EXPECT_EQ(stats.getTotal().count, 401u);
+
+    // Folding resets the accumulators
+    EXPECT_EQ(vulk::accounting::fold(), vulk::VulkanCallStats{});
+}
+
+TEST(VulkanCallsTests, AddAndPrint)
+{
+    vulk::VulkanCallStats stats{};
+    stats[vulk::VulkanCall::eCreateBuffer] = {2, 1000};
+
+    vulk::VulkanCallStats other{};
+    other[vulk::VulkanCall::eCreateBuffer] = {1, 500};
+    other[vulk::VulkanCall::eAllocateMemory] = {1, 4000};
+
+    stats += other;
+
+    EXPECT_EQ(stats[vulk::VulkanCall::eCreateBuffer], (vulk::VulkanCallStats::Entry{3, 1500}));
+    EXPECT_STREQ(vulk::VulkanCallStats::getName(vulk::VulkanCall::eQueuePresent), "vkQueuePresentKHR");
+
+    std::ostringstream os{};
+    os << stats;
+
+    // Most expensive first, nothing about the entry points never called
+    EXPECT_EQ(os.str(), "vkAllocateMemory: 1 in 4 us, vkCreateBuffer: 3 in 1.5 us");
+}